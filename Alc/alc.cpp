@@ -55,6 +55,7 @@
 #include "ringbuffer.h"
 #include "filters/splitter.h"
 #include "bs2b.h"
+#include "mixerpool.h"
 
 #include "fpu_modes.h"
 #include "cpu_caps.h"
@@ -181,7 +182,7 @@ struct BackendInfo CaptureBackend;
  * Functions, enums, and errors
  ************************************************/
 #define DECL(x) { #x, (ALCvoid*)(x) }
-constexpr struct {
+const struct {
     const ALCchar *funcName;
     ALCvoid *address;
 } alcFunctions[] = {
@@ -360,7 +361,7 @@ constexpr struct {
 #undef DECL
 
 #define DECL(x) { #x, (x) }
-constexpr struct {
+const struct {
     const ALCchar *enumName;
     ALCenum value;
 } alcEnumerations[] = {
@@ -619,6 +620,7 @@ constexpr struct {
     DECL(AL_EFFECT_EQUALIZER),
     DECL(AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT),
     DECL(AL_EFFECT_DEDICATED_DIALOGUE),
+    DECL(AL_EFFECT_CONVOLUTION_REVERB_SOFT),
 
     DECL(AL_EFFECTSLOT_EFFECT),
     DECL(AL_EFFECTSLOT_GAIN),
@@ -728,6 +730,8 @@ constexpr struct {
     DECL(AL_SOURCE_SPATIALIZE_SOFT),
     DECL(AL_AUTO_SOFT),
 
+    DECL(AL_SOURCE_PRIORITY_SOFT),
+
     DECL(AL_MAP_READ_BIT_SOFT),
     DECL(AL_MAP_WRITE_BIT_SOFT),
     DECL(AL_MAP_PERSISTENT_BIT_SOFT),
@@ -784,6 +788,7 @@ constexpr ALchar alExtList[] =
     "AL_EXT_STEREO_ANGLES "
     "AL_LOKI_quadriphonic "
     "AL_SOFT_block_alignment "
+    "AL_SOFTX_convolution_reverb "
     "AL_SOFT_deferred_updates "
     "AL_SOFT_direct_channels "
     "AL_SOFTX_events "
@@ -794,6 +799,7 @@ constexpr ALchar alExtList[] =
     "AL_SOFT_MSADPCM "
     "AL_SOFT_source_latency "
     "AL_SOFT_source_length "
+    "AL_SOFTX_source_priority "
     "AL_SOFT_source_resampler "
     "AL_SOFT_source_spatialize";
 
@@ -965,6 +971,12 @@ static void alc_initconfig(void)
 #elif defined(HAVE_SSE)
     capfilter |= CPU_CAP_SSE;
 #endif
+#ifdef HAVE_AVX2
+    capfilter |= CPU_CAP_AVX2;
+#endif
+#ifdef HAVE_AVX512
+    capfilter |= CPU_CAP_AVX512;
+#endif
 #ifdef HAVE_NEON
     capfilter |= CPU_CAP_NEON;
 #endif
@@ -995,6 +1007,10 @@ static void alc_initconfig(void)
                     capfilter &= ~CPU_CAP_SSE3;
                 else if(len == 6 && strncasecmp(str, "sse4.1", len) == 0)
                     capfilter &= ~CPU_CAP_SSE4_1;
+                else if(len == 4 && strncasecmp(str, "avx2", len) == 0)
+                    capfilter &= ~CPU_CAP_AVX2;
+                else if(len == 6 && strncasecmp(str, "avx512", len) == 0)
+                    capfilter &= ~CPU_CAP_AVX512;
                 else if(len == 4 && strncasecmp(str, "neon", len) == 0)
                     capfilter &= ~CPU_CAP_NEON;
                 else
@@ -1579,184 +1595,527 @@ static inline void UpdateClockBase(ALCdevice *device)
     IncrementRef(&device->MixCount);
 }
 
-/* UpdateDeviceParams
+static void StartHrtfLoader(ALCdevice *device, ALCsizei hrtf_id, HrtfRequestMode hrtf_appreq,
+    HrtfRequestMode hrtf_userreq);
+
+/* InitDeviceRenderer
  *
- * Updates device parameters according to the attribute list (caller is
- * responsible for holding the list lock).
+ * Sets up the rendering method and mixing buffers for the device's output
+ * format, and updates the device's contexts to match. The device must not be
+ * mixing, either by being stopped or having its backend locked. If ctxlocked
+ * is true, the caller already holds each context's property, source, and
+ * effect slot locks.
  */
-static ALCenum UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
+static ALCboolean InitDeviceRenderer(ALCdevice *device, ALCsizei hrtf_id,
+    HrtfRequestMode hrtf_appreq, HrtfRequestMode hrtf_userreq, ALCenum gainLimiter,
+    ALsizei old_sends, ALsizei new_sends, bool ctxlocked)
 {
-    enum HrtfRequestMode hrtf_userreq = Hrtf_Default;
-    enum HrtfRequestMode hrtf_appreq = Hrtf_Default;
-    ALCenum gainLimiter = device->LimiterState;
-    const ALsizei old_sends = device->NumAuxSends;
-    ALsizei new_sends = device->NumAuxSends;
-    enum DevFmtChannels oldChans;
-    enum DevFmtType oldType;
     ALboolean update_failed;
-    ALCsizei hrtf_id = -1;
     ALCcontext *context;
-    ALCuint oldFreq;
     int val;
 
-    // Check for attributes
-    if(device->Type == Loopback)
-    {
-        ALCsizei numMono, numStereo, numSends;
-        ALCenum alayout = AL_NONE;
-        ALCenum ascale = AL_NONE;
-        ALCenum schans = AL_NONE;
-        ALCenum stype = AL_NONE;
-        ALCsizei attrIdx = 0;
-        ALCsizei aorder = 0;
-        ALCuint freq = 0;
+    device->Uhj_Encoder = nullptr;
+    device->Bs2b = nullptr;
 
-        if(!attrList)
-        {
-            WARN("Missing attributes for loopback device\n");
-            return ALC_INVALID_VALUE;
-        }
+    device->ChannelDelay.clear();
+    device->ChannelDelay.shrink_to_fit();
 
-        numMono = device->NumMonoSources;
-        numStereo = device->NumStereoSources;
-        numSends = old_sends;
+    device->Dry.Buffer = nullptr;
+    device->Dry.NumChannels = 0;
+    device->FOAOut.Buffer = nullptr;
+    device->FOAOut.NumChannels = 0;
+    device->RealOut.Buffer = nullptr;
+    device->RealOut.NumChannels = 0;
+    device->MixBuffer.clear();
+    device->MixBuffer.shrink_to_fit();
 
-#define TRACE_ATTR(a, v) TRACE("Loopback %s = %d\n", #a, v)
-        while(attrList[attrIdx])
-        {
-            switch(attrList[attrIdx])
-            {
-                case ALC_FORMAT_CHANNELS_SOFT:
-                    schans = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_FORMAT_CHANNELS_SOFT, schans);
-                    if(!IsValidALCChannels(schans))
-                        return ALC_INVALID_VALUE;
-                    break;
+    device->FixedLatency = std::chrono::nanoseconds::zero();
 
-                case ALC_FORMAT_TYPE_SOFT:
-                    stype = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_FORMAT_TYPE_SOFT, stype);
-                    if(!IsValidALCType(stype))
-                        return ALC_INVALID_VALUE;
-                    break;
+    aluInitRenderer(device, hrtf_id, hrtf_appreq, hrtf_userreq);
+    if(device->HrtfLoadRequest)
+    {
+        device->HrtfLoadRequest = false;
+        StartHrtfLoader(device, hrtf_id, hrtf_appreq, hrtf_userreq);
+    }
+    TRACE("Channel config, Dry: %d, FOA: %d, Real: %d\n", device->Dry.NumChannels,
+          device->FOAOut.NumChannels, device->RealOut.NumChannels);
 
-                case ALC_FREQUENCY:
-                    freq = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_FREQUENCY, freq);
-                    if(freq < MIN_OUTPUT_RATE)
-                        return ALC_INVALID_VALUE;
-                    break;
+    /* Allocate extra channels for any post-filter output. */
+    ALsizei num_chans{device->Dry.NumChannels + device->FOAOut.NumChannels +
+                      device->RealOut.NumChannels};
+    /* And for the shared HRTF buses' input. */
+    if(device->mHrtfBuses)
+        num_chans += MAX_HRTF_BUSES;
 
-                case ALC_AMBISONIC_LAYOUT_SOFT:
-                    alayout = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_AMBISONIC_LAYOUT_SOFT, alayout);
-                    if(!IsValidAmbiLayout(alayout))
-                        return ALC_INVALID_VALUE;
-                    break;
+    TRACE("Allocating %d channels, " SZFMT " bytes\n", num_chans,
+          num_chans*sizeof(device->MixBuffer[0]));
+    device->MixBuffer.resize(num_chans);
 
-                case ALC_AMBISONIC_SCALING_SOFT:
-                    ascale = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_AMBISONIC_SCALING_SOFT, ascale);
-                    if(!IsValidAmbiScaling(ascale))
-                        return ALC_INVALID_VALUE;
-                    break;
+    device->Dry.Buffer = &reinterpret_cast<ALfloat(&)[BUFFERSIZE]>(device->MixBuffer[0]);
+    if(device->RealOut.NumChannels != 0)
+        device->RealOut.Buffer = device->Dry.Buffer + device->Dry.NumChannels +
+                                 device->FOAOut.NumChannels;
+    else
+    {
+        device->RealOut.Buffer = device->Dry.Buffer;
+        device->RealOut.NumChannels = device->Dry.NumChannels;
+    }
 
-                case ALC_AMBISONIC_ORDER_SOFT:
-                    aorder = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_AMBISONIC_ORDER_SOFT, aorder);
-                    if(aorder < 1 || aorder > MAX_AMBI_ORDER)
-                        return ALC_INVALID_VALUE;
-                    break;
+    if(device->FOAOut.NumChannels != 0)
+        device->FOAOut.Buffer = device->Dry.Buffer + device->Dry.NumChannels;
+    else
+    {
+        device->FOAOut.Buffer = device->Dry.Buffer;
+        device->FOAOut.NumChannels = device->Dry.NumChannels;
+    }
 
-                case ALC_MONO_SOURCES:
-                    numMono = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_MONO_SOURCES, numMono);
-                    numMono = maxi(numMono, 0);
-                    break;
+    if(device->mHrtfBuses)
+        device->mHrtfBuses->Buffer = device->Dry.Buffer + num_chans - MAX_HRTF_BUSES;
 
-                case ALC_STEREO_SOURCES:
-                    numStereo = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_STEREO_SOURCES, numStereo);
-                    numStereo = maxi(numStereo, 0);
-                    break;
+    if(!device->MixScratch)
+        device->MixScratch.reset(new MixerScratch{});
+    device->MixScratch->resize(device->UpdateSize);
 
-                case ALC_MAX_AUXILIARY_SENDS:
-                    numSends = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_MAX_AUXILIARY_SENDS, numSends);
-                    numSends = clampi(numSends, 0, MAX_SENDS);
-                    break;
+    ALint mixthreads{1};
+    ConfigValueInt(device->DeviceName.c_str(), nullptr, "mixer-threads", &mixthreads);
+    if(mixthreads < 1)
+        mixthreads = static_cast<ALint>(std::thread::hardware_concurrency());
+    mixthreads = clampi(mixthreads, 1, MAX_MIXER_THREADS);
+    if(mixthreads > 1)
+    {
+        if(!device->MixThreads || device->MixThreads->size() != static_cast<size_t>(mixthreads))
+        {
+            device->MixThreads = nullptr;
+            device->MixThreads.reset(new MixerPool{static_cast<size_t>(mixthreads)});
+        }
+        device->MixThreadStates.resize(device->MixThreads->size() - 1);
+        for(auto &thrd : device->MixThreadStates)
+        {
+            if(!thrd) thrd.reset(new MixThreadState{});
+            thrd->Scratch.resize(device->UpdateSize);
+            thrd->MixBuffer.resize(num_chans);
+            thrd->MixBuffer.shrink_to_fit();
+            thrd->Events.reserve(64);
+        }
+        device->ThreadedEffects = !!GetConfigValueBool(device->DeviceName.c_str(), nullptr,
+            "threaded-effects", 0);
+        TRACE("Mixing voices%s with " SZFMT " threads\n",
+            device->ThreadedEffects ? " and effects" : "", device->MixThreads->size());
+    }
+    else
+    {
+        device->MixThreads = nullptr;
+        device->MixThreadStates.clear();
+        device->ThreadedEffects = false;
+    }
 
-                case ALC_HRTF_SOFT:
-                    TRACE_ATTR(ALC_HRTF_SOFT, attrList[attrIdx + 1]);
-                    if(attrList[attrIdx + 1] == ALC_FALSE)
-                        hrtf_appreq = Hrtf_Disable;
-                    else if(attrList[attrIdx + 1] == ALC_TRUE)
-                        hrtf_appreq = Hrtf_Enable;
-                    else
-                        hrtf_appreq = Hrtf_Default;
-                    break;
+    device->NumAuxSends = new_sends;
+    TRACE("Max sources: %d (%d + %d), effect slots: %d, sends: %d\n",
+          device->SourcesMax, device->NumMonoSources, device->NumStereoSources,
+          device->AuxiliaryEffectSlotMax, device->NumAuxSends);
 
-                case ALC_HRTF_ID_SOFT:
-                    hrtf_id = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_HRTF_ID_SOFT, hrtf_id);
+    device->DitherDepth = 0.0f;
+    if(GetConfigValueBool(device->DeviceName.c_str(), nullptr, "dither", 1))
+    {
+        ALint depth = 0;
+        ConfigValueInt(device->DeviceName.c_str(), nullptr, "dither-depth", &depth);
+        if(depth <= 0)
+        {
+            switch(device->FmtType)
+            {
+                case DevFmtByte:
+                case DevFmtUByte:
+                    depth = 8;
                     break;
-
-                case ALC_OUTPUT_LIMITER_SOFT:
-                    gainLimiter = attrList[attrIdx + 1];
-                    TRACE_ATTR(ALC_OUTPUT_LIMITER_SOFT, gainLimiter);
+                case DevFmtShort:
+                case DevFmtUShort:
+                    depth = 16;
                     break;
-
-                default:
-                    TRACE("Loopback 0x%04X = %d (0x%x)\n", attrList[attrIdx],
-                          attrList[attrIdx + 1], attrList[attrIdx + 1]);
+                case DevFmtInt:
+                case DevFmtUInt:
+                case DevFmtFloat:
                     break;
             }
-
-            attrIdx += 2;
         }
-#undef TRACE_ATTR
 
-        if(!schans || !stype || !freq)
-        {
-            WARN("Missing format for loopback device\n");
-            return ALC_INVALID_VALUE;
-        }
-        if(schans == ALC_BFORMAT3D_SOFT && (!alayout || !ascale || !aorder))
+        if(depth > 0)
         {
-            WARN("Missing ambisonic info for loopback device\n");
-            return ALC_INVALID_VALUE;
+            depth = clampi(depth, 2, 24);
+            device->DitherDepth = std::pow(2.0f, (ALfloat)(depth-1));
         }
+    }
+    if(!(device->DitherDepth > 0.0f))
+        TRACE("Dithering disabled\n");
+    else
+        TRACE("Dithering enabled (%d-bit, %g)\n", float2int(std::log2(device->DitherDepth)+0.5f)+1,
+              device->DitherDepth);
 
-        if((device->Flags&DEVICE_RUNNING))
-            V0(device->Backend,stop)();
-        device->Flags &= ~DEVICE_RUNNING;
-
-        UpdateClockBase(device);
+    device->LimiterState = gainLimiter;
+    if(ConfigValueBool(device->DeviceName.c_str(), nullptr, "output-limiter", &val))
+        gainLimiter = val ? ALC_TRUE : ALC_FALSE;
 
-        device->Frequency = freq;
-        device->FmtChans = static_cast<enum DevFmtChannels>(schans);
-        device->FmtType = static_cast<enum DevFmtType>(stype);
-        if(schans == ALC_BFORMAT3D_SOFT)
+    /* Valid values for gainLimiter are ALC_DONT_CARE_SOFT, ALC_TRUE, and
+     * ALC_FALSE. For ALC_DONT_CARE_SOFT, use the limiter for integer-based
+     * output (where samples must be clamped), and don't for floating-point
+     * (which can take unclamped samples).
+     */
+    if(gainLimiter == ALC_DONT_CARE_SOFT)
+    {
+        switch(device->FmtType)
         {
-            device->mAmbiOrder = aorder;
-            device->mAmbiLayout = static_cast<AmbiLayout>(alayout);
-            device->mAmbiScale = static_cast<AmbiNorm>(ascale);
+            case DevFmtByte:
+            case DevFmtUByte:
+            case DevFmtShort:
+            case DevFmtUShort:
+            case DevFmtInt:
+            case DevFmtUInt:
+                gainLimiter = ALC_TRUE;
+                break;
+            case DevFmtFloat:
+                gainLimiter = ALC_FALSE;
+                break;
         }
-
-        if(numMono > INT_MAX-numStereo)
-            numMono = INT_MAX-numStereo;
-        numMono += numStereo;
-        if(ConfigValueInt(nullptr, nullptr, "sources", &numMono))
+    }
+    if(gainLimiter != ALC_FALSE)
+    {
+        ALfloat thrshld = 1.0f;
+        switch(device->FmtType)
         {
-            if(numMono <= 0)
-                numMono = 256;
-        }
-        else
-            numMono = maxi(numMono, 256);
-        numStereo = mini(numStereo, numMono);
-        numMono -= numStereo;
-        device->SourcesMax = numMono + numStereo;
-
+            case DevFmtByte:
+            case DevFmtUByte:
+                thrshld = 127.0f / 128.0f;
+                break;
+            case DevFmtShort:
+            case DevFmtUShort:
+                thrshld = 32767.0f / 32768.0f;
+                break;
+            case DevFmtInt:
+            case DevFmtUInt:
+            case DevFmtFloat:
+                break;
+        }
+        if(device->DitherDepth > 0.0f)
+            thrshld -= 1.0f / device->DitherDepth;
+
+        device->Limiter.reset(CreateDeviceLimiter(device, std::log10(thrshld) * 20.0f));
+        /* Convert the lookahead from samples to nanosamples to nanoseconds. */
+        device->FixedLatency += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::seconds(GetCompressorLookAhead(device->Limiter.get()))
+        ) / device->Frequency;
+    }
+    else
+        device->Limiter = nullptr;
+    TRACE("Output limiter %s\n", device->Limiter ? "enabled" : "disabled");
+
+    aluSelectPostProcess(device);
+
+    TRACE("Fixed device latency: %ldns\n", (long)device->FixedLatency.count());
+
+    /* Need to delay returning failure until replacement Send arrays have been
+     * allocated with the appropriate size.
+     */
+    update_failed = AL_FALSE;
+    FPUCtl mixer_mode{};
+    context = device->ContextList.load();
+    while(context)
+    {
+        if(context->DefaultSlot)
+        {
+            ALeffectslot *slot = context->DefaultSlot.get();
+            EffectState *state = slot->Effect.State;
+
+            state->mOutBuffer = device->Dry.Buffer;
+            state->mOutChannels = device->Dry.NumChannels;
+            if(state->deviceUpdate(device) == AL_FALSE)
+                update_failed = AL_TRUE;
+            else
+                UpdateEffectSlotProps(slot, context);
+        }
+
+        std::unique_lock<std::mutex> proplock{context->PropLock, std::defer_lock};
+        std::unique_lock<std::mutex> slotlock{context->EffectSlotLock, std::defer_lock};
+        if(!ctxlocked)
+        {
+            proplock.lock();
+            slotlock.lock();
+        }
+        for(auto &slot : context->EffectSlotList)
+        {
+            EffectState *state = slot->Effect.State;
+
+            state->mOutBuffer = device->Dry.Buffer;
+            state->mOutChannels = device->Dry.NumChannels;
+            if(state->deviceUpdate(device) == AL_FALSE)
+                update_failed = AL_TRUE;
+            else
+                UpdateEffectSlotProps(slot.get(), context);
+        }
+        if(slotlock) slotlock.unlock();
+
+        std::unique_lock<std::mutex> srclock{context->SourceLock, std::defer_lock};
+        if(!ctxlocked) srclock.lock();
+        for(auto &sublist : context->SourceList)
+        {
+            uint64_t usemask = ~sublist.FreeMask;
+            while(usemask)
+            {
+                ALsizei idx = CTZ64(usemask);
+                ALsource *source = sublist.Sources + idx;
+
+                usemask &= ~(U64(1) << idx);
+
+                if(old_sends != device->NumAuxSends)
+                {
+                    ALsizei s;
+                    for(s = device->NumAuxSends;s < old_sends;s++)
+                    {
+                        if(source->Send[s].Slot)
+                            DecrementRef(&source->Send[s].Slot->ref);
+                        source->Send[s].Slot = nullptr;
+                    }
+                    source->Send.resize(device->NumAuxSends);
+                    source->Send.shrink_to_fit();
+                    for(s = old_sends;s < device->NumAuxSends;s++)
+                    {
+                        source->Send[s].Slot = nullptr;
+                        source->Send[s].Gain = 1.0f;
+                        source->Send[s].GainHF = 1.0f;
+                        source->Send[s].HFReference = LOWPASSFREQREF;
+                        source->Send[s].GainLF = 1.0f;
+                        source->Send[s].LFReference = HIGHPASSFREQREF;
+                    }
+                }
+
+                source->PropsClean.clear(std::memory_order_release);
+            }
+        }
+
+        /* Clear any pre-existing voice property structs, in case the number of
+         * auxiliary sends is changing. Active sources will have updates
+         * respecified in UpdateAllSourceProps.
+         */
+        ALvoiceProps *vprops{context->FreeVoiceProps.exchange(nullptr, std::memory_order_acq_rel)};
+        while(vprops)
+        {
+            ALvoiceProps *next = vprops->next.load(std::memory_order_relaxed);
+            delete vprops;
+            vprops = next;
+        }
+
+        AllocateVoices(context, context->MaxVoices, old_sends);
+        auto voices_end = context->Voices + context->VoiceCount.load(std::memory_order_relaxed);
+        std::for_each(context->Voices, voices_end,
+            [device](ALvoice *voice) -> void
+            {
+                delete voice->Update.exchange(nullptr, std::memory_order_acq_rel);
+
+                if(voice->State->SourceID.load(std::memory_order_acquire) == 0u)
+                    return;
+
+                InitVoiceHrtfTail(voice, device);
+
+                if(device->AvgSpeakerDist > 0.0f)
+                {
+                    /* Reinitialize the NFC filters for new parameters. */
+                    ALfloat w1 = SPEEDOFSOUNDMETRESPERSEC /
+                                 (device->AvgSpeakerDist * device->Frequency);
+                    std::for_each(voice->Direct.Params, voice->Direct.Params+voice->NumChannels,
+                        [w1](DirectParams &params) noexcept -> void
+                        { params.NFCtrlFilter.init(0.0f, w1); }
+                    );
+                }
+            }
+        );
+        if(srclock) srclock.unlock();
+
+        context->PropsClean.test_and_set(std::memory_order_release);
+        UpdateContextProps(context);
+        context->Listener.PropsClean.test_and_set(std::memory_order_release);
+        UpdateListenerProps(context);
+        UpdateAllSourceProps(context);
+
+        context = context->next.load(std::memory_order_relaxed);
+    }
+    mixer_mode.leave();
+
+    return update_failed ? ALC_FALSE : ALC_TRUE;
+}
+
+/* UpdateDeviceParams
+ *
+ * Updates device parameters according to the attribute list (caller is
+ * responsible for holding the list lock).
+ */
+static ALCenum UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
+{
+    enum HrtfRequestMode hrtf_userreq = Hrtf_Default;
+    enum HrtfRequestMode hrtf_appreq = Hrtf_Default;
+    ALCenum gainLimiter = device->LimiterState;
+    const ALsizei old_sends = device->NumAuxSends;
+    ALsizei new_sends = device->NumAuxSends;
+    enum DevFmtChannels oldChans;
+    enum DevFmtType oldType;
+    ALCsizei hrtf_id = -1;
+    ALCuint oldFreq;
+
+    // Check for attributes
+    if(device->Type == Loopback)
+    {
+        ALCsizei numMono, numStereo, numSends;
+        ALCenum alayout = AL_NONE;
+        ALCenum ascale = AL_NONE;
+        ALCenum schans = AL_NONE;
+        ALCenum stype = AL_NONE;
+        ALCsizei attrIdx = 0;
+        ALCsizei aorder = 0;
+        ALCuint freq = 0;
+
+        if(!attrList)
+        {
+            WARN("Missing attributes for loopback device\n");
+            return ALC_INVALID_VALUE;
+        }
+
+        numMono = device->NumMonoSources;
+        numStereo = device->NumStereoSources;
+        numSends = old_sends;
+
+#define TRACE_ATTR(a, v) TRACE("Loopback %s = %d\n", #a, v)
+        while(attrList[attrIdx])
+        {
+            switch(attrList[attrIdx])
+            {
+                case ALC_FORMAT_CHANNELS_SOFT:
+                    schans = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_FORMAT_CHANNELS_SOFT, schans);
+                    if(!IsValidALCChannels(schans))
+                        return ALC_INVALID_VALUE;
+                    break;
+
+                case ALC_FORMAT_TYPE_SOFT:
+                    stype = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_FORMAT_TYPE_SOFT, stype);
+                    if(!IsValidALCType(stype))
+                        return ALC_INVALID_VALUE;
+                    break;
+
+                case ALC_FREQUENCY:
+                    freq = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_FREQUENCY, freq);
+                    if(freq < MIN_OUTPUT_RATE)
+                        return ALC_INVALID_VALUE;
+                    break;
+
+                case ALC_AMBISONIC_LAYOUT_SOFT:
+                    alayout = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_AMBISONIC_LAYOUT_SOFT, alayout);
+                    if(!IsValidAmbiLayout(alayout))
+                        return ALC_INVALID_VALUE;
+                    break;
+
+                case ALC_AMBISONIC_SCALING_SOFT:
+                    ascale = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_AMBISONIC_SCALING_SOFT, ascale);
+                    if(!IsValidAmbiScaling(ascale))
+                        return ALC_INVALID_VALUE;
+                    break;
+
+                case ALC_AMBISONIC_ORDER_SOFT:
+                    aorder = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_AMBISONIC_ORDER_SOFT, aorder);
+                    if(aorder < 1 || aorder > MAX_AMBI_ORDER)
+                        return ALC_INVALID_VALUE;
+                    break;
+
+                case ALC_MONO_SOURCES:
+                    numMono = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_MONO_SOURCES, numMono);
+                    numMono = maxi(numMono, 0);
+                    break;
+
+                case ALC_STEREO_SOURCES:
+                    numStereo = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_STEREO_SOURCES, numStereo);
+                    numStereo = maxi(numStereo, 0);
+                    break;
+
+                case ALC_MAX_AUXILIARY_SENDS:
+                    numSends = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_MAX_AUXILIARY_SENDS, numSends);
+                    numSends = clampi(numSends, 0, MAX_SENDS);
+                    break;
+
+                case ALC_HRTF_SOFT:
+                    TRACE_ATTR(ALC_HRTF_SOFT, attrList[attrIdx + 1]);
+                    if(attrList[attrIdx + 1] == ALC_FALSE)
+                        hrtf_appreq = Hrtf_Disable;
+                    else if(attrList[attrIdx + 1] == ALC_TRUE)
+                        hrtf_appreq = Hrtf_Enable;
+                    else
+                        hrtf_appreq = Hrtf_Default;
+                    break;
+
+                case ALC_HRTF_ID_SOFT:
+                    hrtf_id = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_HRTF_ID_SOFT, hrtf_id);
+                    break;
+
+                case ALC_OUTPUT_LIMITER_SOFT:
+                    gainLimiter = attrList[attrIdx + 1];
+                    TRACE_ATTR(ALC_OUTPUT_LIMITER_SOFT, gainLimiter);
+                    break;
+
+                default:
+                    TRACE("Loopback 0x%04X = %d (0x%x)\n", attrList[attrIdx],
+                          attrList[attrIdx + 1], attrList[attrIdx + 1]);
+                    break;
+            }
+
+            attrIdx += 2;
+        }
+#undef TRACE_ATTR
+
+        if(!schans || !stype || !freq)
+        {
+            WARN("Missing format for loopback device\n");
+            return ALC_INVALID_VALUE;
+        }
+        if(schans == ALC_BFORMAT3D_SOFT && (!alayout || !ascale || !aorder))
+        {
+            WARN("Missing ambisonic info for loopback device\n");
+            return ALC_INVALID_VALUE;
+        }
+
+        if((device->Flags&DEVICE_RUNNING))
+            V0(device->Backend,stop)();
+        device->Flags &= ~DEVICE_RUNNING;
+
+        UpdateClockBase(device);
+
+        device->Frequency = freq;
+        device->FmtChans = static_cast<enum DevFmtChannels>(schans);
+        device->FmtType = static_cast<enum DevFmtType>(stype);
+        if(schans == ALC_BFORMAT3D_SOFT)
+        {
+            device->mAmbiOrder = aorder;
+            device->mAmbiLayout = static_cast<AmbiLayout>(alayout);
+            device->mAmbiScale = static_cast<AmbiNorm>(ascale);
+        }
+
+        if(numMono > INT_MAX-numStereo)
+            numMono = INT_MAX-numStereo;
+        numMono += numStereo;
+        if(ConfigValueInt(nullptr, nullptr, "sources", &numMono))
+        {
+            if(numMono <= 0)
+                numMono = 256;
+        }
+        else
+            numMono = maxi(numMono, 256);
+        numStereo = mini(numStereo, numMono);
+        numMono -= numStereo;
+        device->SourcesMax = numMono + numStereo;
+
         device->NumMonoSources = numMono;
         device->NumStereoSources = numStereo;
 
@@ -1860,390 +2219,130 @@ static ALCenum UpdateDeviceParams(ALCdevice *device, const ALCint *attrList)
         if(ConfigValueInt(device->DeviceName.c_str(), nullptr, "sources", &numMono))
         {
             if(numMono <= 0)
-                numMono = 256;
-        }
-        else
-            numMono = maxi(numMono, 256);
-        numStereo = mini(numStereo, numMono);
-        numMono -= numStereo;
-        device->SourcesMax = numMono + numStereo;
-
-        device->NumMonoSources = numMono;
-        device->NumStereoSources = numStereo;
-
-        if(ConfigValueInt(device->DeviceName.c_str(), nullptr, "sends", &new_sends))
-            new_sends = mini(numSends, clampi(new_sends, 0, MAX_SENDS));
-        else
-            new_sends = numSends;
-    }
-
-    if((device->Flags&DEVICE_RUNNING))
-        return ALC_NO_ERROR;
-
-    device->Uhj_Encoder = nullptr;
-    device->Bs2b = nullptr;
-
-    device->ChannelDelay.clear();
-    device->ChannelDelay.shrink_to_fit();
-
-    device->Dry.Buffer = nullptr;
-    device->Dry.NumChannels = 0;
-    device->FOAOut.Buffer = nullptr;
-    device->FOAOut.NumChannels = 0;
-    device->RealOut.Buffer = nullptr;
-    device->RealOut.NumChannels = 0;
-    device->MixBuffer.clear();
-    device->MixBuffer.shrink_to_fit();
-
-    UpdateClockBase(device);
-    device->FixedLatency = std::chrono::nanoseconds::zero();
-
-    device->DitherSeed = DITHER_RNG_SEED;
-
-    /*************************************************************************
-     * Update device format request if HRTF is requested
-     */
-    device->HrtfStatus = ALC_HRTF_DISABLED_SOFT;
-    if(device->Type != Loopback)
-    {
-        const char *hrtf;
-        if(ConfigValueStr(device->DeviceName.c_str(), nullptr, "hrtf", &hrtf))
-        {
-            if(strcasecmp(hrtf, "true") == 0)
-                hrtf_userreq = Hrtf_Enable;
-            else if(strcasecmp(hrtf, "false") == 0)
-                hrtf_userreq = Hrtf_Disable;
-            else if(strcasecmp(hrtf, "auto") != 0)
-                ERR("Unexpected hrtf value: %s\n", hrtf);
-        }
-
-        if(hrtf_userreq == Hrtf_Enable || (hrtf_userreq != Hrtf_Disable && hrtf_appreq == Hrtf_Enable))
-        {
-            struct Hrtf *hrtf = nullptr;
-            if(device->HrtfList.empty())
-                device->HrtfList = EnumerateHrtf(device->DeviceName.c_str());
-            if(!device->HrtfList.empty())
-            {
-                if(hrtf_id >= 0 && (size_t)hrtf_id < device->HrtfList.size())
-                    hrtf = GetLoadedHrtf(device->HrtfList[hrtf_id].hrtf);
-                else
-                    hrtf = GetLoadedHrtf(device->HrtfList.front().hrtf);
-            }
-
-            if(hrtf)
-            {
-                device->FmtChans = DevFmtStereo;
-                device->Frequency = hrtf->sampleRate;
-                device->Flags |= DEVICE_CHANNELS_REQUEST | DEVICE_FREQUENCY_REQUEST;
-                if(device->HrtfHandle)
-                    Hrtf_DecRef(device->HrtfHandle);
-                device->HrtfHandle = hrtf;
-            }
-            else
-            {
-                hrtf_userreq = Hrtf_Default;
-                hrtf_appreq = Hrtf_Disable;
-                device->HrtfStatus = ALC_HRTF_UNSUPPORTED_FORMAT_SOFT;
-            }
-        }
-    }
-
-    oldFreq  = device->Frequency;
-    oldChans = device->FmtChans;
-    oldType  = device->FmtType;
-
-    TRACE("Pre-reset: %s%s, %s%s, %s%uhz, %u update size x%d\n",
-        (device->Flags&DEVICE_CHANNELS_REQUEST)?"*":"", DevFmtChannelsString(device->FmtChans),
-        (device->Flags&DEVICE_SAMPLE_TYPE_REQUEST)?"*":"", DevFmtTypeString(device->FmtType),
-        (device->Flags&DEVICE_FREQUENCY_REQUEST)?"*":"", device->Frequency,
-        device->UpdateSize, device->NumUpdates
-    );
-
-    if(V0(device->Backend,reset)() == ALC_FALSE)
-        return ALC_INVALID_DEVICE;
-
-    if(device->FmtChans != oldChans && (device->Flags&DEVICE_CHANNELS_REQUEST))
-    {
-        ERR("Failed to set %s, got %s instead\n", DevFmtChannelsString(oldChans),
-            DevFmtChannelsString(device->FmtChans));
-        device->Flags &= ~DEVICE_CHANNELS_REQUEST;
-    }
-    if(device->FmtType != oldType && (device->Flags&DEVICE_SAMPLE_TYPE_REQUEST))
-    {
-        ERR("Failed to set %s, got %s instead\n", DevFmtTypeString(oldType),
-            DevFmtTypeString(device->FmtType));
-        device->Flags &= ~DEVICE_SAMPLE_TYPE_REQUEST;
-    }
-    if(device->Frequency != oldFreq && (device->Flags&DEVICE_FREQUENCY_REQUEST))
-    {
-        ERR("Failed to set %uhz, got %uhz instead\n", oldFreq, device->Frequency);
-        device->Flags &= ~DEVICE_FREQUENCY_REQUEST;
-    }
-
-    if((device->UpdateSize&3) != 0)
-    {
-        if((CPUCapFlags&CPU_CAP_SSE))
-            WARN("SSE performs best with multiple of 4 update sizes (%u)\n", device->UpdateSize);
-        if((CPUCapFlags&CPU_CAP_NEON))
-            WARN("NEON performs best with multiple of 4 update sizes (%u)\n", device->UpdateSize);
-    }
-
-    TRACE("Post-reset: %s, %s, %uhz, %u update size x%d\n",
-        DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
-        device->Frequency, device->UpdateSize, device->NumUpdates
-    );
-
-    aluInitRenderer(device, hrtf_id, hrtf_appreq, hrtf_userreq);
-    TRACE("Channel config, Dry: %d, FOA: %d, Real: %d\n", device->Dry.NumChannels,
-          device->FOAOut.NumChannels, device->RealOut.NumChannels);
-
-    /* Allocate extra channels for any post-filter output. */
-    ALsizei num_chans{device->Dry.NumChannels + device->FOAOut.NumChannels +
-                      device->RealOut.NumChannels};
-
-    TRACE("Allocating %d channels, " SZFMT " bytes\n", num_chans,
-          num_chans*sizeof(device->MixBuffer[0]));
-    device->MixBuffer.resize(num_chans);
-
-    device->Dry.Buffer = &reinterpret_cast<ALfloat(&)[BUFFERSIZE]>(device->MixBuffer[0]);
-    if(device->RealOut.NumChannels != 0)
-        device->RealOut.Buffer = device->Dry.Buffer + device->Dry.NumChannels +
-                                 device->FOAOut.NumChannels;
-    else
-    {
-        device->RealOut.Buffer = device->Dry.Buffer;
-        device->RealOut.NumChannels = device->Dry.NumChannels;
-    }
-
-    if(device->FOAOut.NumChannels != 0)
-        device->FOAOut.Buffer = device->Dry.Buffer + device->Dry.NumChannels;
-    else
-    {
-        device->FOAOut.Buffer = device->Dry.Buffer;
-        device->FOAOut.NumChannels = device->Dry.NumChannels;
-    }
-
-    device->NumAuxSends = new_sends;
-    TRACE("Max sources: %d (%d + %d), effect slots: %d, sends: %d\n",
-          device->SourcesMax, device->NumMonoSources, device->NumStereoSources,
-          device->AuxiliaryEffectSlotMax, device->NumAuxSends);
-
-    device->DitherDepth = 0.0f;
-    if(GetConfigValueBool(device->DeviceName.c_str(), nullptr, "dither", 1))
-    {
-        ALint depth = 0;
-        ConfigValueInt(device->DeviceName.c_str(), nullptr, "dither-depth", &depth);
-        if(depth <= 0)
-        {
-            switch(device->FmtType)
-            {
-                case DevFmtByte:
-                case DevFmtUByte:
-                    depth = 8;
-                    break;
-                case DevFmtShort:
-                case DevFmtUShort:
-                    depth = 16;
-                    break;
-                case DevFmtInt:
-                case DevFmtUInt:
-                case DevFmtFloat:
-                    break;
-            }
-        }
-
-        if(depth > 0)
-        {
-            depth = clampi(depth, 2, 24);
-            device->DitherDepth = std::pow(2.0f, (ALfloat)(depth-1));
-        }
-    }
-    if(!(device->DitherDepth > 0.0f))
-        TRACE("Dithering disabled\n");
-    else
-        TRACE("Dithering enabled (%d-bit, %g)\n", float2int(std::log2(device->DitherDepth)+0.5f)+1,
-              device->DitherDepth);
-
-    device->LimiterState = gainLimiter;
-    if(ConfigValueBool(device->DeviceName.c_str(), nullptr, "output-limiter", &val))
-        gainLimiter = val ? ALC_TRUE : ALC_FALSE;
-
-    /* Valid values for gainLimiter are ALC_DONT_CARE_SOFT, ALC_TRUE, and
-     * ALC_FALSE. For ALC_DONT_CARE_SOFT, use the limiter for integer-based
-     * output (where samples must be clamped), and don't for floating-point
-     * (which can take unclamped samples).
-     */
-    if(gainLimiter == ALC_DONT_CARE_SOFT)
-    {
-        switch(device->FmtType)
-        {
-            case DevFmtByte:
-            case DevFmtUByte:
-            case DevFmtShort:
-            case DevFmtUShort:
-            case DevFmtInt:
-            case DevFmtUInt:
-                gainLimiter = ALC_TRUE;
-                break;
-            case DevFmtFloat:
-                gainLimiter = ALC_FALSE;
-                break;
-        }
-    }
-    if(gainLimiter != ALC_FALSE)
-    {
-        ALfloat thrshld = 1.0f;
-        switch(device->FmtType)
-        {
-            case DevFmtByte:
-            case DevFmtUByte:
-                thrshld = 127.0f / 128.0f;
-                break;
-            case DevFmtShort:
-            case DevFmtUShort:
-                thrshld = 32767.0f / 32768.0f;
-                break;
-            case DevFmtInt:
-            case DevFmtUInt:
-            case DevFmtFloat:
-                break;
+                numMono = 256;
         }
-        if(device->DitherDepth > 0.0f)
-            thrshld -= 1.0f / device->DitherDepth;
+        else
+            numMono = maxi(numMono, 256);
+        numStereo = mini(numStereo, numMono);
+        numMono -= numStereo;
+        device->SourcesMax = numMono + numStereo;
 
-        device->Limiter.reset(CreateDeviceLimiter(device, std::log10(thrshld) * 20.0f));
-        /* Convert the lookahead from samples to nanosamples to nanoseconds. */
-        device->FixedLatency += std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::seconds(GetCompressorLookAhead(device->Limiter.get()))
-        ) / device->Frequency;
+        device->NumMonoSources = numMono;
+        device->NumStereoSources = numStereo;
+
+        if(ConfigValueInt(device->DeviceName.c_str(), nullptr, "sends", &new_sends))
+            new_sends = mini(numSends, clampi(new_sends, 0, MAX_SENDS));
+        else
+            new_sends = numSends;
     }
-    else
-        device->Limiter = nullptr;
-    TRACE("Output limiter %s\n", device->Limiter ? "enabled" : "disabled");
 
-    aluSelectPostProcess(device);
+    if((device->Flags&DEVICE_RUNNING))
+        return ALC_NO_ERROR;
 
-    TRACE("Fixed device latency: %ldns\n", (long)device->FixedLatency.count());
+    UpdateClockBase(device);
 
-    /* Need to delay returning failure until replacement Send arrays have been
-     * allocated with the appropriate size.
+    device->DitherSeed = DITHER_RNG_SEED;
+
+    /*************************************************************************
+     * Update device format request if HRTF is requested
      */
-    update_failed = AL_FALSE;
-    FPUCtl mixer_mode{};
-    context = device->ContextList.load();
-    while(context)
+    device->HrtfStatus = ALC_HRTF_DISABLED_SOFT;
+    if(device->Type != Loopback)
     {
-        if(context->DefaultSlot)
+        const char *hrtf;
+        if(ConfigValueStr(device->DeviceName.c_str(), nullptr, "hrtf", &hrtf))
         {
-            ALeffectslot *slot = context->DefaultSlot.get();
-            EffectState *state = slot->Effect.State;
-
-            state->mOutBuffer = device->Dry.Buffer;
-            state->mOutChannels = device->Dry.NumChannels;
-            if(state->deviceUpdate(device) == AL_FALSE)
-                update_failed = AL_TRUE;
-            else
-                UpdateEffectSlotProps(slot, context);
+            if(strcasecmp(hrtf, "true") == 0)
+                hrtf_userreq = Hrtf_Enable;
+            else if(strcasecmp(hrtf, "false") == 0)
+                hrtf_userreq = Hrtf_Disable;
+            else if(strcasecmp(hrtf, "auto") != 0)
+                ERR("Unexpected hrtf value: %s\n", hrtf);
         }
 
-        std::unique_lock<std::mutex> proplock{context->PropLock};
-        std::unique_lock<std::mutex> slotlock{context->EffectSlotLock};
-        for(auto &slot : context->EffectSlotList)
+        /* Asynchronous loading leaves the output format alone, rather than
+         * loading the HRTF here to get its sample rate.
+         */
+        if((hrtf_userreq == Hrtf_Enable || (hrtf_userreq != Hrtf_Disable &&
+            hrtf_appreq == Hrtf_Enable)) &&
+           !GetConfigValueBool(device->DeviceName.c_str(), nullptr, "hrtf-async", 0))
         {
-            EffectState *state = slot->Effect.State;
+            struct Hrtf *hrtf = nullptr;
+            if(device->HrtfList.empty())
+                device->HrtfList = EnumerateHrtf(device->DeviceName.c_str());
+            if(!device->HrtfList.empty())
+            {
+                if(hrtf_id >= 0 && (size_t)hrtf_id < device->HrtfList.size())
+                    hrtf = GetLoadedHrtf(device->HrtfList[hrtf_id].hrtf);
+                else
+                    hrtf = GetLoadedHrtf(device->HrtfList.front().hrtf);
+            }
 
-            state->mOutBuffer = device->Dry.Buffer;
-            state->mOutChannels = device->Dry.NumChannels;
-            if(state->deviceUpdate(device) == AL_FALSE)
-                update_failed = AL_TRUE;
+            if(hrtf)
+            {
+                device->FmtChans = DevFmtStereo;
+                device->Frequency = hrtf->sampleRate;
+                device->Flags |= DEVICE_CHANNELS_REQUEST | DEVICE_FREQUENCY_REQUEST;
+                if(device->HrtfHandle)
+                    Hrtf_DecRef(device->HrtfHandle);
+                device->HrtfHandle = hrtf;
+            }
             else
-                UpdateEffectSlotProps(slot.get(), context);
-        }
-        slotlock.unlock();
-
-        std::unique_lock<std::mutex> srclock{context->SourceLock};
-        for(auto &sublist : context->SourceList)
-        {
-            uint64_t usemask = ~sublist.FreeMask;
-            while(usemask)
             {
-                ALsizei idx = CTZ64(usemask);
-                ALsource *source = sublist.Sources + idx;
-
-                usemask &= ~(U64(1) << idx);
-
-                if(old_sends != device->NumAuxSends)
-                {
-                    ALsizei s;
-                    for(s = device->NumAuxSends;s < old_sends;s++)
-                    {
-                        if(source->Send[s].Slot)
-                            DecrementRef(&source->Send[s].Slot->ref);
-                        source->Send[s].Slot = nullptr;
-                    }
-                    source->Send.resize(device->NumAuxSends);
-                    source->Send.shrink_to_fit();
-                    for(s = old_sends;s < device->NumAuxSends;s++)
-                    {
-                        source->Send[s].Slot = nullptr;
-                        source->Send[s].Gain = 1.0f;
-                        source->Send[s].GainHF = 1.0f;
-                        source->Send[s].HFReference = LOWPASSFREQREF;
-                        source->Send[s].GainLF = 1.0f;
-                        source->Send[s].LFReference = HIGHPASSFREQREF;
-                    }
-                }
-
-                source->PropsClean.clear(std::memory_order_release);
+                hrtf_userreq = Hrtf_Default;
+                hrtf_appreq = Hrtf_Disable;
+                device->HrtfStatus = ALC_HRTF_UNSUPPORTED_FORMAT_SOFT;
             }
         }
+    }
 
-        /* Clear any pre-existing voice property structs, in case the number of
-         * auxiliary sends is changing. Active sources will have updates
-         * respecified in UpdateAllSourceProps.
-         */
-        ALvoiceProps *vprops{context->FreeVoiceProps.exchange(nullptr, std::memory_order_acq_rel)};
-        while(vprops)
-        {
-            ALvoiceProps *next = vprops->next.load(std::memory_order_relaxed);
-            delete vprops;
-            vprops = next;
-        }
-
-        AllocateVoices(context, context->MaxVoices, old_sends);
-        auto voices_end = context->Voices + context->VoiceCount.load(std::memory_order_relaxed);
-        std::for_each(context->Voices, voices_end,
-            [device](ALvoice *voice) -> void
-            {
-                delete voice->Update.exchange(nullptr, std::memory_order_acq_rel);
+    oldFreq  = device->Frequency;
+    oldChans = device->FmtChans;
+    oldType  = device->FmtType;
 
-                if(voice->SourceID.load(std::memory_order_acquire) == 0u)
-                    return;
+    TRACE("Pre-reset: %s%s, %s%s, %s%uhz, %u update size x%d\n",
+        (device->Flags&DEVICE_CHANNELS_REQUEST)?"*":"", DevFmtChannelsString(device->FmtChans),
+        (device->Flags&DEVICE_SAMPLE_TYPE_REQUEST)?"*":"", DevFmtTypeString(device->FmtType),
+        (device->Flags&DEVICE_FREQUENCY_REQUEST)?"*":"", device->Frequency,
+        device->UpdateSize, device->NumUpdates
+    );
 
-                if(device->AvgSpeakerDist > 0.0f)
-                {
-                    /* Reinitialize the NFC filters for new parameters. */
-                    ALfloat w1 = SPEEDOFSOUNDMETRESPERSEC /
-                                 (device->AvgSpeakerDist * device->Frequency);
-                    std::for_each(voice->Direct.Params, voice->Direct.Params+voice->NumChannels,
-                        [w1](DirectParams &params) noexcept -> void
-                        { params.NFCtrlFilter.init(0.0f, w1); }
-                    );
-                }
-            }
-        );
-        srclock.unlock();
+    if(V0(device->Backend,reset)() == ALC_FALSE)
+        return ALC_INVALID_DEVICE;
 
-        context->PropsClean.test_and_set(std::memory_order_release);
-        UpdateContextProps(context);
-        context->Listener.PropsClean.test_and_set(std::memory_order_release);
-        UpdateListenerProps(context);
-        UpdateAllSourceProps(context);
+    if(device->FmtChans != oldChans && (device->Flags&DEVICE_CHANNELS_REQUEST))
+    {
+        ERR("Failed to set %s, got %s instead\n", DevFmtChannelsString(oldChans),
+            DevFmtChannelsString(device->FmtChans));
+        device->Flags &= ~DEVICE_CHANNELS_REQUEST;
+    }
+    if(device->FmtType != oldType && (device->Flags&DEVICE_SAMPLE_TYPE_REQUEST))
+    {
+        ERR("Failed to set %s, got %s instead\n", DevFmtTypeString(oldType),
+            DevFmtTypeString(device->FmtType));
+        device->Flags &= ~DEVICE_SAMPLE_TYPE_REQUEST;
+    }
+    if(device->Frequency != oldFreq && (device->Flags&DEVICE_FREQUENCY_REQUEST))
+    {
+        ERR("Failed to set %uhz, got %uhz instead\n", oldFreq, device->Frequency);
+        device->Flags &= ~DEVICE_FREQUENCY_REQUEST;
+    }
 
-        context = context->next.load(std::memory_order_relaxed);
+    if((device->UpdateSize&3) != 0)
+    {
+        if((CPUCapFlags&CPU_CAP_SSE))
+            WARN("SSE performs best with multiple of 4 update sizes (%u)\n", device->UpdateSize);
+        if((CPUCapFlags&CPU_CAP_NEON))
+            WARN("NEON performs best with multiple of 4 update sizes (%u)\n", device->UpdateSize);
     }
-    mixer_mode.leave();
-    if(update_failed)
+
+    TRACE("Post-reset: %s, %s, %uhz, %u update size x%d\n",
+        DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
+        device->Frequency, device->UpdateSize, device->NumUpdates
+    );
+
+    if(InitDeviceRenderer(device, hrtf_id, hrtf_appreq, hrtf_userreq, gainLimiter, old_sends,
+                          new_sends, false) == ALC_FALSE)
         return ALC_INVALID_DEVICE;
 
     if(!(device->Flags&DEVICE_PAUSED))
@@ -2298,6 +2397,9 @@ ALCdevice_struct::~ALCdevice_struct()
     if(HrtfHandle)
         Hrtf_DecRef(HrtfHandle);
     HrtfHandle = nullptr;
+    if(HrtfLoaded)
+        Hrtf_DecRef(HrtfLoaded);
+    HrtfLoaded = nullptr;
 }
 
 
@@ -2380,6 +2482,144 @@ static DeviceRef VerifyDevice(ALCdevice *device)
 }
 
 
+/* Sends an HRTF changed event to all of the device's contexts. */
+static void SendHrtfChangedEvent(ALCdevice *device, const char *msg)
+{
+    AsyncEvent evt{EventType_HrtfChanged};
+    evt.u.user.type = AL_EVENT_TYPE_HRTF_CHANGED_SOFT;
+    evt.u.user.id = 0;
+    evt.u.user.param = device->HrtfHandle ? AL_TRUE : AL_FALSE;
+    strncpy(evt.u.user.msg, msg, sizeof(evt.u.user.msg)-1);
+    evt.u.user.msg[sizeof(evt.u.user.msg)-1] = 0;
+
+    ALCcontext *ctx{device->ContextList.load()};
+    while(ctx)
+    {
+        const ALbitfieldSOFT enabledevt{ctx->EnabledEvts.load(std::memory_order_acquire)};
+        if((enabledevt&EventType_HrtfChanged) &&
+           ll_ringbuffer_write(ctx->AsyncEvents, &evt, 1) == 1)
+            ctx->EventSem.post();
+        ctx = ctx->next.load(std::memory_order_relaxed);
+    }
+}
+
+/* Loads the device's HRTF in the background, then switches the device over to
+ * the HRTF renderer, as long as the device wasn't reset or closed meanwhile.
+ * The device keeps mixing with its current renderer until the switch, which
+ * is done with the mixer locked.
+ */
+static void HrtfLoaderProc(DeviceRef devref, ALuint loadid, std::string devname,
+    ALCsizei hrtf_id, HrtfRequestMode hrtf_appreq, HrtfRequestMode hrtf_userreq,
+    ALuint frequency)
+{
+    althrd_setname(HRTF_LOADER_THREAD_NAME);
+
+    al::vector<EnumeratedHrtf> list{EnumerateHrtf(devname.c_str())};
+    std::string name;
+    Hrtf *hrtf{LoadDeviceHrtf(list, hrtf_id, frequency, &name)};
+
+    /* Application threads take the context locks before the device's backend
+     * lock, while device resets take them after. So lock the contexts first
+     * and only try for the backend lock, backing off to let a reset finish if
+     * it's busy. Holding the list lock keeps contexts from being destroyed,
+     * but new ones may be added before the backend lock is held.
+     */
+    DeviceRef dev;
+    std::unique_lock<std::recursive_mutex> listlock;
+    std::unique_lock<std::mutex> backlock;
+    al::vector<std::unique_lock<std::mutex>> ctxlocks;
+    while(1)
+    {
+        listlock = std::unique_lock<std::recursive_mutex>{ListLock};
+        dev = VerifyDevice(devref.get());
+        if(!dev) break;
+
+        ALCcontext *head{dev->ContextList.load()};
+        for(ALCcontext *ctx{head};ctx;ctx = ctx->next.load(std::memory_order_relaxed))
+        {
+            ctxlocks.emplace_back(ctx->PropLock);
+            ctxlocks.emplace_back(ctx->SourceLock);
+            ctxlocks.emplace_back(ctx->EffectSlotLock);
+        }
+        backlock = std::unique_lock<std::mutex>{dev->BackendLock, std::try_to_lock};
+        if(backlock && dev->ContextList.load() == head)
+            break;
+
+        if(backlock) backlock.unlock();
+        while(!ctxlocks.empty())
+            ctxlocks.pop_back();
+        dev = DeviceRef{};
+        listlock.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    devref = DeviceRef{};
+    if(!dev)
+    {
+        listlock.unlock();
+        if(hrtf) Hrtf_DecRef(hrtf);
+        return;
+    }
+    listlock.unlock();
+
+    if(dev->HrtfLoadId != loadid)
+    {
+        TRACE("Discarding HRTF loaded for an old device configuration\n");
+        if(hrtf) Hrtf_DecRef(hrtf);
+        return;
+    }
+
+    if(dev->HrtfList.empty())
+        dev->HrtfList = std::move(list);
+    if(!hrtf)
+    {
+        WARN("No HRTF found for %uhz output\n", frequency);
+        dev->HrtfStatus = ALC_HRTF_UNSUPPORTED_FORMAT_SOFT;
+        V0(dev->Backend,lock)();
+        SendHrtfChangedEvent(dev.get(), "No usable HRTF found");
+        V0(dev->Backend,unlock)();
+        return;
+    }
+
+    if(dev->HrtfLoaded)
+        Hrtf_DecRef(dev->HrtfLoaded);
+    dev->HrtfLoaded = hrtf;
+    dev->HrtfLoadedName = std::move(name);
+
+    V0(dev->Backend,lock)();
+    if(InitDeviceRenderer(dev.get(), hrtf_id, hrtf_appreq, hrtf_userreq, dev->LimiterState,
+                          dev->NumAuxSends, dev->NumAuxSends, true) == ALC_FALSE)
+        aluHandleDisconnect(dev.get(), "Device update failure");
+    else
+    {
+        std::string msg{"HRTF enabled using \""+dev->HrtfName+"\""};
+        SendHrtfChangedEvent(dev.get(), dev->HrtfHandle ? msg.c_str() : "HRTF disabled");
+    }
+    V0(dev->Backend,unlock)();
+}
+
+/* StartHrtfLoader
+ *
+ * Starts loading the device's HRTF in the background. The device's renderer
+ * is updated when it's ready.
+ */
+static void StartHrtfLoader(ALCdevice *device, ALCsizei hrtf_id, HrtfRequestMode hrtf_appreq,
+    HrtfRequestMode hrtf_userreq)
+{
+    ALCdevice_IncRef(device);
+    DeviceRef devref{device};
+    try {
+        std::thread{HrtfLoaderProc, std::move(devref), device->HrtfLoadId, device->DeviceName,
+            hrtf_id, hrtf_appreq, hrtf_userreq, device->Frequency}.detach();
+    }
+    catch(std::exception& e) {
+        ERR("Failed to start HRTF loader thread: %s\n", e.what());
+    }
+    catch(...) {
+        ERR("Failed to start HRTF loader thread!\n");
+    }
+}
+
+
 ALCcontext_struct::ALCcontext_struct(ALCdevice *device)
   : Device{device}
 {
@@ -2420,6 +2660,17 @@ static ALvoid InitContext(ALCcontext *Context)
 
     Context->ExtensionList = alExtList;
 
+    const char *devname{Context->Device->DeviceName.c_str()};
+    ALint voicelimit{0};
+    if(ConfigValueInt(devname, nullptr, "voice-limit", &voicelimit) && voicelimit > 0)
+        Context->MaxMixedVoices = voicelimit;
+    ALfloat voicebudget{0.0f};
+    if(ConfigValueFloat(devname, nullptr, "voice-budget", &voicebudget) && voicebudget > 0.0f)
+        Context->MixBudget = minf(voicebudget, 100.0f) / 100.0f;
+    if(Context->MaxMixedVoices > 0 || Context->MixBudget > 0.0f)
+        TRACE("Voice scheduling enabled: limit %d, budget %.1f%%\n", Context->MaxMixedVoices,
+              Context->MixBudget*100.0f);
+
 
     listener.Params.Matrix = alu::Matrix::Identity();
     listener.Params.Velocity = alu::Vector{};
@@ -2509,6 +2760,7 @@ ALCcontext_struct::~ALCcontext_struct()
     std::for_each(Voices, Voices + MaxVoices, DeinitVoice);
     al_free(Voices);
     Voices = nullptr;
+    VoiceStates = nullptr;
     VoiceCount.store(0, std::memory_order_relaxed);
     MaxVoices = 0;
 
@@ -2653,17 +2905,21 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
     if(num_voices == context->MaxVoices && num_sends == old_sends)
         return;
 
-    /* Allocate the voice pointers, voices, and the voices' stored source
-     * property set (including the dynamically-sized Send[] array) in one
-     * chunk.
+    /* Allocate the voice pointers, the voices' packed states, and the voices
+     * along with their stored source property set (including the
+     * dynamically-sized Send[] array) in one chunk.
      */
     const size_t sizeof_voice{RoundUp(FAM_SIZE(ALvoice, Send, num_sends), 16)};
-    const size_t size{sizeof(ALvoice*) + sizeof_voice};
+    const size_t sizeof_ptrs{RoundUp(num_voices*sizeof(ALvoice*), 16)};
+    const size_t sizeof_states{RoundUp(num_voices*sizeof(ALvoiceState), 16)};
 
-    auto voices = static_cast<ALvoice**>(al_calloc(16, RoundUp(size*num_voices, 16)));
-    auto voice = reinterpret_cast<ALvoice*>((char*)voices + RoundUp(num_voices*sizeof(ALvoice*), 16));
+    auto voices = static_cast<ALvoice**>(al_calloc(16,
+        sizeof_ptrs + sizeof_states + sizeof_voice*num_voices));
+    auto states = reinterpret_cast<ALvoiceState*>((char*)voices + sizeof_ptrs);
+    auto voice = reinterpret_cast<ALvoice*>((char*)states + sizeof_states);
 
     auto viter = voices;
+    auto siter = states;
     if(context->Voices)
     {
         const ALsizei v_count = mini(context->VoiceCount.load(std::memory_order_relaxed),
@@ -2671,9 +2927,10 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
         const ALsizei s_count = mini(old_sends, num_sends);
 
         /* Copy the old voice data to the new storage. */
-        auto copy_voice = [&voice,sizeof_voice,s_count](ALvoice *old_voice) -> ALvoice*
+        auto copy_voice = [&voice,&siter,sizeof_voice,s_count](ALvoice *old_voice) -> ALvoice*
         {
             voice = new (voice) ALvoice{};
+            voice->State = new (siter++) ALvoiceState{};
 
             /* Make sure the old voice's Update (if any) is cleared so it
              * doesn't get deleted on deinit.
@@ -2681,10 +2938,15 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
             voice->Update.store(old_voice->Update.exchange(nullptr, std::memory_order_relaxed),
                                 std::memory_order_relaxed);
 
-            voice->SourceID.store(old_voice->SourceID.load(std::memory_order_relaxed),
-                                  std::memory_order_relaxed);
-            voice->Playing.store(old_voice->Playing.load(std::memory_order_relaxed),
-                                 std::memory_order_relaxed);
+            const ALvoiceState *old_state{old_voice->State};
+            voice->State->SourceID.store(old_state->SourceID.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+            voice->State->Playing.store(old_state->Playing.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+            voice->State->Step = old_state->Step;
+            voice->State->Flags = old_state->Flags;
+            voice->State->Priority = old_state->Priority;
+            voice->State->Audibility = old_state->Audibility;
 
             voice->Props = old_voice->Props;
             /* Clear extraneous property set sends. */
@@ -2705,11 +2967,8 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
             voice->NumChannels = old_voice->NumChannels;
             voice->SampleSize = old_voice->SampleSize;
 
-            voice->Step = old_voice->Step;
             voice->Resampler = old_voice->Resampler;
 
-            voice->Flags = old_voice->Flags;
-
             voice->Offset = old_voice->Offset;
 
             std::copy(std::begin(old_voice->PrevSamples), std::end(old_voice->PrevSamples),
@@ -2718,6 +2977,7 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
             voice->ResampleState = old_voice->ResampleState;
 
             voice->Direct = old_voice->Direct;
+            voice->HrtfTail = std::move(old_voice->HrtfTail);
             std::copy_n(old_voice->Send, s_count, voice->Send);
 
             /* Set this voice's reference. */
@@ -2733,9 +2993,10 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
         std::for_each(context->Voices, voices_end, DeinitVoice);
     }
     /* Finish setting the voices and references. */
-    auto init_voice = [&voice,sizeof_voice]() -> ALvoice*
+    auto init_voice = [&voice,&siter,sizeof_voice]() -> ALvoice*
     {
         ALvoice *ret = new (voice) ALvoice{};
+        ret->State = new (siter++) ALvoiceState{};
         voice = reinterpret_cast<ALvoice*>((char*)voice + sizeof_voice);
         return ret;
     };
@@ -2743,6 +3004,9 @@ void AllocateVoices(ALCcontext *context, ALsizei num_voices, ALsizei old_sends)
 
     al_free(context->Voices);
     context->Voices = voices;
+    context->VoiceStates = states;
+    context->ActiveVoices.reserve(num_voices);
+    context->VoiceRanking.reserve(num_voices);
     context->MaxVoices = num_voices;
     context->VoiceCount = mini(context->VoiceCount.load(std::memory_order_relaxed), num_voices);
 }
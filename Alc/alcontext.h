@@ -26,6 +26,7 @@ struct ALlistenerProps;
 struct ALvoiceProps;
 struct ALeffectslotProps;
 struct ALvoice;
+struct ALvoiceState;
 struct ALeffectslotArray;
 struct ll_ringbuffer;
 
@@ -105,9 +106,24 @@ struct ALCcontext_struct {
     std::atomic<ALeffectslotProps*> FreeEffectslotProps{nullptr};
 
     ALvoice **Voices{nullptr};
+    /* The voices' packed per-update states, indexed the same as Voices. */
+    ALvoiceState *VoiceStates{nullptr};
     std::atomic<ALsizei> VoiceCount{0};
     ALsizei MaxVoices{0};
 
+    /* Indices of the voices being mixed in the current update. */
+    al::vector<ALsizei> ActiveVoices;
+
+    /* Voice scheduling limits. When either is set, only the highest ranked
+     * voices are mixed each update, and the rest are advanced silently. The
+     * mix budget is a fraction of the update period, and the mix cost is a
+     * running estimate of the time (in nanoseconds) each mixed voice takes.
+     */
+    ALsizei MaxMixedVoices{0};
+    ALfloat MixBudget{0.0f};
+    ALfloat VoiceMixCost{0.0f};
+    al::vector<ALsizei> VoiceRanking;
+
     std::atomic<ALeffectslotArray*> ActiveAuxSlots{nullptr};
 
     std::thread EventThread;
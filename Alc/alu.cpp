@@ -27,6 +27,7 @@
 #include <assert.h>
 
 #include <cmath>
+#include <chrono>
 #include <algorithm>
 
 #include "alMain.h"
@@ -43,6 +44,7 @@
 #include "bformatdec.h"
 #include "ringbuffer.h"
 #include "filters/splitter.h"
+#include "mixerpool.h"
 
 #include "mixer/defs.h"
 #include "fpu_modes.h"
@@ -112,6 +114,10 @@ inline HrtfDirectMixerFunc SelectHrtfMixer(void)
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixDirectHrtf_Neon;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixDirectHrtf_AVX2;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixDirectHrtf_SSE;
@@ -120,6 +126,144 @@ inline HrtfDirectMixerFunc SelectHrtfMixer(void)
     return MixDirectHrtf_C;
 }
 
+AmbiCoeffsRowFunc CalcAmbiCoeffsRow = CalcAmbiCoeffsRow_C;
+PanGainsMCFunc ComputePanGainsMC = ComputePanGainsMC_C;
+
+inline AmbiCoeffsRowFunc SelectAmbiCoeffsRow(void)
+{
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return CalcAmbiCoeffsRow_SSE;
+#endif
+
+    return CalcAmbiCoeffsRow_C;
+}
+
+inline PanGainsMCFunc SelectPanGainsMC(void)
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return ComputePanGainsMC_Neon;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return ComputePanGainsMC_SSE;
+#endif
+
+    return ComputePanGainsMC_C;
+}
+
+
+/* Collects the panning directions and gain targets of the voices updated for
+ * a mix, so their ambisonic coefficients and gains can be computed together
+ * with the vectorized batch functions, rather than one voice, channel, and
+ * send at a time.
+ */
+class PanningBatch {
+    static constexpr ALsizei MaxDirections{64};
+    static constexpr ALsizei MaxDryTargets{64};
+    static constexpr ALsizei MaxSendTargets{256};
+
+    struct SendTarget {
+        const BFChannelConfig *ChanMap;
+        ALsizei NumChannels;
+        PanGainTarget Target;
+    };
+
+    const MixParams *const mDry;
+
+    /* Directions as ambisonic components, with their spread norms. */
+    alignas(16) ALfloat mY[MaxDirections];
+    alignas(16) ALfloat mZ[MaxDirections];
+    alignas(16) ALfloat mX[MaxDirections];
+    alignas(16) ALfloat mNorms[MaxDirections][4];
+    alignas(16) ALfloat mCoeffs[MaxDirections][MAX_AMBI_COEFFS];
+    ALsizei mNumDirections{0};
+
+    PanGainTarget mDryTargets[MaxDryTargets];
+    ALsizei mNumDryTargets{0};
+    SendTarget mSendTargets[MaxSendTargets];
+    ALsizei mNumSendTargets{0};
+
+public:
+    PanningBatch(const MixParams *dry) noexcept : mDry{dry} { }
+    PanningBatch(const PanningBatch&) = delete;
+    PanningBatch& operator=(const PanningBatch&) = delete;
+
+    /* Makes room for a voice's directions and gain targets, computing what's
+     * pending if it doesn't fit.
+     */
+    void reserve(ALsizei numdirs, ALsizei numdry, ALsizei numsend) noexcept
+    {
+        assert(numdirs <= MaxDirections && numdry <= MaxDryTargets &&
+               numsend <= MaxSendTargets);
+        if(mNumDirections+numdirs > MaxDirections || mNumDryTargets+numdry > MaxDryTargets ||
+           mNumSendTargets+numsend > MaxSendTargets)
+            flush();
+    }
+
+    /* Adds a direction to calculate ambisonic coefficients for, the same as
+     * CalcAngleCoeffs. The returned coefficients are only valid after the
+     * next flush.
+     */
+    const ALfloat *addDirection(ALfloat azimuth, ALfloat elevation, ALfloat spread) noexcept
+    {
+        const ALsizei idx{mNumDirections++};
+        mY[idx] = -sinf(azimuth) * cosf(elevation);
+        mZ[idx] = sinf(elevation);
+        mX[idx] = cosf(azimuth) * cosf(elevation);
+        CalcAmbiSpreadNorms(spread, mNorms[idx]);
+        return mCoeffs[idx];
+    }
+
+    /* Adds dry path gains to compute from the given coefficients, the same as
+     * ComputePanGains with the device's dry mix.
+     */
+    void addDryGains(const ALfloat *coeffs, ALfloat ingain,
+                     ALfloat (&gains)[MAX_OUTPUT_CHANNELS]) noexcept
+    { mDryTargets[mNumDryTargets++] = PanGainTarget{coeffs, ingain, &gains}; }
+
+    /* Adds effect slot gains to compute from the given coefficients. */
+    void addSendGains(const ALeffectslot *slot, const ALfloat *coeffs, ALfloat ingain,
+                      ALfloat (&gains)[MAX_OUTPUT_CHANNELS]) noexcept
+    {
+        mSendTargets[mNumSendTargets++] = SendTarget{slot->ChanMap, slot->NumChannels,
+            PanGainTarget{coeffs, ingain, &gains}};
+    }
+
+    /* Computes the coefficients and gains for everything pending. */
+    void flush() noexcept
+    {
+        if(mNumDirections > 0)
+            CalcAmbiCoeffsRow(mY, mZ, mX, mNorms, mCoeffs, mNumDirections);
+
+        if(mNumDryTargets > 0)
+        {
+            if(mDry->CoeffCount > 0)
+                ComputePanGainsMC(mDry->Ambi.Coeffs, mDry->NumChannels, mDry->CoeffCount,
+                                  mDryTargets, mNumDryTargets);
+            else std::for_each(mDryTargets, mDryTargets+mNumDryTargets,
+                [this](const PanGainTarget &target) noexcept -> void
+                {
+                    ComputePanningGainsBF(mDry->Ambi.Map, mDry->NumChannels, target.Coeffs,
+                                          target.InGain, *target.Gains);
+                }
+            );
+        }
+        std::for_each(mSendTargets, mSendTargets+mNumSendTargets,
+            [](const SendTarget &send) noexcept -> void
+            {
+                ComputePanningGainsBF(send.ChanMap, send.NumChannels, send.Target.Coeffs,
+                                      send.Target.InGain, *send.Target.Gains);
+            }
+        );
+
+        mNumDirections = 0;
+        mNumDryTargets = 0;
+        mNumSendTargets = 0;
+    }
+};
+
 
 void ProcessHrtf(ALCdevice *device, ALsizei SamplesToDo)
 {
@@ -190,6 +334,8 @@ void ProcessBs2b(ALCdevice *device, ALsizei SamplesToDo)
 void aluInit(void)
 {
     MixDirectHrtf = SelectHrtfMixer();
+    CalcAmbiCoeffsRow = SelectAmbiCoeffsRow();
+    ComputePanGainsMC = SelectPanGainsMC();
 }
 
 
@@ -199,6 +345,37 @@ void DeinitVoice(ALvoice *voice) noexcept
     voice->~ALvoice();
 }
 
+/* Sets up the voice's tail convolution state if the device renders with an
+ * HRTF too long to convolve directly, or releases it otherwise.
+ */
+void InitVoiceHrtfTail(ALvoice *voice, const ALCdevice *device)
+{
+    if(device->Render_Mode != HrtfRender || !device->HrtfHandle ||
+       device->HrtfHandle->irSize <= HRIR_LENGTH)
+    {
+        al::vector<HrtfTailState,16>{}.swap(voice->HrtfTail);
+        return;
+    }
+
+    /* Enough partitions for the HRIR with the largest delay, not counting the
+     * directly convolved head.
+     */
+    const ALsizei irsize{device->HrtfHandle->irSize + HRTF_HISTORY_LENGTH-1};
+    const ALsizei num_parts{(irsize+HRTF_PART_SIZE-1)/HRTF_PART_SIZE - 1};
+
+    voice->HrtfTail.resize(voice->NumChannels);
+    for(HrtfTailState &tail : voice->HrtfTail)
+    {
+        tail.NumParts = num_parts;
+        tail.Current = 0;
+        tail.Pending = false;
+        tail.Fade = 0;
+        std::fill_n(&tail.Filters[0].Parts[0][0][0], HRTF_MAX_TAIL_PARTS*HRTF_PART_BINS*2,
+                    std::complex<float>{});
+        tail.clear();
+    }
+}
+
 
 void aluSelectPostProcess(ALCdevice *device)
 {
@@ -287,6 +464,19 @@ alu::Vector operator*(const alu::Matrix &mtx, const alu::Vector &vec) noexcept
 }
 
 
+void SendBufferCompletedEvent(ALCcontext *context, ALuint id, ALsizei count)
+{
+    ALbitfieldSOFT enabledevt{context->EnabledEvts.load(std::memory_order_acquire)};
+    if(!(enabledevt&EventType_BufferCompleted)) return;
+
+    AsyncEvent evt{EventType_BufferCompleted};
+    evt.u.bufcomp.id = id;
+    evt.u.bufcomp.count = count;
+
+    if(ll_ringbuffer_write(context->AsyncEvents, &evt, 1) == 1)
+        context->EventSem.post();
+}
+
 void SendSourceStoppedEvent(ALCcontext *context, ALuint id)
 {
     ALbitfieldSOFT enabledevt{context->EnabledEvts.load(std::memory_order_acquire)};
@@ -477,13 +667,21 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                            const ALfloat *WetGainLF, const ALfloat *WetGainHF,
                            ALeffectslot **SendSlots, const ALbuffer *Buffer,
                            const ALvoicePropsBase *props, const ALlistener &Listener,
-                           const ALCdevice *Device)
+                           const ALCdevice *Device, PanningBatch &Batch)
 {
     ChanMap StereoMap[2]{
         { FrontLeft,  DEG2RAD(-30.0f), DEG2RAD(0.0f) },
         { FrontRight, DEG2RAD( 30.0f), DEG2RAD(0.0f) }
     };
 
+    /* The voice scheduler ranks voices by their loudest output path. */
+    voice->State->Audibility = DryGain;
+    for(ALsizei i{0};i < Device->NumAuxSends;i++)
+    {
+        if(SendSlots[i])
+            voice->State->Audibility = maxf(voice->State->Audibility, WetGain[i]);
+    }
+
     bool DirectChannels{props->DirectChannels != AL_FALSE};
     const ChanMap *chans{nullptr};
     ALsizei num_channels{0};
@@ -562,6 +760,7 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
         }
     );
     const ALsizei NumSends{Device->NumAuxSends};
+    Batch.reserve(num_channels, num_channels, num_channels*NumSends);
     std::for_each(voice->Send+0, voice->Send+NumSends,
         [num_channels](ALvoice::SendData &send) -> void
         {
@@ -571,7 +770,7 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
         }
     );
 
-    voice->Flags &= ~(VOICE_HAS_HRTF | VOICE_HAS_NFC);
+    voice->State->Flags &= ~(VOICE_HAS_HRTF | VOICE_HAS_NFC);
     if(isbformat)
     {
         /* Special handling for B-Format sources. */
@@ -601,26 +800,24 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                 std::copy(std::begin(Device->NumChannelsPerOrder),
                           std::end(Device->NumChannelsPerOrder),
                           std::begin(voice->Direct.ChannelsPerOrder));
-                voice->Flags |= VOICE_HAS_NFC;
+                voice->State->Flags |= VOICE_HAS_NFC;
             }
 
             /* A scalar of 1.5 for plain stereo results in +/-60 degrees being
              * moved to +/-90 degrees for direct right and left speaker
              * responses.
              */
-            ALfloat coeffs[MAX_AMBI_COEFFS];
-            CalcAngleCoeffs((Device->Render_Mode==StereoPair) ? ScaleAzimuthFront(Azi, 1.5f) : Azi,
-                            Elev, Spread, coeffs);
+            const ALfloat *coeffs{Batch.addDirection(
+                (Device->Render_Mode==StereoPair) ? ScaleAzimuthFront(Azi, 1.5f) : Azi,
+                Elev, Spread)};
 
             /* NOTE: W needs to be scaled by sqrt(2) due to FuMa normalization. */
-            ComputePanGains(&Device->Dry, coeffs, DryGain*SQRTF_2,
-                voice->Direct.Params[0].Gains.Target);
+            Batch.addDryGains(coeffs, DryGain*SQRTF_2, voice->Direct.Params[0].Gains.Target);
             for(ALsizei i{0};i < NumSends;i++)
             {
                 if(const ALeffectslot *Slot{SendSlots[i]})
-                    ComputePanningGainsBF(Slot->ChanMap, Slot->NumChannels, coeffs,
-                        WetGain[i]*SQRTF_2, voice->Send[i].Params[0].Gains.Target
-                    );
+                    Batch.addSendGains(Slot, coeffs, WetGain[i]*SQRTF_2,
+                        voice->Send[i].Params[0].Gains.Target);
             }
         }
         else
@@ -637,7 +834,7 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                 voice->Direct.ChannelsPerOrder[1] = mini(voice->Direct.Channels-1, 3);
                 std::fill(std::begin(voice->Direct.ChannelsPerOrder)+2,
                           std::end(voice->Direct.ChannelsPerOrder), 0);
-                voice->Flags |= VOICE_HAS_NFC;
+                voice->State->Flags |= VOICE_HAS_NFC;
             }
 
             /* Local B-Format sources have their XYZ channels rotated according
@@ -705,15 +902,13 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
          */
         for(ALsizei c{0};c < num_channels;c++)
         {
-            ALfloat coeffs[MAX_AMBI_COEFFS];
-            CalcAngleCoeffs(chans[c].angle, chans[c].elevation, 0.0f, coeffs);
+            const ALfloat *coeffs{Batch.addDirection(chans[c].angle, chans[c].elevation, 0.0f)};
 
             for(ALsizei i{0};i < NumSends;i++)
             {
                 if(const ALeffectslot *Slot{SendSlots[i]})
-                    ComputePanningGainsBF(Slot->ChanMap, Slot->NumChannels, coeffs,
-                        WetGain[i], voice->Send[i].Params[c].Gains.Target
-                    );
+                    Batch.addSendGains(Slot, coeffs, WetGain[i],
+                        voice->Send[i].Params[c].Gains.Target);
             }
         }
     }
@@ -725,29 +920,61 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
         voice->Direct.Buffer = Device->RealOut.Buffer;
         voice->Direct.Channels = Device->RealOut.NumChannels;
 
+        auto get_tail = [voice](ALsizei c) noexcept -> HrtfTailState*
+        {
+            if(static_cast<size_t>(c) >= voice->HrtfTail.size())
+                return nullptr;
+            return &voice->HrtfTail[c];
+        };
+        auto get_hrtf_coeffs = [Device,voice,Spread,&get_tail](ALsizei c, ALfloat elev,
+            ALfloat azi) -> void
+        {
+            HrtfParams &target = voice->Direct.Params[c].Hrtf.Target;
+            const ALsizei irsize{Device->HrtfHandle->irSize};
+            if(irsize <= HRIR_LENGTH)
+            {
+                GetHrtfCoeffs(Device->HrtfHandle, elev, azi, Spread, target.Coeffs,
+                              target.Delay);
+                return;
+            }
+
+            /* Long HRIRs are split into a directly convolved head and a tail
+             * that's convolved in the frequency domain.
+             */
+            alignas(16) ALfloat coeffs[HRIR_MAX_LENGTH][2];
+            ALsizei delays[2];
+            GetHrtfCoeffs(Device->HrtfHandle, elev, azi, Spread, coeffs, delays);
+            SplitHrtfCoeffs(coeffs, delays, irsize, &target, get_tail(c));
+        };
+
         if(Distance > FLT_EPSILON)
         {
             /* Get the HRIR coefficients and delays just once, for the given
              * source direction.
              */
-            GetHrtfCoeffs(Device->HrtfHandle, Elev, Azi, Spread,
-                          voice->Direct.Params[0].Hrtf.Target.Coeffs,
-                          voice->Direct.Params[0].Hrtf.Target.Delay);
+            get_hrtf_coeffs(0, Elev, Azi);
             voice->Direct.Params[0].Hrtf.Target.Gain = DryGain * downmix_gain;
 
             /* Remaining channels use the same results as the first. */
+            const HrtfTailState *tail0{get_tail(0)};
             for(ALsizei c{1};c < num_channels;c++)
             {
                 /* Skip LFE */
-                if(chans[c].channel != LFE)
-                    voice->Direct.Params[c].Hrtf.Target = voice->Direct.Params[0].Hrtf.Target;
+                if(chans[c].channel == LFE)
+                    continue;
+                voice->Direct.Params[c].Hrtf.Target = voice->Direct.Params[0].Hrtf.Target;
+                if(HrtfTailState *tail{tail0 ? get_tail(c) : nullptr})
+                {
+                    tail->Filters[tail->Current^1] = tail0->Filters[tail0->Current^1];
+                    tail->Fade = 0;
+                    tail->Pending = true;
+                }
             }
 
             /* Calculate the directional coefficients once, which apply to all
              * input channels of the source sends.
              */
-            ALfloat coeffs[MAX_AMBI_COEFFS];
-            CalcAngleCoeffs(Azi, Elev, Spread, coeffs);
+            const ALfloat *coeffs{Batch.addDirection(Azi, Elev, Spread)};
 
             for(ALsizei i{0};i < NumSends;i++)
             {
@@ -756,9 +983,8 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                     {
                         /* Skip LFE */
                         if(chans[c].channel != LFE)
-                            ComputePanningGainsBF(Slot->ChanMap, Slot->NumChannels, coeffs,
-                                WetGain[i]*downmix_gain, voice->Send[i].Params[c].Gains.Target
-                            );
+                            Batch.addSendGains(Slot, coeffs, WetGain[i]*downmix_gain,
+                                voice->Send[i].Params[c].Gains.Target);
                     }
             }
         }
@@ -777,28 +1003,23 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                 /* Get the HRIR coefficients and delays for this channel
                  * position.
                  */
-                GetHrtfCoeffs(Device->HrtfHandle,
-                    chans[c].elevation, chans[c].angle, Spread,
-                    voice->Direct.Params[c].Hrtf.Target.Coeffs,
-                    voice->Direct.Params[c].Hrtf.Target.Delay
-                );
+                get_hrtf_coeffs(c, chans[c].elevation, chans[c].angle);
                 voice->Direct.Params[c].Hrtf.Target.Gain = DryGain;
 
                 /* Normal panning for auxiliary sends. */
-                ALfloat coeffs[MAX_AMBI_COEFFS];
-                CalcAngleCoeffs(chans[c].angle, chans[c].elevation, Spread, coeffs);
+                const ALfloat *coeffs{Batch.addDirection(chans[c].angle, chans[c].elevation,
+                    Spread)};
 
                 for(ALsizei i{0};i < NumSends;i++)
                 {
                     if(const ALeffectslot *Slot{SendSlots[i]})
-                        ComputePanningGainsBF(Slot->ChanMap, Slot->NumChannels, coeffs,
-                            WetGain[i], voice->Send[i].Params[c].Gains.Target
-                        );
+                        Batch.addSendGains(Slot, coeffs, WetGain[i],
+                            voice->Send[i].Params[c].Gains.Target);
                 }
             }
         }
 
-        voice->Flags |= VOICE_HAS_HRTF;
+        voice->State->Flags |= VOICE_HAS_HRTF;
     }
     else
     {
@@ -826,15 +1047,15 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                 std::copy(std::begin(Device->NumChannelsPerOrder),
                     std::end(Device->NumChannelsPerOrder),
                     std::begin(voice->Direct.ChannelsPerOrder));
-                voice->Flags |= VOICE_HAS_NFC;
+                voice->State->Flags |= VOICE_HAS_NFC;
             }
 
             /* Calculate the directional coefficients once, which apply to all
              * input channels.
              */
-            ALfloat coeffs[MAX_AMBI_COEFFS];
-            CalcAngleCoeffs((Device->Render_Mode==StereoPair) ? ScaleAzimuthFront(Azi, 1.5f) : Azi,
-                            Elev, Spread, coeffs);
+            const ALfloat *coeffs{Batch.addDirection(
+                (Device->Render_Mode==StereoPair) ? ScaleAzimuthFront(Azi, 1.5f) : Azi,
+                Elev, Spread)};
 
             for(ALsizei c{0};c < num_channels;c++)
             {
@@ -849,8 +1070,8 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                     continue;
                 }
 
-                ComputePanGains(&Device->Dry, coeffs, DryGain * downmix_gain,
-                                voice->Direct.Params[c].Gains.Target);
+                Batch.addDryGains(coeffs, DryGain * downmix_gain,
+                                  voice->Direct.Params[c].Gains.Target);
             }
 
             for(ALsizei i{0};i < NumSends;i++)
@@ -860,9 +1081,8 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                     {
                         /* Skip LFE */
                         if(chans[c].channel != LFE)
-                            ComputePanningGainsBF(Slot->ChanMap, Slot->NumChannels, coeffs,
-                                WetGain[i]*downmix_gain, voice->Send[i].Params[c].Gains.Target
-                            );
+                            Batch.addSendGains(Slot, coeffs, WetGain[i]*downmix_gain,
+                                voice->Send[i].Params[c].Gains.Target);
                     }
             }
         }
@@ -884,7 +1104,7 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                 std::copy(std::begin(Device->NumChannelsPerOrder),
                     std::end(Device->NumChannelsPerOrder),
                     std::begin(voice->Direct.ChannelsPerOrder));
-                voice->Flags |= VOICE_HAS_NFC;
+                voice->State->Flags |= VOICE_HAS_NFC;
             }
 
             for(ALsizei c{0};c < num_channels;c++)
@@ -900,21 +1120,17 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
                     continue;
                 }
 
-                ALfloat coeffs[MAX_AMBI_COEFFS];
-                CalcAngleCoeffs(
+                const ALfloat *coeffs{Batch.addDirection(
                     (Device->Render_Mode==StereoPair) ? ScaleAzimuthFront(chans[c].angle, 3.0f)
                                                       : chans[c].angle,
-                    chans[c].elevation, Spread, coeffs
-                );
+                    chans[c].elevation, Spread)};
 
-                ComputePanGains(&Device->Dry, coeffs, DryGain,
-                    voice->Direct.Params[c].Gains.Target);
+                Batch.addDryGains(coeffs, DryGain, voice->Direct.Params[c].Gains.Target);
                 for(ALsizei i{0};i < NumSends;i++)
                 {
                     if(const ALeffectslot *Slot{SendSlots[i]})
-                        ComputePanningGainsBF(Slot->ChanMap, Slot->NumChannels,
-                            coeffs, WetGain[i], voice->Send[i].Params[c].Gains.Target
-                        );
+                        Batch.addSendGains(Slot, coeffs, WetGain[i],
+                            voice->Send[i].Params[c].Gains.Target);
                 }
             }
         }
@@ -966,7 +1182,7 @@ void CalcPanningAndFilters(ALvoice *voice, const ALfloat Azi, const ALfloat Elev
     }
 }
 
-void CalcNonAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const ALbuffer *ALBuffer, const ALCcontext *ALContext)
+void CalcNonAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const ALbuffer *ALBuffer, const ALCcontext *ALContext, PanningBatch &Batch)
 {
     const ALCdevice *Device{ALContext->Device};
     ALeffectslot *SendSlots[MAX_SENDS];
@@ -981,11 +1197,13 @@ void CalcNonAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, cons
         if(!SendSlots[i] || SendSlots[i]->Params.EffectType == AL_EFFECT_NULL)
         {
             SendSlots[i] = NULL;
+            voice->Send[i].Slot = NULL;
             voice->Send[i].Buffer = NULL;
             voice->Send[i].Channels = 0;
         }
         else
         {
+            voice->Send[i].Slot = SendSlots[i];
             voice->Send[i].Buffer = SendSlots[i]->WetBuffer;
             voice->Send[i].Channels = SendSlots[i]->NumChannels;
         }
@@ -995,13 +1213,13 @@ void CalcNonAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, cons
     const auto Pitch = static_cast<ALfloat>(ALBuffer->Frequency) /
         static_cast<ALfloat>(Device->Frequency) * props->Pitch;
     if(Pitch > (ALfloat)MAX_PITCH)
-        voice->Step = MAX_PITCH<<FRACTIONBITS;
+        voice->State->Step = MAX_PITCH<<FRACTIONBITS;
     else
-        voice->Step = maxi(fastf2i(Pitch * FRACTIONONE), 1);
+        voice->State->Step = maxi(fastf2i(Pitch * FRACTIONONE), 1);
     if(props->Resampler == BSinc24Resampler)
-        BsincPrepare(voice->Step, &voice->ResampleState.bsinc, &bsinc24);
+        BsincPrepare(voice->State->Step, &voice->ResampleState.bsinc, &bsinc24);
     else if(props->Resampler == BSinc12Resampler)
-        BsincPrepare(voice->Step, &voice->ResampleState.bsinc, &bsinc12);
+        BsincPrepare(voice->State->Step, &voice->ResampleState.bsinc, &bsinc12);
     voice->Resampler = SelectResampler(props->Resampler);
 
     /* Calculate gains */
@@ -1022,10 +1240,10 @@ void CalcNonAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, cons
     }
 
     CalcPanningAndFilters(voice, 0.0f, 0.0f, 0.0f, 0.0f, DryGain, DryGainHF, DryGainLF, WetGain,
-                          WetGainLF, WetGainHF, SendSlots, ALBuffer, props, Listener, Device);
+                          WetGainLF, WetGainHF, SendSlots, ALBuffer, props, Listener, Device, Batch);
 }
 
-void CalcAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const ALbuffer *ALBuffer, const ALCcontext *ALContext)
+void CalcAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const ALbuffer *ALBuffer, const ALCcontext *ALContext, PanningBatch &Batch)
 {
     const ALCdevice *Device{ALContext->Device};
     const ALsizei NumSends{Device->NumAuxSends};
@@ -1089,11 +1307,13 @@ void CalcAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const A
 
         if(!SendSlots[i])
         {
+            voice->Send[i].Slot = nullptr;
             voice->Send[i].Buffer = nullptr;
             voice->Send[i].Channels = 0;
         }
         else
         {
+            voice->Send[i].Slot = SendSlots[i];
             voice->Send[i].Buffer = SendSlots[i]->WetBuffer;
             voice->Send[i].Channels = SendSlots[i]->NumChannels;
         }
@@ -1333,13 +1553,13 @@ void CalcAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const A
      */
     Pitch *= (ALfloat)ALBuffer->Frequency/(ALfloat)Device->Frequency;
     if(Pitch > (ALfloat)MAX_PITCH)
-        voice->Step = MAX_PITCH<<FRACTIONBITS;
+        voice->State->Step = MAX_PITCH<<FRACTIONBITS;
     else
-        voice->Step = maxi(fastf2i(Pitch * FRACTIONONE), 1);
+        voice->State->Step = maxi(fastf2i(Pitch * FRACTIONONE), 1);
     if(props->Resampler == BSinc24Resampler)
-        BsincPrepare(voice->Step, &voice->ResampleState.bsinc, &bsinc24);
+        BsincPrepare(voice->State->Step, &voice->ResampleState.bsinc, &bsinc24);
     else if(props->Resampler == BSinc12Resampler)
-        BsincPrepare(voice->Step, &voice->ResampleState.bsinc, &bsinc12);
+        BsincPrepare(voice->State->Step, &voice->ResampleState.bsinc, &bsinc12);
     voice->Resampler = SelectResampler(props->Resampler);
 
     ALfloat ev{0.0f}, az{0.0f};
@@ -1363,10 +1583,10 @@ void CalcAttnSourceParams(ALvoice *voice, const ALvoicePropsBase *props, const A
         spread = std::asin(props->Radius/Distance) * 2.0f;
 
     CalcPanningAndFilters(voice, az, ev, Distance, spread, DryGain, DryGainHF, DryGainLF, WetGain,
-                          WetGainLF, WetGainHF, SendSlots, ALBuffer, props, Listener, Device);
+                          WetGainLF, WetGainHF, SendSlots, ALBuffer, props, Listener, Device, Batch);
 }
 
-void CalcSourceParams(ALvoice *voice, ALCcontext *context, bool force)
+void CalcSourceParams(ALvoice *voice, ALCcontext *context, PanningBatch &batch, bool force)
 {
     ALvoiceProps *props{voice->Update.exchange(nullptr, std::memory_order_acq_rel)};
     if(!props && !force) return;
@@ -1374,6 +1594,7 @@ void CalcSourceParams(ALvoice *voice, ALCcontext *context, bool force)
     if(props)
     {
         voice->Props = *props;
+        voice->State->Priority = props->Priority;
 
         AtomicReplaceHead(context->FreeVoiceProps, props);
     }
@@ -1390,9 +1611,9 @@ void CalcSourceParams(ALvoice *voice, ALCcontext *context, bool force)
         {
             if(voice->Props.SpatializeMode==SpatializeOn ||
                (voice->Props.SpatializeMode==SpatializeAuto && (*buffer)->FmtChannels==FmtMono))
-                CalcAttnSourceParams(voice, &voice->Props, *buffer, context);
+                CalcAttnSourceParams(voice, &voice->Props, *buffer, context, batch);
             else
-                CalcNonAttnSourceParams(voice, &voice->Props, *buffer, context);
+                CalcNonAttnSourceParams(voice, &voice->Props, *buffer, context, batch);
             break;
         }
         BufferListItem = BufferListItem->next.load(std::memory_order_acquire);
@@ -1412,61 +1633,409 @@ void ProcessParamUpdates(ALCcontext *ctx, const ALeffectslotArray *slots)
             { force |= CalcEffectSlotParams(slot, ctx, cforce); }
         );
 
-        std::for_each(ctx->Voices, ctx->Voices+ctx->VoiceCount.load(std::memory_order_acquire),
-            [ctx,force](ALvoice *voice) -> void
-            {
-                ALuint sid{voice->SourceID.load(std::memory_order_acquire)};
-                if(sid) CalcSourceParams(voice, ctx, force);
-            }
-        );
+        /* The voices' panning gains are computed together once they've all
+         * been updated.
+         */
+        PanningBatch batch{&ctx->Device->Dry};
+        const ALsizei voicecount{ctx->VoiceCount.load(std::memory_order_acquire)};
+        for(ALsizei i{0};i < voicecount;i++)
+        {
+            if(ctx->VoiceStates[i].SourceID.load(std::memory_order_acquire))
+                CalcSourceParams(ctx->Voices[i], ctx, batch, force);
+        }
+        batch.flush();
     }
     IncrementRef(&ctx->UpdateCount);
 }
 
-void ProcessContext(ALCcontext *ctx, ALsizei SamplesToDo)
+/* Number of active voices handed to a mixer thread at a time. */
+constexpr ALsizei VOICES_PER_MIX_JOB{16};
+
+/* Mixes the context's given voice on the calling mixer thread, sending its
+ * events directly.
+ */
+void MixVoice(ALCcontext *ctx, const ALsizei idx, const ALsizei SamplesToDo)
 {
-    const ALeffectslotArray *auxslots{ctx->ActiveAuxSlots.load(std::memory_order_acquire)};
+    ALvoiceState &state = ctx->VoiceStates[idx];
+    const ALuint sid{state.SourceID.load(std::memory_order_relaxed)};
+
+    ALsizei buffers_done{0};
+    ALboolean playing{MixSource(ctx->Voices[idx], ctx, ctx->Device->MixScratch.get(),
+        &buffers_done, SamplesToDo)};
+    if(buffers_done > 0)
+        SendBufferCompletedEvent(ctx, sid, buffers_done);
+    if(!playing)
+    {
+        state.SourceID.store(0u, std::memory_order_relaxed);
+        state.Playing.store(false, std::memory_order_release);
+        SendSourceStoppedEvent(ctx, sid);
+    }
+}
 
-    /* Process pending propery updates for objects on the context. */
-    ProcessParamUpdates(ctx, auxslots);
+/* Mixes a voice on a helper thread of the mixer pool. The voice's target
+ * buffers are temporarily redirected to the thread's private copies, and any
+ * events are stored to be sent once all threads are done.
+ */
+void MixVoiceThreaded(ALvoice *voice, ALCcontext *ctx, MixThreadState *thrd,
+                      const ALeffectslotArray *auxslots, ALsizei SamplesToDo)
+{
+    ALCdevice *device{ctx->Device};
+    const ALsizei num_sends{device->NumAuxSends};
 
-    /* Clear auxiliary effect slot mixing buffers. */
-    std::for_each(auxslots->slot, auxslots->slot+auxslots->count,
-        [SamplesToDo](ALeffectslot *slot) -> void
+    if(!thrd->Mixed)
+    {
+        /* Clear the private mixing buffers on first use. */
+        auto clear_buffer = [SamplesToDo](std::array<ALfloat,BUFFERSIZE> &buffer) -> void
+        { std::fill_n(buffer.begin(), SamplesToDo, 0.0f); };
+        std::for_each(thrd->MixBuffer.begin(), thrd->MixBuffer.end(), clear_buffer);
+        std::for_each(thrd->WetBuffer.begin(),
+            thrd->WetBuffer.begin() + auxslots->count*MAX_EFFECT_CHANNELS, clear_buffer);
+        thrd->Mixed = true;
+    }
+
+    /* All device mixing buffers are allocated together, so a voice's direct
+     * output can be redirected by its offset from the start.
+     */
+    ALfloat (*mixbuf)[BUFFERSIZE]{&reinterpret_cast<ALfloat(&)[BUFFERSIZE]>(thrd->MixBuffer[0])};
+    ALfloat (*wetbuf)[BUFFERSIZE]{&reinterpret_cast<ALfloat(&)[BUFFERSIZE]>(thrd->WetBuffer[0])};
+
+    ALfloat (*olddirect)[BUFFERSIZE]{voice->Direct.Buffer};
+    ALfloat (*oldsends[MAX_SENDS])[BUFFERSIZE];
+    voice->Direct.Buffer = mixbuf + (olddirect - device->Dry.Buffer);
+    for(ALsizei i{0};i < num_sends;i++)
+    {
+        ALvoice::SendData &send = voice->Send[i];
+        oldsends[i] = send.Buffer;
+        if(!send.Buffer) continue;
+
+        auto slot = std::find_if(auxslots->slot, auxslots->slot+auxslots->count,
+            [&send](const ALeffectslot *slot) noexcept -> bool
+            { return slot->WetBuffer == send.Buffer; }
+        );
+        if(slot == auxslots->slot+auxslots->count)
+            send.Buffer = nullptr;
+        else
+            send.Buffer = wetbuf + std::distance(auxslots->slot, slot)*MAX_EFFECT_CHANNELS;
+    }
+
+    ALuint sid{voice->State->SourceID.load(std::memory_order_relaxed)};
+    ALsizei buffers_done{0};
+    ALboolean playing{MixSource(voice, ctx, &thrd->Scratch, &buffers_done, SamplesToDo)};
+
+    voice->Direct.Buffer = olddirect;
+    for(ALsizei i{0};i < num_sends;i++)
+        voice->Send[i].Buffer = oldsends[i];
+
+    if(!playing)
+    {
+        voice->State->SourceID.store(0u, std::memory_order_relaxed);
+        voice->State->Playing.store(false, std::memory_order_release);
+    }
+    if(buffers_done > 0 || !playing)
+        thrd->Events.emplace_back(MixThreadState::VoiceEvent{sid, buffers_done, !playing});
+}
+
+void ProcessVoicesThreaded(ALCcontext *ctx, const ALeffectslotArray *auxslots,
+                           const ALsizei SamplesToDo)
+{
+    ALCdevice *device{ctx->Device};
+
+    /* Make sure each helper has room for the active effect slots. This only
+     * grows when more slots become active than the helpers have seen.
+     */
+    const size_t wetchans{static_cast<size_t>(auxslots->count) * MAX_EFFECT_CHANNELS};
+    std::for_each(device->MixThreadStates.begin(), device->MixThreadStates.end(),
+        [wetchans](std::unique_ptr<MixThreadState> &thrd) -> void
         {
-            std::for_each(slot->WetBuffer, slot->WetBuffer+slot->NumChannels,
-                [SamplesToDo](ALfloat *buffer) -> void
-                { std::fill_n(buffer, SamplesToDo, 0.0f); }
-            );
+            if(thrd->WetBuffer.size() < wetchans)
+                thrd->WetBuffer.resize(wetchans);
+            thrd->Events.clear();
+            thrd->Mixed = false;
         }
     );
 
-    /* Process voices that have a playing source. */
-    std::for_each(ctx->Voices, ctx->Voices+ctx->VoiceCount.load(std::memory_order_acquire),
-        [SamplesToDo,ctx](ALvoice *voice) -> void
+    /* Thread 0 is the calling mixer thread, which mixes directly into the
+     * real buffers. The helper threads mix into their own copies.
+     */
+    const ALsizei numactive{static_cast<ALsizei>(ctx->ActiveVoices.size())};
+    auto mix_job = [ctx,device,auxslots,numactive,SamplesToDo](size_t thread, ALsizei job) -> void
+    {
+        auto idx = ctx->ActiveVoices.cbegin() + job*VOICES_PER_MIX_JOB;
+        auto idx_end = ctx->ActiveVoices.cbegin() + mini((job+1)*VOICES_PER_MIX_JOB, numactive);
+        MixThreadState *thrd{thread ? device->MixThreadStates[thread-1].get() : nullptr};
+        for(;idx != idx_end;++idx)
         {
-            if(!voice->Playing.load(std::memory_order_acquire)) return;
-            ALuint sid{voice->SourceID.load(std::memory_order_relaxed)};
-            if(!sid || voice->Step < 1) return;
+            if(thrd)
+                MixVoiceThreaded(ctx->Voices[*idx], ctx, thrd, auxslots, SamplesToDo);
+            else
+                MixVoice(ctx, *idx, SamplesToDo);
+        }
+    };
+    device->MixThreads->run((numactive+VOICES_PER_MIX_JOB-1) / VOICES_PER_MIX_JOB, mix_job);
 
-            if(!MixSource(voice, sid, ctx, SamplesToDo))
+    /* Sum the helpers' output back into the device and wet buffers, and send
+     * the events they collected.
+     */
+    const auto add_buffer = [SamplesToDo](ALfloat *RESTRICT dst, const ALfloat *RESTRICT src) -> void
+    {
+        ASSUME(SamplesToDo > 0);
+        for(ALsizei i{0};i < SamplesToDo;i++)
+            dst[i] += src[i];
+    };
+    std::for_each(device->MixThreadStates.begin(), device->MixThreadStates.end(),
+        [ctx,device,auxslots,&add_buffer](std::unique_ptr<MixThreadState> &thrd) -> void
+        {
+            if(!thrd->Mixed) return;
+
+            for(size_t c{0};c < device->MixBuffer.size();c++)
+                add_buffer(device->MixBuffer[c].data(), thrd->MixBuffer[c].data());
+            for(ALsizei s{0};s < auxslots->count;s++)
             {
-                voice->SourceID.store(0u, std::memory_order_relaxed);
-                voice->Playing.store(false, std::memory_order_release);
-                SendSourceStoppedEvent(ctx, sid);
+                ALeffectslot *slot{auxslots->slot[s]};
+                for(ALsizei c{0};c < slot->NumChannels;c++)
+                    add_buffer(slot->WetBuffer[c],
+                               thrd->WetBuffer[s*MAX_EFFECT_CHANNELS + c].data());
+            }
+
+            for(const MixThreadState::VoiceEvent &evt : thrd->Events)
+            {
+                if(evt.BuffersDone > 0)
+                    SendBufferCompletedEvent(ctx, evt.SourceID, evt.BuffersDone);
+                if(evt.Stopped)
+                    SendSourceStoppedEvent(ctx, evt.SourceID);
             }
         }
     );
+}
 
-    /* Process effects. */
-    std::for_each(auxslots->slot, auxslots->slot+auxslots->count,
-        [SamplesToDo](const ALeffectslot *slot) -> void
+/* Checks if an effect slot needs processing this update. A slot that nothing
+ * was mixed into keeps running until its effect's tail has played out, after
+ * which it's skipped until it gets fed again.
+ */
+bool PrepareEffectSlot(ALeffectslot *slot, const ALsizei SamplesToDo)
+{
+    EffectState *state{slot->Params.mEffectState};
+    if(slot->WetFed.exchange(false, std::memory_order_relaxed))
+    {
+        slot->WetSamples = maxi(slot->WetSamples, SamplesToDo);
+        state->mTailLeft = state->mTailLength;
+    }
+    else if(state->mTailLength >= 0)
+    {
+        if(state->mTailLeft <= 0)
+        {
+            state->skip(SamplesToDo);
+            return false;
+        }
+        state->mTailLeft -= mini(state->mTailLeft, SamplesToDo);
+    }
+    return true;
+}
+
+/* Processes the effect slots across the mixer pool, one slot per job. Slots
+ * processed on a helper thread render into the thread's copy of the device
+ * mixing buffers, which are summed back into the real ones afterward.
+ */
+void ProcessEffectsThreaded(ALCcontext *ctx, const ALeffectslotArray *auxslots,
+                            const ALsizei SamplesToDo)
+{
+    ALCdevice *device{ctx->Device};
+
+    std::for_each(device->MixThreadStates.begin(), device->MixThreadStates.end(),
+        [](std::unique_ptr<MixThreadState> &thrd) -> void
+        { thrd->EffectChans[0] = thrd->EffectChans[1] = 0; }
+    );
+
+    auto fx_job = [device,auxslots,SamplesToDo](size_t thread, ALsizei job) -> void
+    {
+        ALeffectslot *slot{auxslots->slot[job]};
+        if(!PrepareEffectSlot(slot, SamplesToDo))
+            return;
+
+        EffectState *state{slot->Params.mEffectState};
+        if(!thread)
         {
-            EffectState *state{slot->Params.mEffectState};
             state->process(SamplesToDo, slot->WetBuffer, state->mOutBuffer,
                            state->mOutChannels);
+            return;
+        }
+
+        /* All device mixing buffers are allocated together, so the effect's
+         * output can be redirected by its offset from the start. Channels
+         * are cleared as the range this thread writes to grows.
+         */
+        MixThreadState *thrd{device->MixThreadStates[thread-1].get()};
+        const auto first = static_cast<ALsizei>(state->mOutBuffer - device->Dry.Buffer);
+        const ALsizei last{first + state->mOutChannels};
+        auto clear_chans = [thrd,SamplesToDo](ALsizei begin, ALsizei end) -> void
+        {
+            for(;begin < end;++begin)
+                std::fill_n(thrd->MixBuffer[begin].begin(), SamplesToDo, 0.0f);
+        };
+        ALsizei (&chans)[2] = thrd->EffectChans;
+        if(chans[0] == chans[1])
+        {
+            clear_chans(first, last);
+            chans[0] = first;
+            chans[1] = last;
+        }
+        else
+        {
+            clear_chans(mini(first, chans[0]), chans[0]);
+            clear_chans(chans[1], maxi(last, chans[1]));
+            chans[0] = mini(first, chans[0]);
+            chans[1] = maxi(last, chans[1]);
+        }
+
+        ALfloat (*mixbuf)[BUFFERSIZE]{&reinterpret_cast<ALfloat(&)[BUFFERSIZE]>(thrd->MixBuffer[0])};
+        state->process(SamplesToDo, slot->WetBuffer, mixbuf + first, state->mOutChannels);
+    };
+    device->MixThreads->run(auxslots->count, fx_job);
+
+    /* Sum the helpers' effect output back into the device buffers. */
+    static constexpr ALfloat unity_gain{1.0f};
+    std::for_each(device->MixThreadStates.begin(), device->MixThreadStates.end(),
+        [device,SamplesToDo](std::unique_ptr<MixThreadState> &thrd) -> void
+        {
+            ALfloat (*mixbuf)[BUFFERSIZE]{&reinterpret_cast<ALfloat(&)[BUFFERSIZE]>(thrd->MixBuffer[0])};
+            for(ALsizei c{thrd->EffectChans[0]};c < thrd->EffectChans[1];c++)
+                MixRowSamples(device->Dry.Buffer[c], &unity_gain, mixbuf+c, 1, 0, SamplesToDo);
+        }
+    );
+}
+
+/* Ranks the active voices by priority, then audibility, and marks the ones
+ * past the context's voice limit, or that don't fit in its mix budget, to be
+ * culled for this update. Returns the number of voices left to mix.
+ */
+ALsizei ScheduleVoices(ALCcontext *ctx, const ALsizei SamplesToDo)
+{
+    /* Voices that were mixed last update get a small edge, so ones with
+     * similar audibility don't keep trading places across the cut-off.
+     */
+    static constexpr ALfloat MixedVoiceBias{1.25f};
+
+    ALCdevice *device{ctx->Device};
+    auto &ranking = ctx->VoiceRanking;
+    ranking.assign(ctx->ActiveVoices.cbegin(), ctx->ActiveVoices.cend());
+
+    ALsizei maxmixed{static_cast<ALsizei>(ranking.size())};
+    if(ctx->MaxMixedVoices > 0)
+        maxmixed = mini(maxmixed, ctx->MaxMixedVoices);
+    if(ctx->MixBudget > 0.0f && ctx->VoiceMixCost > 0.0f)
+    {
+        const ALfloat budget{static_cast<ALfloat>(SamplesToDo) * 1000000000.0f /
+            static_cast<ALfloat>(device->Frequency) * ctx->MixBudget};
+        maxmixed = mini(maxmixed, maxi(fastf2i(budget / ctx->VoiceMixCost), 1));
+    }
+
+    ALvoiceState *states{ctx->VoiceStates};
+    auto rank_greater = [states](const ALsizei lidx, const ALsizei ridx) noexcept -> bool
+    {
+        const ALvoiceState &lhs = states[lidx];
+        const ALvoiceState &rhs = states[ridx];
+        if(lhs.Priority != rhs.Priority)
+            return lhs.Priority > rhs.Priority;
+        const ALfloat lhsaud{(lhs.Flags&VOICE_IS_CULLED) ? lhs.Audibility :
+            lhs.Audibility*MixedVoiceBias};
+        const ALfloat rhsaud{(rhs.Flags&VOICE_IS_CULLED) ? rhs.Audibility :
+            rhs.Audibility*MixedVoiceBias};
+        return lhsaud > rhsaud;
+    };
+    auto cull_start = ranking.begin() + maxmixed;
+    if(cull_start != ranking.end())
+        std::nth_element(ranking.begin(), cull_start, ranking.end(), rank_greater);
+
+    std::for_each(ranking.begin(), cull_start,
+        [states](const ALsizei idx) noexcept -> void { states[idx].Flags &= ~VOICE_IS_CULLED; });
+    std::for_each(cull_start, ranking.end(),
+        [states](const ALsizei idx) noexcept -> void { states[idx].Flags |= VOICE_IS_CULLED; });
+
+    return maxmixed;
+}
+
+void ProcessContext(ALCcontext *ctx, ALsizei SamplesToDo)
+{
+    const ALeffectslotArray *auxslots{ctx->ActiveAuxSlots.load(std::memory_order_acquire)};
+
+    /* Process pending propery updates for objects on the context. */
+    ProcessParamUpdates(ctx, auxslots);
+
+    /* Clear auxiliary effect slot mixing buffers. Only the samples written
+     * since the last clear need it, so idle slots are left alone.
+     */
+    std::for_each(auxslots->slot, auxslots->slot+auxslots->count,
+        [](ALeffectslot *slot) -> void
+        {
+            const ALsizei todo{slot->WetSamples};
+            if(todo <= 0) return;
+            std::for_each(slot->WetBuffer, slot->WetBuffer+slot->NumChannels,
+                [todo](ALfloat *buffer) -> void
+                { std::fill_n(buffer, todo, 0.0f); }
+            );
+            slot->WetSamples = 0;
         }
     );
+
+    /* Find the voices that have a playing source, only looking at their
+     * packed states.
+     */
+    ALCdevice *device{ctx->Device};
+    const ALsizei voicecount{ctx->VoiceCount.load(std::memory_order_acquire)};
+    auto &active = ctx->ActiveVoices;
+    active.clear();
+    for(ALsizei i{0};i < voicecount;i++)
+    {
+        const ALvoiceState &state = ctx->VoiceStates[i];
+        if(state.Playing.load(std::memory_order_acquire) &&
+           state.SourceID.load(std::memory_order_relaxed) != 0u && state.Step > 0)
+            active.emplace_back(i);
+    }
+
+    /* Process the voices. */
+    const bool scheduled{ctx->MaxMixedVoices > 0 || ctx->MixBudget > 0.0f};
+    const ALsizei mixcount{scheduled ? ScheduleVoices(ctx, SamplesToDo) : 0};
+    if(device->mHrtfBuses)
+        UpdateHrtfBuses(ctx);
+    const auto mix_start = std::chrono::steady_clock::now();
+    if(!device->MixThreads || static_cast<ALsizei>(active.size()) <= VOICES_PER_MIX_JOB)
+        std::for_each(active.cbegin(), active.cend(),
+            [SamplesToDo,ctx](const ALsizei idx) -> void
+            { MixVoice(ctx, idx, SamplesToDo); }
+        );
+    else
+        ProcessVoicesThreaded(ctx, auxslots, SamplesToDo);
+
+    if(ctx->MixBudget > 0.0f && mixcount > 0)
+    {
+        /* Update the per-voice cost estimate the mix budget is measured
+         * against. Culled voices are cheap enough to not count.
+         */
+        const std::chrono::duration<ALfloat,std::nano> elapsed{
+            std::chrono::steady_clock::now() - mix_start};
+        const ALfloat cost{elapsed.count() / static_cast<ALfloat>(mixcount)};
+        if(ctx->VoiceMixCost > 0.0f)
+            ctx->VoiceMixCost = lerp(ctx->VoiceMixCost, cost, 0.25f);
+        else
+            ctx->VoiceMixCost = cost;
+    }
+
+    /* Process effects. */
+    if(device->ThreadedEffects && auxslots->count > 1)
+        ProcessEffectsThreaded(ctx, auxslots, SamplesToDo);
+    else
+    {
+        std::for_each(auxslots->slot, auxslots->slot+auxslots->count,
+            [SamplesToDo](ALeffectslot *slot) -> void
+            {
+                if(!PrepareEffectSlot(slot, SamplesToDo))
+                    return;
+                EffectState *state{slot->Params.mEffectState};
+                state->process(SamplesToDo, slot->WetBuffer, state->mOutBuffer,
+                               state->mOutChannels);
+            }
+        );
+    }
 }
 
 
@@ -1662,6 +2231,10 @@ void aluMixData(ALCdevice *device, ALvoid *OutBuffer, ALsizei NumSamples)
             ctx = ctx->next.load(std::memory_order_relaxed);
         }
 
+        /* Convolve the voices sharing HRTF filters. */
+        if(device->mHrtfBuses)
+            MixHrtfBuses(device, SamplesToDo);
+
         /* Increment the clock time. Every second's worth of samples is
          * converted and added to clock base so that large sample counts don't
          * overflow during conversion. This also guarantees a stable
@@ -1693,7 +2266,7 @@ void aluMixData(ALCdevice *device, ALvoid *OutBuffer, ALsizei NumSamples)
         }
 
         /* Apply delays and attenuation for mismatched speaker distances. */
-        ApplyDistanceComp(device->RealOut.Buffer, device->ChannelDelay, device->TempBuffer[0],
+        ApplyDistanceComp(device->RealOut.Buffer, device->ChannelDelay, device->TempBuffer,
                           SamplesToDo, device->RealOut.NumChannels);
 
         /* Apply compression, limiting final sample amplitude, if desired. */
@@ -1761,15 +2334,16 @@ void aluHandleDisconnect(ALCdevice *device, const char *msg, ...)
            ll_ringbuffer_write(ctx->AsyncEvents, &evt, 1) == 1)
             ctx->EventSem.post();
 
-        std::for_each(ctx->Voices, ctx->Voices+ctx->VoiceCount.load(std::memory_order_acquire),
-            [ctx](ALvoice *voice) -> void
+        std::for_each(ctx->VoiceStates,
+            ctx->VoiceStates+ctx->VoiceCount.load(std::memory_order_acquire),
+            [ctx](ALvoiceState &state) -> void
             {
-                if(!voice->Playing.load(std::memory_order_acquire)) return;
-                ALuint sid{voice->SourceID.load(std::memory_order_relaxed)};
+                if(!state.Playing.load(std::memory_order_acquire)) return;
+                ALuint sid{state.SourceID.load(std::memory_order_relaxed)};
                 if(!sid) return;
 
-                voice->SourceID.store(0u, std::memory_order_relaxed);
-                voice->Playing.store(false, std::memory_order_release);
+                state.SourceID.store(0u, std::memory_order_relaxed);
+                state.Playing.store(false, std::memory_order_release);
                 /* If the source's voice was playing, it's now effectively
                  * stopped (the source state will be updated the next time it's
                  * checked).
@@ -225,6 +225,36 @@ using ifstream = std::ifstream;
 struct PathNamePair { std::string path, fname; };
 PathNamePair GetProcBinary(void);
 
+struct FileMapping {
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE fmap;
+#else
+    int fd;
+#endif
+    void *ptr;
+    size_t len;
+};
+FileMapping MapFileToMem(const char *fname);
+void UnmapFileMem(const FileMapping *mapping);
+
+/* Gets the user's cache directory with subdir appended, creating any missing
+ * directories. Returns an empty string if it can't be found or created.
+ */
+std::string GetCachePath(const char *subdir);
+/* Creates any missing directories along the path, converting it to native
+ * separators. Returns false if one can't be created.
+ */
+bool MakeDirectories(std::string &path);
+/* Writes the data to the named file, replacing any existing file only once
+ * the whole file is written.
+ */
+bool WriteFileData(const char *fname, const void *data, size_t len);
+/* Gets the file's size and last modification time (in an unspecified unit),
+ * without reading it. Returns false if the file can't be found.
+ */
+bool GetFileStamp(const char *fname, unsigned long long *size, unsigned long long *mtime);
+
 #ifdef HAVE_DYNLOAD
 void *LoadLib(const char *name);
 void CloseLib(void *handle);
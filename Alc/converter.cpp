@@ -3,6 +3,8 @@
 
 #include "converter.h"
 
+#include <cmath>
+#include <memory>
 #include <algorithm>
 
 #include "fpu_modes.h"
@@ -341,6 +343,37 @@ ALsizei SampleConverterInput(SampleConverter *converter, const ALvoid **src, ALs
 }
 
 
+bool ResampleSamples(ALfloat *dst, ALsizei dstframes, const ALfloat *src, ALsizei srcframes,
+                     ALsizei numchans, ALsizei srcRate, ALsizei dstRate, ALsizei lead)
+{
+    std::unique_ptr<SampleConverter> converter{CreateSampleConverter(DevFmtFloat, DevFmtFloat,
+        numchans, srcRate, dstRate, BSinc24Resampler)};
+    if(!converter) return false;
+
+    /* The converter's first output sample lines up with the input after
+     * MAX_RESAMPLE_PADDING samples, so pad the front with that much silence.
+     * The end is padded with enough silence to flush out the full output.
+     */
+    const ALdouble ratio{static_cast<ALdouble>(dstRate) / srcRate};
+    const ALsizei srcLen{MAX_RESAMPLE_PADDING*3 + maxi(lead + srcframes,
+        static_cast<ALsizei>(std::ceil(dstframes / ratio)))};
+    al::vector<ALfloat,16> srcbuf(srcLen*numchans, 0.0f);
+    std::copy_n(src, srcframes*numchans, srcbuf.begin() + (MAX_RESAMPLE_PADDING+lead)*numchans);
+
+    const ALvoid *srcptr{srcbuf.data()};
+    ALsizei srcleft{srcLen};
+    ALsizei done{0};
+    while(done < dstframes && srcleft > 0)
+        done += SampleConverterInput(converter.get(), &srcptr, &srcleft, dst + done*numchans,
+                                     dstframes-done);
+    std::fill(dst + done*numchans, dst + dstframes*numchans, 0.0f);
+
+    const auto scale = static_cast<ALfloat>(1.0 / ratio);
+    std::transform(dst, dst + dstframes*numchans, dst,
+        [scale](ALfloat s) noexcept -> ALfloat { return s * scale; });
+    return true;
+}
+
 ChannelConverter *CreateChannelConverter(DevFmtType srcType, DevFmtChannels srcChans, DevFmtChannels dstChans)
 {
     if(srcChans != dstChans && !((srcChans == DevFmtMono && dstChans == DevFmtStereo) ||
@@ -37,6 +37,14 @@ void DestroySampleConverter(SampleConverter **converter);
 ALsizei SampleConverterInput(SampleConverter *converter, const ALvoid **src, ALsizei *srcframes, ALvoid *dst, ALsizei dstframes);
 ALsizei SampleConverterAvailableOut(SampleConverter *converter, ALsizei srcframes);
 
+/* Resamples a whole block of interleaved float samples with the bsinc
+ * resampler, scaled by the rate change to keep its level. The output starts
+ * lead source samples before the input does, and is silent past the end of
+ * it. Returns false if the converter can't be created.
+ */
+bool ResampleSamples(ALfloat *dst, ALsizei dstframes, const ALfloat *src, ALsizei srcframes,
+                     ALsizei numchans, ALsizei srcRate, ALsizei dstRate, ALsizei lead);
+
 
 struct ChannelConverter {
     DevFmtType mSrcType;
@@ -12,6 +12,8 @@ enum {
     CPU_CAP_SSE3   = 1<<2,
     CPU_CAP_SSE4_1 = 1<<3,
     CPU_CAP_NEON   = 1<<4,
+    CPU_CAP_AVX2   = 1<<5, /* Also implies FMA3 */
+    CPU_CAP_AVX512 = 1<<6, /* AVX-512 Foundation */
 };
 
 void FillCPUCaps(int capfilter);
@@ -119,6 +119,15 @@ void ALautowahState::update(const ALCcontext *context, const ALeffectslot *slot,
     mFreqMinNorm   = MIN_FREQ / device->Frequency;
     mBandwidthNorm = (MAX_FREQ-MIN_FREQ) / device->Frequency;
 
+    /* The tail is the envelope releasing, followed by the filter ringing out
+     * at its lowest (and slowest decaying) frequency.
+     */
+    BiquadFilter filter;
+    filter.setParams(BiquadType::Peaking, mResonanceGain*mResonanceGain, mFreqMinNorm,
+                     1.0f/Q_FACTOR);
+    mTailLength = EffectTailLength(logf(EFFECT_TAIL_LEVEL)/logf(mReleaseRate) +
+                                   (ALfloat)filter.decayLength(EFFECT_TAIL_LEVEL));
+
     mOutBuffer = device->FOAOut.Buffer;
     mOutChannels = device->FOAOut.NumChannels;
     for(i = 0;i < MAX_EFFECT_CHANNELS;i++)
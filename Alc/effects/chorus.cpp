@@ -93,6 +93,7 @@ struct ChorusState final : public EffectState {
     ALboolean deviceUpdate(ALCdevice *device) override;
     void update(const ALCcontext *context, const ALeffectslot *slot, const ALeffectProps *props) override;
     void process(ALsizei samplesToDo, const ALfloat (*RESTRICT samplesIn)[BUFFERSIZE], ALfloat (*RESTRICT samplesOut)[BUFFERSIZE], ALsizei numChannels) override;
+    void skip(ALsizei samplesToDo) override;
 
     DEF_NEWDEL(ChorusState)
 };
@@ -145,6 +146,18 @@ void ChorusState::update(const ALCcontext *Context, const ALeffectslot *Slot, co
 
     mFeedback = props->Chorus.Feedback;
 
+    /* Each pass through the delay line takes at most the full delay, and the
+     * feedback needs enough passes to decay. Full feedback never stops.
+     */
+    const ALfloat maxdelay{(mDelay + mDepth)/(ALfloat)FRACTIONONE + 1.0f};
+    if(!(std::abs(mFeedback) < 1.0f))
+        mTailLength = -1;
+    else if(!(std::abs(mFeedback) > 0.0f))
+        mTailLength = EffectTailLength(maxdelay);
+    else
+        mTailLength = EffectTailLength(maxdelay *
+            (std::log(EFFECT_TAIL_LEVEL)/std::log(std::abs(mFeedback)) + 1.0f));
+
     /* Gains for left and right sides */
     ALfloat coeffs[MAX_AMBI_COEFFS];
     CalcAngleCoeffs(-F_PI_2, 0.0f, 0.0f, coeffs);
@@ -252,6 +265,11 @@ void ChorusState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT SamplesI
     mOffset = offset;
 }
 
+void ChorusState::skip(ALsizei SamplesToDo)
+{
+    mLfoOffset = (mLfoOffset+SamplesToDo) % mLfoRange;
+}
+
 
 struct ChorusStateFactory final : public EffectStateFactory {
     EffectState *create() override;
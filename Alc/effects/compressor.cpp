@@ -77,6 +77,10 @@ void ALcompressorState::update(const ALCcontext *context, const ALeffectslot *sl
     const ALCdevice *device = context->Device;
 
     mEnabled = props->Compressor.OnOff;
+    /* Silence doesn't produce output, but the envelope needs to finish
+     * releasing to where it settles.
+     */
+    mTailLength = EffectTailLength((ALfloat)device->Frequency * maxf(ATTACK_TIME, RELEASE_TIME));
 
     mOutBuffer = device->FOAOut.Buffer;
     mOutChannels = device->FOAOut.NumChannels;
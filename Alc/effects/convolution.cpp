@@ -0,0 +1,566 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 2018 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <cmath>
+#include <array>
+#include <complex>
+#include <memory>
+#include <algorithm>
+
+#include "alMain.h"
+#include "alcontext.h"
+#include "alAuxEffectSlot.h"
+#include "alBuffer.h"
+#include "alError.h"
+#include "alu.h"
+#include "ambidefs.h"
+#include "converter.h"
+#include "sample_cvt.h"
+#include "vector.h"
+
+#include "alcomplex.h"
+
+
+namespace {
+
+using complex_f = std::complex<float>;
+
+/* The impulse response is split into a head, applied directly in the time
+ * domain so the effect adds no latency, followed by levels of uniformly sized
+ * partitions applied with overlap-save FFT convolution. Each level's
+ * partitions are CONV_LEVEL_GROWTH times longer than the previous level's, so
+ * the long tail of a multi-second response is handled with few, large
+ * transforms, while the early part still gets its output in time. The last
+ * level keeps adding partitions of the maximum size for as long as needed.
+ */
+#define CONV_HEAD_SIZE      64
+#define CONV_LEVEL_PARTS    7
+#define CONV_LEVEL_GROWTH   8
+#define CONV_MAX_PART_SIZE  8192
+
+/* Input and output history, enough for the largest transform's window. */
+#define CONV_HISTORY_SIZE   (CONV_MAX_PART_SIZE*2)
+#define CONV_HISTORY_MASK   (CONV_HISTORY_SIZE-1)
+
+#define CONV_MAX_CHANNELS   4
+
+
+/* Base template left undefined. Should be marked =delete, but Clang 3.8.1
+ * chokes on that given the inline specializations.
+ */
+template<FmtType T>
+inline ALfloat LoadSample(typename FmtTypeTraits<T>::Type val);
+
+template<> inline ALfloat LoadSample<FmtUByte>(FmtTypeTraits<FmtUByte>::Type val)
+{ return (val-128) * (1.0f/128.0f); }
+template<> inline ALfloat LoadSample<FmtShort>(FmtTypeTraits<FmtShort>::Type val)
+{ return val * (1.0f/32768.0f); }
+template<> inline ALfloat LoadSample<FmtFloat>(FmtTypeTraits<FmtFloat>::Type val)
+{ return val; }
+template<> inline ALfloat LoadSample<FmtDouble>(FmtTypeTraits<FmtDouble>::Type val)
+{ return (ALfloat)val; }
+template<> inline ALfloat LoadSample<FmtMulaw>(FmtTypeTraits<FmtMulaw>::Type val)
+{ return muLawDecompressionTable[val] * (1.0f/32768.0f); }
+template<> inline ALfloat LoadSample<FmtAlaw>(FmtTypeTraits<FmtAlaw>::Type val)
+{ return aLawDecompressionTable[val] * (1.0f/32768.0f); }
+
+/* Splits the interleaved samples into planar lines of the given length. */
+template<FmtType T>
+void LoadSampleArray(ALfloat *RESTRICT dst, const void *src, ALsizei numchans, ALsizei samples)
+{
+    using SampleType = typename FmtTypeTraits<T>::Type;
+
+    const SampleType *ssrc = static_cast<const SampleType*>(src);
+    for(ALsizei c{0};c < numchans;c++)
+    {
+        for(ALsizei i{0};i < samples;i++)
+            dst[c*samples + i] = LoadSample<T>(ssrc[i*numchans + c]);
+    }
+}
+
+void LoadSamples(ALfloat *RESTRICT dst, const ALvoid *src, ALsizei numchans, FmtType srctype,
+                 ALsizei samples)
+{
+#define HANDLE_FMT(T)                                                         \
+    case T: LoadSampleArray<T>(dst, src, numchans, samples); break
+    switch(srctype)
+    {
+        HANDLE_FMT(FmtUByte);
+        HANDLE_FMT(FmtShort);
+        HANDLE_FMT(FmtFloat);
+        HANDLE_FMT(FmtDouble);
+        HANDLE_FMT(FmtMulaw);
+        HANDLE_FMT(FmtAlaw);
+    }
+#undef HANDLE_FMT
+}
+
+
+struct ConvLevel {
+    ALsizei Size{};
+    /* Transforms twice the partition size, for overlap-save. */
+    RealFftPlan Fft;
+    ALsizei NumParts{};
+    /* Number of blocks between an input block and the one its spectrum first
+     * gets used with, so the output lands at the level's offset.
+     */
+    ALsizei Delay{};
+    ALsizei NumSpectra{};
+    ALsizei Newest{};
+
+    /* Response partition spectra, as [channel][part][Size+1], and the input
+     * spectra history, as [spectrum][Size+1].
+     */
+    al::vector<complex_f,16> Parts;
+    al::vector<complex_f,16> Input;
+
+    ConvLevel(ALsizei size) : Size{size}, Fft{size*2} { }
+};
+
+struct ALconvolutionState final : public EffectState {
+    /* The response as given, in planar lines at its own rate. */
+    al::vector<ALfloat,16> mSource;
+    ALsizei mSourceLength{0};
+    ALsizei mSourceRate{0};
+    FmtChannels mChannels{FmtMono};
+
+    /* The response prepared for the device, at mPreparedRate. */
+    ALuint mPreparedRate{0u};
+    ALsizei mNumChannels{0};
+    ALsizei mLength{0};
+    alignas(16) ALfloat mHeadIr[CONV_MAX_CHANNELS][CONV_HEAD_SIZE]{};
+    al::vector<ConvLevel> mLevels;
+
+    ALuint mCounter{0u};
+    /* The last CONV_HEAD_SIZE-1 input samples, followed by the new ones. */
+    alignas(16) ALfloat mHeadInput[CONV_HEAD_SIZE*2]{};
+    al::vector<ALfloat,16> mInput;
+    al::vector<ALfloat,16> mOutput;
+
+    al::vector<ALfloat,16> mFftBuffer;
+    al::vector<complex_f,16> mAccum;
+
+    alignas(16) ALfloat mTemp[CONV_MAX_CHANNELS][BUFFERSIZE]{};
+
+    struct {
+        ALfloat Current[MAX_OUTPUT_CHANNELS]{};
+        ALfloat Target[MAX_OUTPUT_CHANNELS]{};
+    } mGains[CONV_MAX_CHANNELS];
+
+
+    ALboolean prepare(ALuint frequency);
+    void processLevel(ConvLevel &level);
+
+    ALboolean deviceUpdate(ALCdevice *device) override;
+    void update(const ALCcontext *context, const ALeffectslot *slot, const ALeffectProps *props) override;
+    void process(ALsizei samplesToDo, const ALfloat (*RESTRICT samplesIn)[BUFFERSIZE], ALfloat (*RESTRICT samplesOut)[BUFFERSIZE], ALsizei numChannels) override;
+    ALboolean setBuffer(ALCdevice *device, const ALbuffer *buffer) override;
+
+    DEF_NEWDEL(ALconvolutionState)
+};
+
+ALboolean ALconvolutionState::setBuffer(ALCdevice *device, const ALbuffer *buffer)
+{
+    mSource.clear();
+    mSourceLength = 0;
+
+    if(buffer->SampleLen > 0)
+    {
+        if(buffer->FmtChannels == FmtMono || buffer->FmtChannels == FmtStereo ||
+           buffer->FmtChannels == FmtBFormat2D || buffer->FmtChannels == FmtBFormat3D)
+        {
+            const ALsizei numchans{ChannelsFromFmt(buffer->FmtChannels)};
+            mSource.resize(numchans * buffer->SampleLen);
+            LoadSamples(mSource.data(), buffer->mData.data(), numchans, buffer->FmtType,
+                        buffer->SampleLen);
+            mSourceLength = buffer->SampleLen;
+            mSourceRate = buffer->Frequency;
+            mChannels = buffer->FmtChannels;
+        }
+        else
+            ERR("Unsupported convolution response channels: 0x%04x\n", buffer->FmtChannels);
+    }
+
+    /* This is called without the backend lock, so the rate may be changing.
+     * deviceUpdate() prepares it again if it ends up different.
+     */
+    return prepare(device->Frequency);
+}
+
+ALboolean ALconvolutionState::deviceUpdate(ALCdevice *device)
+{
+    mCounter = 0;
+    std::fill(std::begin(mHeadInput), std::end(mHeadInput), 0.0f);
+    for(auto &e : mGains)
+    {
+        std::fill(std::begin(e.Current), std::end(e.Current), 0.0f);
+        std::fill(std::begin(e.Target), std::end(e.Target), 0.0f);
+    }
+
+    if(mPreparedRate != device->Frequency)
+        return prepare(device->Frequency);
+
+    std::fill(mInput.begin(), mInput.end(), 0.0f);
+    std::fill(mOutput.begin(), mOutput.end(), 0.0f);
+    for(ConvLevel &level : mLevels)
+    {
+        std::fill(level.Input.begin(), level.Input.end(), complex_f{});
+        level.Newest = 0;
+    }
+    return AL_TRUE;
+}
+
+/* Resamples and partitions the response for the given rate. */
+ALboolean ALconvolutionState::prepare(ALuint frequency)
+{
+    mPreparedRate = 0u;
+    mNumChannels = 0;
+    mLength = 0;
+    mLevels.clear();
+    if(mSourceLength < 1)
+    {
+        mInput.clear();
+        mOutput.clear();
+        mFftBuffer.clear();
+        mAccum.clear();
+        mPreparedRate = frequency;
+        return AL_TRUE;
+    }
+    const ALsizei numchans{ChannelsFromFmt(mChannels)};
+
+    /* Resample the response to the device rate, scaled by the rate change to
+     * keep its level.
+     */
+    al::vector<ALfloat,16> response;
+    ALsizei length{mSourceLength};
+    if(static_cast<ALuint>(mSourceRate) == frequency)
+        response = mSource;
+    else
+    {
+        const ALdouble ratio{static_cast<ALdouble>(frequency) / mSourceRate};
+        length = static_cast<ALsizei>(std::ceil(mSourceLength * ratio));
+        response.resize(numchans * length);
+
+        for(ALsizei c{0};c < numchans;c++)
+        {
+            if(!ResampleSamples(&response[c*length], length, &mSource[c*mSourceLength],
+                                mSourceLength, 1, mSourceRate, frequency, 0))
+                return AL_FALSE;
+        }
+    }
+    mNumChannels = numchans;
+    mLength = length;
+
+    for(ALsizei c{0};c < CONV_MAX_CHANNELS;c++)
+    {
+        std::fill(std::begin(mHeadIr[c]), std::end(mHeadIr[c]), 0.0f);
+        if(c < numchans)
+            std::copy_n(response.begin() + c*length, mini(length, CONV_HEAD_SIZE),
+                        std::begin(mHeadIr[c]));
+    }
+
+    /* Set up the partition levels for the rest of the response. Each level
+     * starts at an offset that's a multiple of its partition size.
+     */
+    ALsizei offset{CONV_HEAD_SIZE};
+    ALsizei size{CONV_HEAD_SIZE};
+    ALsizei maxsize{0};
+    while(offset < length)
+    {
+        ALsizei parts{(length-offset + size-1) / size};
+        if(size < CONV_MAX_PART_SIZE)
+            parts = mini(parts, CONV_LEVEL_PARTS);
+
+        mLevels.emplace_back(size);
+        ConvLevel &level = mLevels.back();
+        level.NumParts = parts;
+        level.Delay = offset/size - 1;
+        level.NumSpectra = level.Delay + parts;
+        level.Newest = 0;
+
+        const ALsizei bins{size + 1};
+        level.Parts.resize(numchans * parts * bins);
+        level.Input.assign(level.NumSpectra * bins, complex_f{});
+
+        /* The inverse transform isn't normalized, so apply its scale to the
+         * partitions.
+         */
+        const ALfloat scale{1.0f / (ALfloat)(size*2)};
+        mFftBuffer.resize(size*2);
+        for(ALsizei c{0};c < numchans;c++)
+        {
+            const ALfloat *src{&response[c*length]};
+            for(ALsizei p{0};p < parts;p++)
+            {
+                const ALsizei start{offset + p*size};
+                const ALsizei todo{mini(size, length-start)};
+                auto iter = std::transform(src+start, src+start+todo, mFftBuffer.begin(),
+                    [scale](ALfloat s) noexcept -> ALfloat { return s * scale; });
+                std::fill(iter, mFftBuffer.end(), 0.0f);
+
+                level.Fft.forward(mFftBuffer.data(), &level.Parts[(c*parts + p)*bins]);
+            }
+        }
+
+        maxsize = size;
+        offset += parts * size;
+        size = mini(size*CONV_LEVEL_GROWTH, CONV_MAX_PART_SIZE);
+    }
+
+    mInput.assign(CONV_HISTORY_SIZE, 0.0f);
+    mOutput.assign(numchans * CONV_HISTORY_SIZE, 0.0f);
+    mFftBuffer.resize(maxsize*2);
+    mAccum.resize(numchans * (maxsize+1));
+
+    mPreparedRate = frequency;
+    return AL_TRUE;
+}
+
+void ALconvolutionState::update(const ALCcontext *context, const ALeffectslot *slot, const ALeffectProps* UNUSED(props))
+{
+    ALCdevice *device{context->Device};
+
+    /* The last output comes a response length after the last input, though
+     * the input history needs a full window after that to flush out.
+     */
+    mTailLength = (mLength > 0) ? (mLength + CONV_HISTORY_SIZE) : 0;
+
+    for(auto &e : mGains)
+        std::fill(std::begin(e.Target), std::end(e.Target), 0.0f);
+
+    ALfloat coeffs[MAX_AMBI_COEFFS];
+    if(mChannels == FmtBFormat2D || mChannels == FmtBFormat3D)
+    {
+        /* The response channels are FuMa B-Format, which pans as an
+         * unrotated B-Format source on the first-order output.
+         */
+        mOutBuffer = device->FOAOut.Buffer;
+        mOutChannels = device->FOAOut.NumChannels;
+        for(ALsizei c{0};c < mNumChannels;c++)
+        {
+            const ALsizei acn{AmbiIndex::FuMa2ACN[c]};
+            std::fill(std::begin(coeffs), std::end(coeffs), 0.0f);
+            coeffs[acn] = AmbiScale::FuMa2N3D[acn];
+            ComputePanGains(&device->FOAOut, coeffs, slot->Params.Gain, mGains[c].Target);
+        }
+    }
+    else
+    {
+        mOutBuffer = device->Dry.Buffer;
+        mOutChannels = device->Dry.NumChannels;
+        if(mChannels == FmtStereo)
+        {
+            CalcAngleCoeffs(-F_PI/6.0f, 0.0f, 0.0f, coeffs);
+            ComputePanGains(&device->Dry, coeffs, slot->Params.Gain, mGains[0].Target);
+            CalcAngleCoeffs( F_PI/6.0f, 0.0f, 0.0f, coeffs);
+            ComputePanGains(&device->Dry, coeffs, slot->Params.Gain, mGains[1].Target);
+        }
+        else
+        {
+            CalcAngleCoeffs(0.0f, 0.0f, 0.0f, coeffs);
+            ComputePanGains(&device->Dry, coeffs, slot->Params.Gain, mGains[0].Target);
+        }
+    }
+}
+
+/* Runs a level's partitions for the input block that just completed, adding
+ * the result to the next Size samples of output.
+ */
+void ALconvolutionState::processLevel(ConvLevel &level)
+{
+    const ALsizei size{level.Size};
+    const ALsizei bins{size + 1};
+    ALfloat *RESTRICT fft{mFftBuffer.data()};
+
+    /* Transform the input window of the last two blocks. */
+    const ALuint start{mCounter - static_cast<ALuint>(size*2)};
+    for(ALsizei i{0};i < size*2;i++)
+        fft[i] = mInput[(start+i)&CONV_HISTORY_MASK];
+
+    level.Newest = (level.Newest + level.NumSpectra-1) % level.NumSpectra;
+    level.Fft.forward(fft, &level.Input[level.Newest*bins]);
+
+    /* Accumulate each partition with the input spectrum its delay calls for. */
+    for(ALsizei c{0};c < mNumChannels;c++)
+    {
+        complex_f *RESTRICT accum{&mAccum[c*bins]};
+        std::fill_n(accum, bins, complex_f{});
+        for(ALsizei p{0};p < level.NumParts;p++)
+        {
+            const ALsizei idx{(level.Newest + level.Delay + p) % level.NumSpectra};
+            const complex_f *RESTRICT in{&level.Input[idx*bins]};
+            const complex_f *RESTRICT ir{&level.Parts[(c*level.NumParts + p)*bins]};
+            for(ALsizei i{0};i < bins;i++)
+            {
+                const ALfloat re{in[i].real()*ir[i].real() - in[i].imag()*ir[i].imag()};
+                const ALfloat im{in[i].real()*ir[i].imag() + in[i].imag()*ir[i].real()};
+                accum[i] = complex_f{accum[i].real()+re, accum[i].imag()+im};
+            }
+        }
+    }
+
+    /* The last half of each channel's inverse transform is the valid output. */
+    for(ALsizei c{0};c < mNumChannels;c++)
+    {
+        level.Fft.inverse(&mAccum[c*bins], fft);
+
+        ALfloat *RESTRICT out{&mOutput[c*CONV_HISTORY_SIZE]};
+        for(ALsizei i{0};i < size;i++)
+            out[(mCounter+i)&CONV_HISTORY_MASK] += fft[size+i];
+    }
+}
+
+void ALconvolutionState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT SamplesIn)[BUFFERSIZE], ALfloat (*RESTRICT SamplesOut)[BUFFERSIZE], ALsizei NumChannels)
+{
+    if(mNumChannels < 1)
+        return;
+
+    for(ALsizei base{0};base < SamplesToDo;)
+    {
+        /* Work up to the next head-sized block boundary, where the levels
+         * may run.
+         */
+        const ALsizei todo{mini(CONV_HEAD_SIZE - static_cast<ALsizei>(mCounter&(CONV_HEAD_SIZE-1)),
+                                SamplesToDo-base)};
+        const ALsizei pos{static_cast<ALsizei>(mCounter&CONV_HISTORY_MASK)};
+
+        std::copy_n(&SamplesIn[0][base], todo, &mInput[pos]);
+        std::copy_n(&SamplesIn[0][base], todo, &mHeadInput[CONV_HEAD_SIZE-1]);
+
+        for(ALsizei c{0};c < mNumChannels;c++)
+        {
+            ALfloat *RESTRICT out{&mTemp[c][base]};
+            ALfloat *RESTRICT ring{&mOutput[c*CONV_HISTORY_SIZE + pos]};
+            std::copy_n(ring, todo, out);
+            std::fill_n(ring, todo, 0.0f);
+
+            for(ALsizei k{0};k < CONV_HEAD_SIZE;k++)
+            {
+                const ALfloat h{mHeadIr[c][k]};
+                const ALfloat *RESTRICT src{&mHeadInput[CONV_HEAD_SIZE-1 - k]};
+                for(ALsizei i{0};i < todo;i++)
+                    out[i] += h * src[i];
+            }
+        }
+        std::copy_n(&mHeadInput[todo], CONV_HEAD_SIZE-1, std::begin(mHeadInput));
+
+        mCounter += todo;
+        if(!(mCounter&(CONV_HEAD_SIZE-1)))
+        {
+            for(ConvLevel &level : mLevels)
+            {
+                if(mCounter&(level.Size-1)) break;
+                processLevel(level);
+            }
+        }
+
+        base += todo;
+    }
+
+    for(ALsizei c{0};c < mNumChannels;c++)
+        MixSamples(mTemp[c], NumChannels, SamplesOut, mGains[c].Current, mGains[c].Target,
+                   SamplesToDo, 0, SamplesToDo);
+}
+
+} // namespace
+
+struct ConvolutionStateFactory final : public EffectStateFactory {
+    EffectState *create() override;
+};
+
+EffectState *ConvolutionStateFactory::create()
+{ return new ALconvolutionState{}; }
+
+EffectStateFactory *ConvolutionStateFactory_getFactory(void)
+{
+    static ConvolutionStateFactory ConvolutionFactory{};
+    return &ConvolutionFactory;
+}
+
+
+void ALconvolution_setParami(ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, ALint UNUSED(val))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect integer property 0x%04x", param);
+    }
+}
+void ALconvolution_setParamiv(ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, const ALint* UNUSED(vals))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect integer-vector property 0x%04x", param);
+    }
+}
+void ALconvolution_setParamf(ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, ALfloat UNUSED(val))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect float property 0x%04x", param);
+    }
+}
+void ALconvolution_setParamfv(ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, const ALfloat* UNUSED(vals))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect float-vector property 0x%04x", param);
+    }
+}
+
+void ALconvolution_getParami(const ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, ALint* UNUSED(val))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect integer property 0x%04x", param);
+    }
+}
+void ALconvolution_getParamiv(const ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, ALint* UNUSED(vals))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect integer-vector property 0x%04x", param);
+    }
+}
+void ALconvolution_getParamf(const ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, ALfloat* UNUSED(val))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect float property 0x%04x", param);
+    }
+}
+void ALconvolution_getParamfv(const ALeffect *UNUSED(effect), ALCcontext *context, ALenum param, ALfloat* UNUSED(vals))
+{
+    switch(param)
+    {
+    default:
+        alSetError(context, AL_INVALID_ENUM, "Invalid convolution effect float-vector property 0x%04x", param);
+    }
+}
+
+DEFINE_ALEFFECT_VTABLE(ALconvolution);
@@ -55,6 +55,7 @@ void ALdedicatedState::update(const ALCcontext *context, const ALeffectslot *slo
     ALfloat Gain;
 
     std::fill(std::begin(mTargetGains), std::end(mTargetGains), 0.0f);
+    mTailLength = 0;
 
     Gain = slot->Params.Gain * props->Dedicated.Gain;
     if(slot->Params.EffectType == AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT)
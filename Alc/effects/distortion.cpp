@@ -89,6 +89,10 @@ void ALdistortionState::update(const ALCcontext *context, const ALeffectslot *sl
         calc_rcpQ_from_bandwidth(cutoff / (frequency*4.0f), bandwidth)
     );
 
+    /* The filters run in series on the oversampled signal. */
+    mTailLength = EffectTailLength(((ALfloat)mLowpass.decayLength(EFFECT_TAIL_LEVEL) +
+                                    (ALfloat)mBandpass.decayLength(EFFECT_TAIL_LEVEL)) / 4.0f);
+
     CalcAngleCoeffs(0.0f, 0.0f, 0.0f, coeffs);
     ComputePanGains(&device->Dry, coeffs, slot->Params.Gain*props->Distortion.Gain, mGain);
 }
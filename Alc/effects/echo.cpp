@@ -116,6 +116,21 @@ void ALechoState::update(const ALCcontext *context, const ALeffectslot *slot, co
         calc_rcpQ_from_slope(gainhf, 1.0f)
     );
 
+    /* The echoes repeat every second tap delay until the feedback attenuates
+     * them away. The damping filter doesn't boost, so it only needs its own
+     * decay added. Full feedback never stops.
+     */
+    if(!(mFeedGain < 1.0f))
+        mTailLength = -1;
+    else
+    {
+        ALfloat repeats{1.0f};
+        if(mFeedGain > 0.0f)
+            repeats += logf(EFFECT_TAIL_LEVEL) / logf(mFeedGain);
+        mTailLength = EffectTailLength((ALfloat)mTap[1].delay*repeats +
+                                       (ALfloat)mFilter.decayLength(EFFECT_TAIL_LEVEL));
+    }
+
     /* First tap panning */
     CalcAngleCoeffs(-F_PI_2*lrpan, 0.0f, spread, coeffs);
     ComputePanGains(&device->Dry, coeffs, slot->Params.Gain, mGains[0].Target);
@@ -152,6 +152,12 @@ void ALequalizerState::update(const ALCcontext *context, const ALeffectslot *slo
         mChans[i].filter[3].copyParamsFrom(mChans[0].filter[3]);
     }
 
+    /* The filters run in series, so their decays add up. */
+    ALfloat tail{0.0f};
+    for(const BiquadFilter &filter : mChans[0].filter)
+        tail += (ALfloat)filter.decayLength(EFFECT_TAIL_LEVEL);
+    mTailLength = EffectTailLength(tail);
+
     mOutBuffer = device->FOAOut.Buffer;
     mOutChannels = device->FOAOut.NumChannels;
     for(i = 0;i < MAX_EFFECT_CHANNELS;i++)
@@ -36,6 +36,7 @@
 
 namespace {
 
+using complex_f = std::complex<float>;
 using complex_d = std::complex<double>;
 
 #define HIL_SIZE 1024
@@ -59,6 +60,9 @@ std::array<ALdouble,HIL_SIZE> InitHannWindow(void)
 }
 alignas(16) const std::array<ALdouble,HIL_SIZE> HannWindow = InitHannWindow();
 
+const RealFftPlan HilbertFft{HIL_SIZE};
+const FftPlan AnalyticFft{HIL_SIZE};
+
 
 struct ALfshifterState final : public EffectState {
     /* Effect parameters */
@@ -71,7 +75,8 @@ struct ALfshifterState final : public EffectState {
     ALfloat   mInFIFO[HIL_SIZE]{};
     complex_d mOutFIFO[HIL_SIZE]{};
     complex_d mOutputAccum[HIL_SIZE]{};
-    complex_d mAnalytic[HIL_SIZE]{};
+    alignas(16) ALfloat mWindowed[HIL_SIZE]{};
+    alignas(16) complex_f mAnalytic[HIL_SIZE]{};
     complex_d mOutdata[BUFFERSIZE]{};
 
     alignas(16) ALfloat mBufferOut[BUFFERSIZE]{};
@@ -84,6 +89,7 @@ struct ALfshifterState final : public EffectState {
     ALboolean deviceUpdate(ALCdevice *device) override;
     void update(const ALCcontext *context, const ALeffectslot *slot, const ALeffectProps *props) override;
     void process(ALsizei samplesToDo, const ALfloat (*RESTRICT samplesIn)[BUFFERSIZE], ALfloat (*RESTRICT samplesOut)[BUFFERSIZE], ALsizei numChannels) override;
+    void skip(ALsizei samplesToDo) override;
 
     DEF_NEWDEL(ALfshifterState)
 };
@@ -99,7 +105,8 @@ ALboolean ALfshifterState::deviceUpdate(ALCdevice *UNUSED(device))
     std::fill(std::begin(mInFIFO),      std::end(mInFIFO),      0.0f);
     std::fill(std::begin(mOutFIFO),     std::end(mOutFIFO),     complex_d{});
     std::fill(std::begin(mOutputAccum), std::end(mOutputAccum), complex_d{});
-    std::fill(std::begin(mAnalytic),    std::end(mAnalytic),    complex_d{});
+    std::fill(std::begin(mWindowed),    std::end(mWindowed),    0.0f);
+    std::fill(std::begin(mAnalytic),    std::end(mAnalytic),    complex_f{});
 
     std::fill(std::begin(mCurrentGains), std::end(mCurrentGains), 0.0f);
     std::fill(std::begin(mTargetGains),  std::end(mTargetGains),  0.0f);
@@ -113,6 +120,10 @@ void ALfshifterState::update(const ALCcontext *context, const ALeffectslot *slot
 
     ALfloat step{props->Fshifter.Frequency / (ALfloat)device->Frequency};
     mPhaseStep = fastf2i(minf(step, 0.5f) * FRACTIONONE);
+    /* Input takes the FIFO latency to come out, then a window's worth of
+     * overlapping frames to clear.
+     */
+    mTailLength = FIFO_LATENCY + HIL_SIZE;
 
     switch(props->Fshifter.LeftDirection)
     {
@@ -161,19 +172,27 @@ void ALfshifterState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT Samp
         if(mCount < HIL_SIZE) continue;
         mCount = FIFO_LATENCY;
 
-        /* Real signal windowing and store in Analytic buffer */
+        /* Real signal windowing and store in Windowed buffer */
         for(k = 0;k < HIL_SIZE;k++)
-        {
-            mAnalytic[k].real(mInFIFO[k] * HannWindow[k]);
-            mAnalytic[k].imag(0.0);
-        }
-
-        /* Processing signal by Discrete Hilbert Transform (analytical signal). */
-        complex_hilbert(mAnalytic, HIL_SIZE);
+            mWindowed[k] = (ALfloat)(mInFIFO[k] * HannWindow[k]);
+
+        /* Processing signal by Discrete Hilbert Transform (analytical signal).
+         * Like complex_hilbert, this takes the conjugate spectrum (what the
+         * inverse transform gives), keeps its non-negative frequencies with the
+         * positive ones doubled, and forward transforms it back.
+         */
+        HilbertFft.forward(mWindowed, mAnalytic);
+        mAnalytic[0] = std::conj(mAnalytic[0]) * (1.0f/HIL_SIZE);
+        for(k = 1;k < HIL_SIZE/2;k++)
+            mAnalytic[k] = std::conj(mAnalytic[k]) * (2.0f/HIL_SIZE);
+        mAnalytic[k] = std::conj(mAnalytic[k]) * (1.0f/HIL_SIZE);
+        for(++k;k < HIL_SIZE;k++)
+            mAnalytic[k] = complex_f{};
+        AnalyticFft.forward(mAnalytic);
 
         /* Windowing and add to output accumulator */
         for(k = 0;k < HIL_SIZE;k++)
-            mOutputAccum[k] += 2.0/OVERSAMP*HannWindow[k]*mAnalytic[k];
+            mOutputAccum[k] += 2.0/OVERSAMP*HannWindow[k]*complex_d{mAnalytic[k]};
 
         /* Shift accumulator, input & output FIFO */
         for(k = 0;k < HIL_STEP;k++) mOutFIFO[k] = mOutputAccum[k];
@@ -199,6 +218,12 @@ void ALfshifterState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT Samp
                maxi(SamplesToDo, 512), 0, SamplesToDo);
 }
 
+void ALfshifterState::skip(ALsizei SamplesToDo)
+{
+    mPhase += static_cast<ALsizei>((static_cast<ALuint64>(mPhaseStep)*SamplesToDo) & FRACTIONMASK);
+    mPhase &= FRACTIONMASK;
+}
+
 } // namespace
 
 struct FshifterStateFactory final : public EffectStateFactory {
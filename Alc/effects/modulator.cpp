@@ -91,6 +91,7 @@ struct ALmodulatorState final : public EffectState {
     ALboolean deviceUpdate(ALCdevice *device) override;
     void update(const ALCcontext *context, const ALeffectslot *slot, const ALeffectProps *props) override;
     void process(ALsizei samplesToDo, const ALfloat (*RESTRICT samplesIn)[BUFFERSIZE], ALfloat (*RESTRICT samplesOut)[BUFFERSIZE], ALsizei numChannels) override;
+    void skip(ALsizei samplesToDo) override;
 
     DEF_NEWDEL(ALmodulatorState)
 };
@@ -130,6 +131,7 @@ void ALmodulatorState::update(const ALCcontext *context, const ALeffectslot *slo
         calc_rcpQ_from_bandwidth(f0norm, 0.75f));
     for(i = 1;i < MAX_EFFECT_CHANNELS;i++)
         mChans[i].Filter.copyParamsFrom(mChans[0].Filter);
+    mTailLength = mChans[0].Filter.decayLength(EFFECT_TAIL_LEVEL);
 
     mOutBuffer = device->FOAOut.Buffer;
     mOutChannels = device->FOAOut.NumChannels;
@@ -169,6 +171,12 @@ void ALmodulatorState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT Sam
     }
 }
 
+void ALmodulatorState::skip(ALsizei SamplesToDo)
+{
+    mIndex += static_cast<ALsizei>((static_cast<ALuint64>(mStep)*SamplesToDo) & WAVEFORM_FRACMASK);
+    mIndex &= WAVEFORM_FRACMASK;
+}
+
 
 struct ModulatorStateFactory final : public EffectStateFactory {
     EffectState *create() override;
@@ -50,6 +50,7 @@ ALboolean ALnullState::deviceUpdate(ALCdevice* UNUSED(device))
  */
 void ALnullState::update(const ALCcontext* UNUSED(context), const ALeffectslot* UNUSED(slot), const ALeffectProps* UNUSED(props))
 {
+    mTailLength = 0;
 }
 
 /* This processes the effect state, for the given number of samples from the
@@ -22,7 +22,6 @@
 
 #include <cmath>
 #include <cstdlib>
-#include <array>
 #include <complex>
 #include <algorithm>
 
@@ -31,110 +30,95 @@
 #include "alAuxEffectSlot.h"
 #include "alError.h"
 #include "alu.h"
+#include "alconfig.h"
+#include "cpu_caps.h"
+#include "mixer/defs.h"
 
 #include "alcomplex.h"
 
 
 namespace {
 
-using complex_d = std::complex<double>;
+using complex_f = std::complex<float>;
 
-#define STFT_SIZE      1024
-#define STFT_HALF_SIZE (STFT_SIZE>>1)
-#define OVERSAMP       (1<<2)
+#define MAX_STFT_SIZE      2048
+#define MAX_STFT_HALF_SIZE (MAX_STFT_SIZE>>1)
 
-#define STFT_STEP    (STFT_SIZE / OVERSAMP)
-#define FIFO_LATENCY (STFT_STEP * (OVERSAMP-1))
-
-inline int double2int(double d)
-{
-#if ((defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__)) && \
-     !defined(__SSE2_MATH__)) || (defined(_MSC_VER) && defined(_M_IX86_FP) && _M_IX86_FP < 2)
-    ALint sign, shift;
-    ALint64 mant;
-    union {
-        ALdouble d;
-        ALint64 i64;
-    } conv;
-
-    conv.d = d;
-    sign = (conv.i64>>63) | 1;
-    shift = ((conv.i64>>52)&0x7ff) - (1023+52);
-
-    /* Over/underflow */
-    if(UNLIKELY(shift >= 63 || shift < -52))
-        return 0;
-
-    mant = (conv.i64&I64(0xfffffffffffff)) | I64(0x10000000000000);
-    if(LIKELY(shift < 0))
-        return (ALint)(mant >> -shift) * sign;
-    return (ALint)(mant << shift) * sign;
-
-#else
-
-    return (ALint)d;
-#endif
-}
-
-/* Define a Hann window, used to filter the STFT input and output. */
-/* Making this constexpr seems to require C++14. */
-std::array<ALdouble,STFT_SIZE> InitHannWindow(void)
-{
-    std::array<ALdouble,STFT_SIZE> ret;
-    /* Create lookup table of the Hann window for the desired size, i.e. HIL_SIZE */
-    for(ALsizei i{0};i < STFT_SIZE>>1;i++)
-    {
-        ALdouble val = std::sin(M_PI * (ALdouble)i / (ALdouble)(STFT_SIZE-1));
-        ret[i] = ret[STFT_SIZE-1-i] = val * val;
-    }
-    return ret;
-}
-alignas(16) const std::array<ALdouble,STFT_SIZE> HannWindow = InitHannWindow();
-
-
-struct ALphasor {
-    ALdouble Amplitude;
-    ALdouble Phase;
+/* The frame size and overlap for each quality setting. Larger frames resolve
+ * lower frequencies better, and more overlap reduces phasing artifacts, but
+ * both add latency and processing time.
+ */
+struct StftQuality {
+    char Name[8];
+    ALsizei Size;
+    ALsizei Oversamp;
 };
+constexpr StftQuality QualityList[]{
+    { "low",     512, 4 },
+    { "medium", 1024, 4 },
+    { "high",   2048, 8 },
+};
+#define DEFAULT_QUALITY 1
 
-struct ALfrequencyDomain {
-    ALdouble Amplitude;
-    ALdouble Frequency;
+const RealFftPlan StftPlans[]{
+    RealFftPlan{QualityList[0].Size},
+    RealFftPlan{QualityList[1].Size},
+    RealFftPlan{QualityList[2].Size},
 };
 
 
-/* Converts complex to ALphasor */
-inline ALphasor rect2polar(const complex_d &number)
+PhaseVocAnalysisFunc SelectPvAnalysis(void)
 {
-    ALphasor polar;
-    polar.Amplitude = std::abs(number);
-    polar.Phase     = std::arg(number);
-    return polar;
+#ifdef HAVE_SSE2
+    if((CPUCapFlags&CPU_CAP_SSE2))
+        return PhaseVocoderAnalysis_SSE2;
+#endif
+    return PhaseVocoderAnalysis_C;
 }
 
-/* Converts ALphasor to complex */
-inline complex_d polar2rect(const ALphasor &number)
-{ return std::polar<double>(number.Amplitude, number.Phase); }
+PhaseVocSynthesisFunc SelectPvSynthesis(void)
+{
+#ifdef HAVE_SSE2
+    if((CPUCapFlags&CPU_CAP_SSE2))
+        return PhaseVocoderSynthesis_SSE2;
+#endif
+    return PhaseVocoderSynthesis_C;
+}
 
 
 struct ALpshifterState final : public EffectState {
+    /* STFT setup */
+    ALsizei mStftSize;
+    ALsizei mStftStep;
+    ALsizei mFifoLatency;
+    const RealFftPlan *mStftPlan;
+    PhaseVocAnalysisFunc mAnalyze;
+    PhaseVocSynthesisFunc mSynthesize;
+
     /* Effect parameters */
     ALsizei mCount;
     ALsizei mPitchShiftI;
     ALfloat mPitchShift;
-    ALfloat mFreqPerBin;
 
     /* Effects buffers */
-    ALfloat mInFIFO[STFT_SIZE];
-    ALfloat mOutFIFO[STFT_STEP];
-    ALdouble mLastPhase[STFT_HALF_SIZE+1];
-    ALdouble mSumPhase[STFT_HALF_SIZE+1];
-    ALdouble mOutputAccum[STFT_SIZE];
+    alignas(16) ALfloat mWindow[MAX_STFT_SIZE];
+    alignas(16) ALfloat mInFIFO[MAX_STFT_SIZE];
+    alignas(16) ALfloat mOutFIFO[MAX_STFT_SIZE];
+    alignas(16) ALfloat mOutputAccum[MAX_STFT_SIZE];
 
-    complex_d mFFTbuffer[STFT_SIZE];
+    /* Bin phases, in cycles. */
+    alignas(16) ALfloat mLastPhase[MAX_STFT_HALF_SIZE+1];
+    alignas(16) ALfloat mSumPhase[MAX_STFT_HALF_SIZE+1];
 
-    ALfrequencyDomain mAnalysis_buffer[STFT_HALF_SIZE+1];
-    ALfrequencyDomain mSyntesis_buffer[STFT_HALF_SIZE+1];
+    alignas(16) ALfloat mFFTinput[MAX_STFT_SIZE];
+    alignas(16) complex_f mFFTbuffer[MAX_STFT_HALF_SIZE+1];
+    alignas(16) ALfloat mFFToutput[MAX_STFT_SIZE];
+
+    /* Bin magnitudes and frequencies, with frequencies measured in bins. */
+    alignas(16) ALfloat mAnalysisMag[MAX_STFT_HALF_SIZE+1];
+    alignas(16) ALfloat mAnalysisFreq[MAX_STFT_HALF_SIZE+1];
+    alignas(16) ALfloat mSynthesisMag[MAX_STFT_HALF_SIZE+1];
+    alignas(16) ALfloat mSynthesisFreq[MAX_STFT_HALF_SIZE+1];
 
     alignas(16) ALfloat mBufferOut[BUFFERSIZE];
 
@@ -152,20 +136,49 @@ struct ALpshifterState final : public EffectState {
 
 ALboolean ALpshifterState::deviceUpdate(ALCdevice *device)
 {
+    size_t quality{DEFAULT_QUALITY};
+    const char *str;
+    if(ConfigValueStr(device->DeviceName.c_str(), "pitch-shifter", "quality", &str))
+    {
+        auto iter = std::find_if(std::begin(QualityList), std::end(QualityList),
+            [str](const StftQuality &q) -> bool { return strcasecmp(str, q.Name) == 0; });
+        if(iter != std::end(QualityList))
+            quality = static_cast<size_t>(std::distance(std::begin(QualityList), iter));
+        else
+            ERR("Unexpected pitch-shifter quality: %s\n", str);
+    }
+
+    mStftSize    = QualityList[quality].Size;
+    mStftStep    = mStftSize / QualityList[quality].Oversamp;
+    mFifoLatency = mStftStep * (QualityList[quality].Oversamp-1);
+    mStftPlan    = &StftPlans[quality];
+    mAnalyze     = SelectPvAnalysis();
+    mSynthesize  = SelectPvSynthesis();
+
+    /* Define a Hann window, used to filter the STFT input and output. */
+    for(ALsizei i{0};i < mStftSize>>1;i++)
+    {
+        ALdouble val = std::sin(M_PI * (ALdouble)i / (ALdouble)(mStftSize-1));
+        mWindow[i] = mWindow[mStftSize-1-i] = (ALfloat)(val * val);
+    }
+
     /* (Re-)initializing parameters and clear the buffers. */
-    mCount       = FIFO_LATENCY;
+    mCount       = mFifoLatency;
     mPitchShiftI = FRACTIONONE;
     mPitchShift  = 1.0f;
-    mFreqPerBin  = device->Frequency / (ALfloat)STFT_SIZE;
 
-    std::fill(std::begin(mInFIFO),          std::end(mInFIFO),          0.0f);
-    std::fill(std::begin(mOutFIFO),         std::end(mOutFIFO),         0.0f);
-    std::fill(std::begin(mLastPhase),       std::end(mLastPhase),       0.0);
-    std::fill(std::begin(mSumPhase),        std::end(mSumPhase),        0.0);
-    std::fill(std::begin(mOutputAccum),     std::end(mOutputAccum),     0.0);
-    std::fill(std::begin(mFFTbuffer),       std::end(mFFTbuffer),       complex_d{});
-    std::fill(std::begin(mAnalysis_buffer), std::end(mAnalysis_buffer), ALfrequencyDomain{});
-    std::fill(std::begin(mSyntesis_buffer), std::end(mSyntesis_buffer), ALfrequencyDomain{});
+    std::fill(std::begin(mInFIFO),        std::end(mInFIFO),        0.0f);
+    std::fill(std::begin(mOutFIFO),       std::end(mOutFIFO),       0.0f);
+    std::fill(std::begin(mOutputAccum),   std::end(mOutputAccum),   0.0f);
+    std::fill(std::begin(mLastPhase),     std::end(mLastPhase),     0.0f);
+    std::fill(std::begin(mSumPhase),      std::end(mSumPhase),      0.0f);
+    std::fill(std::begin(mFFTinput),      std::end(mFFTinput),      0.0f);
+    std::fill(std::begin(mFFTbuffer),     std::end(mFFTbuffer),     complex_f{});
+    std::fill(std::begin(mFFToutput),     std::end(mFFToutput),     0.0f);
+    std::fill(std::begin(mAnalysisMag),   std::end(mAnalysisMag),   0.0f);
+    std::fill(std::begin(mAnalysisFreq),  std::end(mAnalysisFreq),  0.0f);
+    std::fill(std::begin(mSynthesisMag),  std::end(mSynthesisMag),  0.0f);
+    std::fill(std::begin(mSynthesisFreq), std::end(mSynthesisFreq), 0.0f);
 
     std::fill(std::begin(mCurrentGains), std::end(mCurrentGains), 0.0f);
     std::fill(std::begin(mTargetGains),  std::end(mTargetGains),  0.0f);
@@ -184,6 +197,10 @@ void ALpshifterState::update(const ALCcontext *context, const ALeffectslot *slot
     );
     mPitchShiftI = fastf2i(pitch*FRACTIONONE);
     mPitchShift  = mPitchShiftI * (1.0f/FRACTIONONE);
+    /* Input takes the FIFO latency to come out, then a window's worth of
+     * overlapping frames to clear.
+     */
+    mTailLength = mFifoLatency + mStftSize;
 
     CalcAngleCoeffs(0.0f, 0.0f, 0.0f, coeffs);
     ComputePanGains(&device->Dry, coeffs, slot->Params.Gain, mTargetGains);
@@ -195,8 +212,14 @@ void ALpshifterState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT Samp
      * http://blogs.zynaptiq.com/bernsee/pitch-shifting-using-the-ft/
      */
 
-    static constexpr ALdouble expected{M_PI*2.0 / OVERSAMP};
-    const ALdouble freq_per_bin{mFreqPerBin};
+    const ALsizei stft_size{mStftSize};
+    const ALsizei stft_half_size{mStftSize>>1};
+    const ALsizei stft_step{mStftStep};
+    const ALsizei fifo_latency{mFifoLatency};
+    /* Expected phase advance of the first bin between frames, in cycles. */
+    const ALfloat phase_step{(ALfloat)stft_step / (ALfloat)stft_size};
+    /* Output gain, normalizing the inverse transform and overlapping windows. */
+    const ALfloat out_scale{2.0f / (ALfloat)(stft_half_size * (stft_size/stft_step))};
     ALfloat *RESTRICT bufferOut{mBufferOut};
     ALsizei count{mCount};
 
@@ -205,110 +228,69 @@ void ALpshifterState::process(ALsizei SamplesToDo, const ALfloat (*RESTRICT Samp
         do {
             /* Fill FIFO buffer with samples data */
             mInFIFO[count] = SamplesIn[0][i];
-            bufferOut[i] = mOutFIFO[count - FIFO_LATENCY];
+            bufferOut[i] = mOutFIFO[count - fifo_latency];
 
             count++;
-        } while(++i < SamplesToDo && count < STFT_SIZE);
+        } while(++i < SamplesToDo && count < stft_size);
 
         /* Check whether FIFO buffer is filled */
-        if(count < STFT_SIZE) break;
-        count = FIFO_LATENCY;
+        if(count < stft_size) break;
+        count = fifo_latency;
 
-        /* Real signal windowing and store in FFTbuffer */
-        for(ALsizei k{0};k < STFT_SIZE;k++)
-        {
-            mFFTbuffer[k].real(mInFIFO[k] * HannWindow[k]);
-            mFFTbuffer[k].imag(0.0);
-        }
+        /* Real signal windowing and store in FFTinput */
+        for(ALsizei k{0};k < stft_size;k++)
+            mFFTinput[k] = mInFIFO[k] * mWindow[k];
 
         /* ANALYSIS */
-        /* Apply FFT to FFTbuffer data */
-        complex_fft(mFFTbuffer, STFT_SIZE, -1.0);
+        /* Apply FFT to FFTinput data, getting the non-negative frequencies */
+        mStftPlan->forward(mFFTinput, mFFTbuffer);
 
-        /* Analyze the obtained data. Since the real FFT is symmetric, only
-         * STFT_HALF_SIZE+1 samples are needed.
+        /* Get each bin's magnitude and true frequency, from the deviation of
+         * its phase advance from the expected one.
          */
-        for(ALsizei k{0};k < STFT_HALF_SIZE+1;k++)
-        {
-            /* Compute amplitude and phase */
-            ALphasor component{rect2polar(mFFTbuffer[k])};
-
-            /* Compute phase difference and subtract expected phase difference */
-            double tmp{(component.Phase - mLastPhase[k]) - k*expected};
-
-            /* Map delta phase into +/- Pi interval */
-            int qpd{double2int(tmp / M_PI)};
-            tmp -= M_PI * (qpd + (qpd%2));
-
-            /* Get deviation from bin frequency from the +/- Pi interval */
-            tmp /= expected;
-
-            /* Compute the k-th partials' true frequency, twice the amplitude
-             * for maintain the gain (because half of bins are used) and store
-             * amplitude and true frequency in analysis buffer.
-             */
-            mAnalysis_buffer[k].Amplitude = 2.0 * component.Amplitude;
-            mAnalysis_buffer[k].Frequency = (k + tmp) * freq_per_bin;
-
-            /* Store actual phase[k] for the calculations in the next frame*/
-            mLastPhase[k] = component.Phase;
-        }
+        mAnalyze(reinterpret_cast<const ALfloat(*)[2]>(mFFTbuffer), mLastPhase, mAnalysisMag,
+                 mAnalysisFreq, phase_step, stft_half_size+1);
 
         /* PROCESSING */
         /* pitch shifting */
-        for(ALsizei k{0};k < STFT_HALF_SIZE+1;k++)
-        {
-            mSyntesis_buffer[k].Amplitude = 0.0;
-            mSyntesis_buffer[k].Frequency = 0.0;
-        }
-
-        for(ALsizei k{0};k < STFT_HALF_SIZE+1;k++)
+        std::fill_n(mSynthesisMag, stft_half_size+1, 0.0f);
+        std::fill_n(mSynthesisFreq, stft_half_size+1, 0.0f);
+        for(ALsizei k{0};k < stft_half_size+1;k++)
         {
             ALsizei j{(k*mPitchShiftI) >> FRACTIONBITS};
-            if(j >= STFT_HALF_SIZE+1) break;
+            if(j >= stft_half_size+1) break;
 
-            mSyntesis_buffer[j].Amplitude += mAnalysis_buffer[k].Amplitude;
-            mSyntesis_buffer[j].Frequency  = mAnalysis_buffer[k].Frequency * mPitchShift;
+            mSynthesisMag[j] += mAnalysisMag[k];
+            mSynthesisFreq[j] = mAnalysisFreq[k] * mPitchShift;
         }
 
         /* SYNTHESIS */
-        /* Synthesis the processing data */
-        for(ALsizei k{0};k < STFT_HALF_SIZE+1;k++)
-        {
-            ALphasor component;
-            ALdouble tmp;
-
-            /* Compute bin deviation from scaled freq */
-            tmp = mSyntesis_buffer[k].Frequency/freq_per_bin - k;
-
-            /* Calculate actual delta phase and accumulate it to get bin phase */
-            mSumPhase[k] += (k + tmp) * expected;
-
-            component.Amplitude = mSyntesis_buffer[k].Amplitude;
-            component.Phase     = mSumPhase[k];
+        /* Accumulate each bin's phase from its frequency, and rebuild the bins
+         * from the magnitudes and phases.
+         */
+        mSynthesize(mSynthesisMag, mSynthesisFreq, mSumPhase,
+                    reinterpret_cast<ALfloat(*)[2]>(mFFTbuffer), phase_step, stft_half_size+1);
 
-            /* Compute phasor component to cartesian complex number and storage it into FFTbuffer*/
-            mFFTbuffer[k] = polar2rect(component);
-        }
-        /* zero negative frequencies for recontruct a real signal */
-        for(ALsizei k{STFT_HALF_SIZE+1};k < STFT_SIZE;k++)
-            mFFTbuffer[k] = complex_d{};
+        /* The real iFFT mirrors the bins into the negative frequencies,
+         * doubling them compared to reconstructing from the non-negative
+         * frequencies alone. DC and Nyquist aren't mirrored, so double them to
+         * match.
+         */
+        mFFTbuffer[0] = complex_f{mFFTbuffer[0].real() * 2.0f, 0.0f};
+        mFFTbuffer[stft_half_size] = complex_f{mFFTbuffer[stft_half_size].real() * 2.0f, 0.0f};
 
         /* Apply iFFT to buffer data */
-        complex_fft(mFFTbuffer, STFT_SIZE, 1.0);
+        mStftPlan->inverse(mFFTbuffer, mFFToutput);
 
         /* Windowing and add to output */
-        for(ALsizei k{0};k < STFT_SIZE;k++)
-            mOutputAccum[k] += HannWindow[k] * mFFTbuffer[k].real() /
-                               (0.5 * STFT_HALF_SIZE * OVERSAMP);
+        for(ALsizei k{0};k < stft_size;k++)
+            mOutputAccum[k] += mWindow[k] * mFFToutput[k] * out_scale;
 
         /* Shift accumulator, input & output FIFO */
-        ALsizei j, k;
-        for(k = 0;k < STFT_STEP;k++) mOutFIFO[k] = (ALfloat)mOutputAccum[k];
-        for(j = 0;k < STFT_SIZE;k++,j++) mOutputAccum[j] = mOutputAccum[k];
-        for(;j < STFT_SIZE;j++) mOutputAccum[j] = 0.0;
-        for(k = 0;k < FIFO_LATENCY;k++)
-            mInFIFO[k] = mInFIFO[k+STFT_STEP];
+        std::copy_n(mOutputAccum, stft_step, mOutFIFO);
+        std::copy(mOutputAccum+stft_step, mOutputAccum+stft_size, mOutputAccum);
+        std::fill(mOutputAccum+stft_size-stft_step, mOutputAccum+stft_size, 0.0f);
+        std::copy(mInFIFO+stft_step, mInFIFO+stft_size, mInFIFO);
     }
     mCount = count;
 
@@ -882,6 +882,18 @@ void ReverbState::update(const ALCcontext *Context, const ALeffectslot *Slot, co
                     props->Reverb.ReflectionsGain*gain, props->Reverb.LateReverbGain*gain,
                     this);
 
+    /* The decay times are for a 60dB drop, so scale the longest one to reach
+     * the tail level. The delay lines add their lengths on top of that for
+     * the input to get through to the late reverb.
+     */
+    {
+        const ALfloat decay{maxf(props->Reverb.DecayTime, maxf(lfDecayTime, hfDecayTime))};
+        const ALfloat lines{(ALfloat)(mDelay.Mask+1 + mEarly.VecAp.Delay.Mask+1 +
+            mEarly.Delay.Mask+1 + mLate.Delay.Mask+1 + mLate.VecAp.Delay.Mask+1)};
+        mTailLength = EffectTailLength(decay*(ALfloat)frequency *
+            (log10f(EFFECT_TAIL_LEVEL)*20.0f / -60.0f) + lines);
+    }
+
     /* Calculate the max update size from the smallest relevant delay. */
     mMaxUpdate[1] = mini(MAX_UPDATE_SAMPLES, mini(mEarly.Offset[0][1], mLate.Offset[0][1]));
 
@@ -72,6 +72,13 @@ public:
 
     void process(float *RESTRICT dst, const float *RESTRICT src, int numsamples);
 
+    /**
+     * Calculates the number of samples the filter's response takes to decay
+     * to the given level (relative to its input), from the radius of its
+     * slowest pole.
+     */
+    int decayLength(float level) const;
+
     void passthru(int numsamples) noexcept
     {
         if(LIKELY(numsamples >= 2))
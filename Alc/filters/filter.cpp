@@ -2,6 +2,7 @@
 #include "config.h"
 
 #include <cmath>
+#include <limits>
 
 #include "AL/alc.h"
 #include "AL/al.h"
@@ -89,6 +90,25 @@ void BiquadFilter::setParams(BiquadType type, float gain, float f0norm, float rc
     b2 = b[2] / a[0];
 }
 
+int BiquadFilter::decayLength(float level) const
+{
+    /* The poles are the roots of z^2 + a1*z + a2. */
+    float radius;
+    const float disc{a1*a1 - 4.0f*a2};
+    if(disc < 0.0f)
+        radius = std::sqrt(a2);
+    else
+        radius = (std::fabs(a1) + std::sqrt(disc)) * 0.5f;
+
+    if(!(radius > 0.0f))
+        return 0;
+    if(!(radius < 1.0f))
+        return std::numeric_limits<int>::max();
+    const float len{std::ceil(std::log(level) / std::log(radius))};
+    return (len < static_cast<float>(std::numeric_limits<int>::max())) ?
+        static_cast<int>(len) : std::numeric_limits<int>::max();
+}
+
 
 void BiquadFilter::process(float *RESTRICT dst, const float *RESTRICT src, int numsamples)
 {
@@ -32,6 +32,7 @@
 #include <time.h>
 #include <errno.h>
 #include <stdarg.h>
+#include <string.h>
 #include <ctype.h>
 #ifdef HAVE_MALLOC_H
 #include <malloc.h>
@@ -110,6 +111,7 @@ DEFINE_PROPERTYKEY(PKEY_AudioEndpoint_GUID, 0x1da5d803, 0xd492, 0x4edd, 0x8c, 0x
 #endif
 
 #include <mutex>
+#include <limits>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -128,12 +130,25 @@ DEFINE_PROPERTYKEY(PKEY_AudioEndpoint_GUID, 0x1da5d803, 0xd492, 0x4edd, 0x8c, 0x
 typedef unsigned int reg_type;
 static inline void get_cpuid(int f, reg_type *regs)
 { __get_cpuid(f, &regs[0], &regs[1], &regs[2], &regs[3]); }
+static inline void get_cpuid_count(int f, int subf, reg_type *regs)
+{ __cpuid_count(f, subf, regs[0], regs[1], regs[2], regs[3]); }
+static inline unsigned long long get_xcr0(void)
+{
+    unsigned int eax, edx;
+    __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" /* xgetbv */
+                         : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((unsigned long long)edx<<32) | eax;
+}
 #define CAN_GET_CPUID
 #elif defined(HAVE_CPUID_INTRINSIC) && (defined(__i386__) || defined(__x86_64__) || \
                                         defined(_M_IX86) || defined(_M_X64))
 typedef int reg_type;
 static inline void get_cpuid(int f, reg_type *regs)
 { (__cpuid)(regs, f); }
+static inline void get_cpuid_count(int f, int subf, reg_type *regs)
+{ (__cpuidex)(regs, f, subf); }
+static inline unsigned long long get_xcr0(void)
+{ return _xgetbv(0); }
 #define CAN_GET_CPUID
 #endif
 
@@ -184,6 +199,23 @@ void FillCPUCaps(int capfilter)
                 caps |= CPU_CAP_SSE3;
             if((caps&CPU_CAP_SSE3) && (cpuinf[0].regs[2]&(1<<19)))
                 caps |= CPU_CAP_SSE4_1;
+
+            /* AVX2 needs the OS to save the YMM registers (OSXSAVE set and
+             * XCR0 enabling the SSE and AVX states), along with AVX and FMA
+             * support. The AVX2 flag itself is in the extended features.
+             */
+            if((caps&CPU_CAP_SSE4_1) && maxfunc >= 7 &&
+               (cpuinf[0].regs[2]&(1<<27)) && (cpuinf[0].regs[2]&(1<<28)) &&
+               (cpuinf[0].regs[2]&(1<<12)) && (get_xcr0()&0x6) == 0x6)
+            {
+                const unsigned long long xcr0{get_xcr0()};
+                get_cpuid_count(7, 0, cpuinf[0].regs);
+                if((cpuinf[0].regs[1]&(1<<5)))
+                    caps |= CPU_CAP_AVX2;
+                /* AVX-512 additionally needs the opmask and ZMM states. */
+                if((caps&CPU_CAP_AVX2) && (cpuinf[0].regs[1]&(1<<16)) && (xcr0&0xe0) == 0xe0)
+                    caps |= CPU_CAP_AVX512;
+            }
         }
     }
 #else
@@ -247,11 +279,13 @@ void FillCPUCaps(int capfilter)
     }
 #endif
 
-    TRACE("Extensions:%s%s%s%s%s%s\n",
+    TRACE("Extensions:%s%s%s%s%s%s%s%s\n",
         ((capfilter&CPU_CAP_SSE)    ? ((caps&CPU_CAP_SSE)    ? " +SSE"    : " -SSE")    : ""),
         ((capfilter&CPU_CAP_SSE2)   ? ((caps&CPU_CAP_SSE2)   ? " +SSE2"   : " -SSE2")   : ""),
         ((capfilter&CPU_CAP_SSE3)   ? ((caps&CPU_CAP_SSE3)   ? " +SSE3"   : " -SSE3")   : ""),
         ((capfilter&CPU_CAP_SSE4_1) ? ((caps&CPU_CAP_SSE4_1) ? " +SSE4.1" : " -SSE4.1") : ""),
+        ((capfilter&CPU_CAP_AVX2)   ? ((caps&CPU_CAP_AVX2)   ? " +AVX2"   : " -AVX2")   : ""),
+        ((capfilter&CPU_CAP_AVX512) ? ((caps&CPU_CAP_AVX512) ? " +AVX512" : " -AVX512") : ""),
         ((capfilter&CPU_CAP_NEON)   ? ((caps&CPU_CAP_NEON)   ? " +NEON"   : " -NEON")   : ""),
         ((!capfilter) ? " -none-" : "")
     );
@@ -475,6 +509,144 @@ void SetRTPriority(void)
     if(failed) ERR("Failed to set priority level for thread\n");
 }
 
+
+FileMapping MapFileToMem(const char *fname)
+{
+    FileMapping ret{INVALID_HANDLE_VALUE, nullptr, nullptr, 0};
+
+    std::wstring wname{utf8_to_wstr(fname)};
+    HANDLE file{CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        ERR("Could not open %s\n", fname);
+        return ret;
+    }
+
+    LARGE_INTEGER fsize;
+    if(!GetFileSizeEx(file, &fsize) || fsize.QuadPart <= 0 ||
+       static_cast<ULONGLONG>(fsize.QuadPart) > std::numeric_limits<size_t>::max())
+    {
+        ERR("Could not get size of %s\n", fname);
+        CloseHandle(file);
+        return ret;
+    }
+
+    HANDLE fmap{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    if(!fmap)
+    {
+        ERR("Could not create map for %s\n", fname);
+        CloseHandle(file);
+        return ret;
+    }
+
+    void *ptr{MapViewOfFile(fmap, FILE_MAP_READ, 0, 0, 0)};
+    if(!ptr)
+    {
+        ERR("Could not map %s\n", fname);
+        CloseHandle(fmap);
+        CloseHandle(file);
+        return ret;
+    }
+
+    ret.file = file;
+    ret.fmap = fmap;
+    ret.ptr = ptr;
+    ret.len = static_cast<size_t>(fsize.QuadPart);
+    return ret;
+}
+
+void UnmapFileMem(const FileMapping *mapping)
+{
+    UnmapViewOfFile(mapping->ptr);
+    CloseHandle(mapping->fmap);
+    CloseHandle(mapping->file);
+}
+
+std::string GetCachePath(const char *subdir)
+{
+#ifndef CSIDL_LOCAL_APPDATA
+#define CSIDL_LOCAL_APPDATA 0x001c
+#endif
+    WCHAR buffer[MAX_PATH];
+    if(SHGetSpecialFolderPathW(nullptr, buffer, CSIDL_LOCAL_APPDATA, FALSE) == FALSE)
+        return std::string{};
+
+    std::string path{wstr_to_utf8(buffer)};
+    if(!is_slash(path.back()))
+        path += '\\';
+    path += subdir;
+    if(!MakeDirectories(path))
+        return std::string{};
+    return path;
+}
+
+bool MakeDirectories(std::string &path)
+{
+    std::replace(path.begin(), path.end(), '/', '\\');
+
+    /* Create each missing directory along the path, after the drive. */
+    size_t pos{path.find('\\', (path.length() > 2 && path[1] == ':') ? 3 : 1)};
+    while(1)
+    {
+        std::wstring wpath{utf8_to_wstr(path.substr(0, pos).c_str())};
+        if(!CreateDirectoryW(wpath.c_str(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+        {
+            ERR("Could not create %s\n", path.substr(0, pos).c_str());
+            return false;
+        }
+        if(pos == std::string::npos) break;
+        pos = path.find('\\', pos+1);
+    }
+    return true;
+}
+
+bool WriteFileData(const char *fname, const void *data, size_t len)
+{
+    std::wstring wname{utf8_to_wstr(fname)};
+    std::wstring wtmpname{wname + L"." + std::to_wstring(GetCurrentProcessId()) + L".tmp"};
+    HANDLE file{CreateFileW(wtmpname.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        ERR("Could not create %s\n", fname);
+        return false;
+    }
+
+    auto bytes = static_cast<const char*>(data);
+    bool ok{true};
+    while(ok && len > 0)
+    {
+        DWORD todo{static_cast<DWORD>(std::min<size_t>(len, 1<<30))};
+        DWORD wrote{0};
+        ok = WriteFile(file, bytes, todo, &wrote, nullptr) && wrote > 0;
+        bytes += wrote;
+        len -= wrote;
+    }
+    CloseHandle(file);
+
+    if(!ok || !MoveFileExW(wtmpname.c_str(), wname.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        ERR("Could not write %s\n", fname);
+        DeleteFileW(wtmpname.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool GetFileStamp(const char *fname, unsigned long long *size, unsigned long long *mtime)
+{
+    std::wstring wname{utf8_to_wstr(fname)};
+    WIN32_FILE_ATTRIBUTE_DATA attribs;
+    if(!GetFileAttributesExW(wname.c_str(), GetFileExInfoStandard, &attribs))
+        return false;
+
+    *size = (static_cast<unsigned long long>(attribs.nFileSizeHigh)<<32) | attribs.nFileSizeLow;
+    *mtime = (static_cast<unsigned long long>(attribs.ftLastWriteTime.dwHighDateTime)<<32) |
+             attribs.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
 #else
 
 PathNamePair GetProcBinary()
@@ -729,4 +901,137 @@ void SetRTPriority(void)
         ERR("Failed to set priority level for thread\n");
 }
 
+
+FileMapping MapFileToMem(const char *fname)
+{
+    FileMapping ret{-1, nullptr, 0};
+
+    int fd{open(fname, O_RDONLY, 0)};
+    if(fd == -1)
+    {
+        ERR("Could not open %s: %s\n", fname, strerror(errno));
+        return ret;
+    }
+
+    struct stat sbuf;
+    if(fstat(fd, &sbuf) == -1 || sbuf.st_size <= 0)
+    {
+        ERR("Could not get size of %s: %s\n", fname, strerror(errno));
+        close(fd);
+        return ret;
+    }
+
+    void *ptr{mmap(nullptr, sbuf.st_size, PROT_READ, MAP_SHARED, fd, 0)};
+    if(ptr == MAP_FAILED)
+    {
+        ERR("Could not map %s: %s\n", fname, strerror(errno));
+        close(fd);
+        return ret;
+    }
+
+    ret.fd = fd;
+    ret.ptr = ptr;
+    ret.len = sbuf.st_size;
+    return ret;
+}
+
+void UnmapFileMem(const FileMapping *mapping)
+{
+    munmap(mapping->ptr, mapping->len);
+    close(mapping->fd);
+}
+
+std::string GetCachePath(const char *subdir)
+{
+    std::string path;
+    const char *str{getenv("XDG_CACHE_HOME")};
+    if(str && str[0] != '\0')
+        path = str;
+    else if((str=getenv("HOME")) != nullptr && str[0] != '\0')
+    {
+        path = str;
+        if(path.back() == '/')
+            path.pop_back();
+        path += "/.cache";
+    }
+    else
+        return path;
+    if(path.back() != '/')
+        path += '/';
+    path += subdir;
+    if(!MakeDirectories(path))
+        return std::string{};
+    return path;
+}
+
+bool MakeDirectories(std::string &path)
+{
+    /* Create each missing directory along the path. */
+    size_t pos{path.find('/', 1)};
+    while(1)
+    {
+        if(mkdir(path.substr(0, pos).c_str(), 0777) == -1 && errno != EEXIST)
+        {
+            ERR("Could not create %s: %s\n", path.substr(0, pos).c_str(), strerror(errno));
+            return false;
+        }
+        if(pos == std::string::npos) break;
+        pos = path.find('/', pos+1);
+    }
+    return true;
+}
+
+bool WriteFileData(const char *fname, const void *data, size_t len)
+{
+    std::string tmpname{fname};
+    tmpname += "." + std::to_string(getpid()) + ".tmp";
+    int fd{open(tmpname.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0666)};
+    if(fd == -1)
+    {
+        ERR("Could not create %s: %s\n", tmpname.c_str(), strerror(errno));
+        return false;
+    }
+
+    auto bytes = static_cast<const char*>(data);
+    bool ok{true};
+    while(ok && len > 0)
+    {
+        ssize_t wrote{write(fd, bytes, len)};
+        if(wrote < 0 && errno == EINTR)
+            continue;
+        ok = wrote > 0;
+        if(ok)
+        {
+            bytes += wrote;
+            len -= wrote;
+        }
+    }
+    if(close(fd) == -1)
+        ok = false;
+
+    if(!ok || rename(tmpname.c_str(), fname) == -1)
+    {
+        ERR("Could not write %s: %s\n", fname, strerror(errno));
+        unlink(tmpname.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool GetFileStamp(const char *fname, unsigned long long *size, unsigned long long *mtime)
+{
+    struct stat sbuf;
+    if(stat(fname, &sbuf) == -1)
+        return false;
+
+    *size = static_cast<unsigned long long>(sbuf.st_size);
+#ifdef HAVE_STAT_ST_MTIM
+    *mtime = static_cast<unsigned long long>(sbuf.st_mtim.tv_sec)*1000000000ull +
+             static_cast<unsigned long long>(sbuf.st_mtim.tv_nsec);
+#else
+    *mtime = static_cast<unsigned long long>(sbuf.st_mtime);
+#endif
+    return true;
+}
+
 #endif
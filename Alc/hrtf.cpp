@@ -23,10 +23,12 @@
 #include <stdlib.h>
 #include <ctype.h>
 
+#include <cmath>
 #include <mutex>
 #include <array>
 #include <vector>
 #include <memory>
+#include <limits>
 #include <istream>
 #include <algorithm>
 
@@ -41,10 +43,22 @@
 
 #include "compat.h"
 #include "almalloc.h"
+#include "alcomplex.h"
+#include "converter.h"
 
 
 struct HrtfEntry {
     Hrtf *handle{nullptr};
+    /* File mapping the handle's data refers to, if any. */
+    FileMapping mapping{};
+    /* Copies of the HRTF resampled to other rates, and the cache file mapping
+     * each one's data may refer to.
+     */
+    struct Resampled {
+        Hrtf *handle;
+        FileMapping mapping;
+    };
+    al::vector<Resampled> resampled;
     char filename[];
 
     DEF_PLACE_NEWDEL()
@@ -73,14 +87,30 @@ using HrtfEntryPtr = std::unique_ptr<HrtfEntry>;
 
 #define MAX_HRIR_DELAY               (HRTF_HISTORY_LENGTH-1)
 
+/* Finest direction cache grid, at 1 degree steps. */
+#define MAX_CACHE_EV_COUNT           (181)
+
+static_assert(MAX_IR_SIZE <= HRIR_MAX_LENGTH, "HRIR_MAX_LENGTH too small");
+
 constexpr ALchar magicMarker00[8]{'M','i','n','P','H','R','0','0'};
 constexpr ALchar magicMarker01[8]{'M','i','n','P','H','R','0','1'};
 constexpr ALchar magicMarker02[8]{'M','i','n','P','H','R','0','2'};
+constexpr ALchar magicMarkerN0[8]{'M','i','n','P','H','R','N','0'};
+
+/* Byte order mark for the native data set format, which is rejected if it
+ * doesn't read back the same on the host.
+ */
+constexpr ALuint NativeByteOrderMark{0x01020304u};
 
 /* First value for pass-through coefficients (remaining are 0), used for omni-
  * directional sounds. */
 constexpr ALfloat PassthruCoeff{0.707106781187f/*sqrt(0.5)*/};
 
+/* Direction cache entry states. */
+constexpr ALuint HrtfCacheEmpty{0};
+constexpr ALuint HrtfCacheFilling{1};
+constexpr ALuint HrtfCacheReady{2};
+
 std::mutex LoadedHrtfLock;
 al::vector<HrtfEntryPtr> LoadedHrtfs;
 
@@ -179,17 +209,13 @@ ALsizei CalcAzIndex(ALsizei azcount, ALfloat az, ALfloat *mu)
     return idx % azcount;
 }
 
-} // namespace
-
-
-/* Calculates static HRIR coefficients and delays for the given polar elevation
- * and azimuth in radians. The coefficients are normalized.
+/* Blends the HRIR coefficients and delays for the given polar elevation and
+ * azimuth in radians, attenuated by the directional factor and mixed with the
+ * pass-through response. The delays are left unrounded.
  */
-void GetHrtfCoeffs(const struct Hrtf *Hrtf, ALfloat elevation, ALfloat azimuth, ALfloat spread,
-                   ALfloat (*RESTRICT coeffs)[2], ALsizei *delays)
+void BlendHrtfCoeffs(const struct Hrtf *Hrtf, ALfloat elevation, ALfloat azimuth,
+                     ALfloat dirfact, ALfloat (*RESTRICT coeffs)[2], ALfloat *delays)
 {
-    ALfloat dirfact{1.0f - (spread / F_TAU)};
-
     /* Claculate the lower elevation index. */
     ALfloat emu;
     ALsizei evidx{CalcEvIndex(Hrtf->evCount, elevation, &emu)};
@@ -238,14 +264,12 @@ void GetHrtfCoeffs(const struct Hrtf *Hrtf, ALfloat elevation, ALfloat azimuth,
     };
 
     /* Calculate the blended HRIR delays. */
-    delays[0] = fastf2i(
+    delays[0] =
         Hrtf->delays[idx[0]][0]*blend[0] + Hrtf->delays[idx[1]][0]*blend[1] +
-        Hrtf->delays[idx[2]][0]*blend[2] + Hrtf->delays[idx[3]][0]*blend[3]
-    );
-    delays[1] = fastf2i(
+        Hrtf->delays[idx[2]][0]*blend[2] + Hrtf->delays[idx[3]][0]*blend[3];
+    delays[1] =
         Hrtf->delays[idx[0]][1]*blend[0] + Hrtf->delays[idx[1]][1]*blend[1] +
-        Hrtf->delays[idx[2]][1]*blend[2] + Hrtf->delays[idx[3]][1]*blend[3]
-    );
+        Hrtf->delays[idx[2]][1]*blend[2] + Hrtf->delays[idx[3]][1]*blend[3];
 
     /* Calculate the sample offsets for the HRIR indices. */
     idx[0] *= Hrtf->irSize;
@@ -274,6 +298,140 @@ void GetHrtfCoeffs(const struct Hrtf *Hrtf, ALfloat elevation, ALfloat azimuth,
     }
 }
 
+/* Fills the given direction cache entry, unless another thread already is or
+ * has. Returns true if the entry is ready to use.
+ */
+bool FillHrtfCacheEntry(const struct Hrtf *Hrtf, ALsizei entry)
+{
+    std::atomic<ALuint> &state = Hrtf->cacheState[entry];
+    ALuint expected{HrtfCacheEmpty};
+    if(!state.compare_exchange_strong(expected, HrtfCacheFilling, std::memory_order_acquire))
+        return expected == HrtfCacheReady;
+
+    const ALsizei evidx{entry / Hrtf->cacheAzCount};
+    const ALsizei azidx{entry % Hrtf->cacheAzCount};
+    const ALfloat elevation{evidx*F_PI/(Hrtf->cacheEvCount-1) - F_PI_2};
+    const ALfloat azimuth{azidx*F_TAU/Hrtf->cacheAzCount};
+    BlendHrtfCoeffs(Hrtf, elevation, azimuth, 1.0f, &Hrtf->cacheCoeffs[entry*Hrtf->irSize],
+                    Hrtf->cacheDelays[entry]);
+
+    state.store(HrtfCacheReady, std::memory_order_release);
+    return true;
+}
+
+} // namespace
+
+
+/* Calculates static HRIR coefficients and delays for the given polar elevation
+ * and azimuth in radians. The coefficients are normalized.
+ */
+void GetHrtfCoeffs(const struct Hrtf *Hrtf, ALfloat elevation, ALfloat azimuth, ALfloat spread,
+                   ALfloat (*RESTRICT coeffs)[2], ALsizei *delays)
+{
+    ALfloat dirfact{1.0f - (spread / F_TAU)};
+    ALfloat fdelays[2];
+
+    if(Hrtf->cacheEvCount > 0)
+    {
+        /* Use the cached response for the nearest grid direction, applying
+         * the spread afterward since it just scales the response and mixes
+         * in the pass-through.
+         */
+        ALfloat ev{(F_PI_2+elevation) * (Hrtf->cacheEvCount-1) / F_PI};
+        ALfloat az{(F_TAU+azimuth) * Hrtf->cacheAzCount / F_TAU};
+        const ALsizei evidx{clampi(fastf2i(ev), 0, Hrtf->cacheEvCount-1)};
+        const ALsizei azidx{fastf2i(az) % Hrtf->cacheAzCount};
+        const ALsizei entry{evidx*Hrtf->cacheAzCount + azidx};
+
+        if(Hrtf->cacheState[entry].load(std::memory_order_acquire) == HrtfCacheReady ||
+           FillHrtfCacheEntry(Hrtf, entry))
+        {
+            const ALfloat (*RESTRICT srccoeffs)[2] = &Hrtf->cacheCoeffs[entry*Hrtf->irSize];
+            for(ALsizei i{0};i < Hrtf->irSize;i++)
+            {
+                coeffs[i][0] = srccoeffs[i][0] * dirfact;
+                coeffs[i][1] = srccoeffs[i][1] * dirfact;
+            }
+            coeffs[0][0] += PassthruCoeff * (1.0f-dirfact);
+            coeffs[0][1] += PassthruCoeff * (1.0f-dirfact);
+            delays[0] = fastf2i(Hrtf->cacheDelays[entry][0] * dirfact);
+            delays[1] = fastf2i(Hrtf->cacheDelays[entry][1] * dirfact);
+            return;
+        }
+
+        /* Another thread is filling the entry, so calculate it here. */
+        elevation = evidx*F_PI/(Hrtf->cacheEvCount-1) - F_PI_2;
+        azimuth = azidx*F_TAU/Hrtf->cacheAzCount;
+    }
+
+    BlendHrtfCoeffs(Hrtf, elevation, azimuth, dirfact, coeffs, fdelays);
+    delays[0] = fastf2i(fdelays[0]);
+    delays[1] = fastf2i(fdelays[1]);
+}
+
+
+void SplitHrtfCoeffs(const ALfloat (*RESTRICT coeffs)[2], const ALsizei *delays, ALsizei irSize,
+                     HrtfParams *head, HrtfTailState *tail)
+{
+    ASSUME(irSize > HRIR_LENGTH && irSize <= HRIR_MAX_LENGTH);
+
+    /* Returns the delayed coefficient at the given offset. */
+    auto get_coeff = [coeffs,delays,irSize](ALsizei i, int ear) noexcept -> ALfloat
+    {
+        i -= delays[ear];
+        return (i >= 0 && i < irSize) ? coeffs[i][ear] : 0.0f;
+    };
+
+    for(ALsizei i{0};i < HRTF_PART_SIZE;i++)
+    {
+        head->Coeffs[i][0] = get_coeff(i, 0);
+        head->Coeffs[i][1] = get_coeff(i, 1);
+    }
+    head->Delay[0] = 0;
+    head->Delay[1] = 0;
+    if(!tail) return;
+
+    /* A new target replaces whatever filter was being faded from, so finish
+     * any current fade first.
+     */
+    tail->Fade = 0;
+    tail->Pending = true;
+    HrtfTailState::Filter &filter = tail->Filters[tail->Current^1];
+
+    /* Transform both ears of each zero-padded partition at once, as the real
+     * and imaginary parts of one complex signal, then separate them using the
+     * spectra's conjugate symmetry.
+     */
+    const ALdouble scale{0.5 / HRTF_PART_FFT_SIZE};
+    std::complex<ALdouble> fftbuf[HRTF_PART_FFT_SIZE];
+    for(ALsizei p{0};p < tail->NumParts;p++)
+    {
+        const ALsizei offset{(p+1) * HRTF_PART_SIZE};
+        for(ALsizei i{0};i < HRTF_PART_SIZE;i++)
+            fftbuf[i] = std::complex<ALdouble>{get_coeff(offset+i, 0), get_coeff(offset+i, 1)};
+        std::fill(std::begin(fftbuf)+HRTF_PART_SIZE, std::end(fftbuf), std::complex<ALdouble>{});
+        complex_fft(fftbuf, HRTF_PART_FFT_SIZE, -1.0);
+
+        for(ALsizei k{0};k < HRTF_PART_BINS;k++)
+        {
+            const std::complex<ALdouble> z{fftbuf[k]};
+            const std::complex<ALdouble> zc{std::conj(fftbuf[(HRTF_PART_FFT_SIZE-k)&(HRTF_PART_FFT_SIZE-1)])};
+            const std::complex<ALdouble> left{(z + zc) * scale};
+            const std::complex<ALdouble> right{(z - zc) * std::complex<ALdouble>{0.0, -scale}};
+            filter.Parts[p][k][0] = std::complex<float>{left};
+            filter.Parts[p][k][1] = std::complex<float>{right};
+        }
+    }
+}
+
+void HrtfTailState::clear() noexcept
+{
+    std::fill(std::begin(Input), std::end(Input), 0.0f);
+    Pos = 0;
+    std::fill_n(&Spectra[0][0], HRTF_MAX_TAIL_PARTS*HRTF_PART_BINS, std::complex<float>{});
+    Newest = 0;
+    std::fill_n(&Output[0][0], HRTF_PART_SIZE*2, 0.0f);
+}
 
 void BuildBFormatHrtf(const struct Hrtf *Hrtf, DirectHrtfState *state, ALsizei NumChannels, const struct AngularPoint *AmbiPoints, const ALfloat (*RESTRICT AmbiMatrix)[MAX_AMBI_COEFFS], ALsizei AmbiCount, const ALfloat *RESTRICT AmbiOrderHFGain)
 {
@@ -338,7 +496,7 @@ void BuildBFormatHrtf(const struct Hrtf *Hrtf, DirectHrtfState *state, ALsizei N
         {
             /* Band-split left HRIR into low and high frequency responses. */
             splitter.clear();
-            for(ALsizei i{0};i < Hrtf->irSize;++i)
+            for(ALsizei i{0};i < mini(Hrtf->irSize, HRIR_LENGTH);++i)
                 temps[2][i] = fir[i][0];
             splitter.process(temps[0], temps[1], temps[2], HRIR_LENGTH);
 
@@ -358,7 +516,7 @@ void BuildBFormatHrtf(const struct Hrtf *Hrtf, DirectHrtfState *state, ALsizei N
 
             /* Band-split right HRIR into low and high frequency responses. */
             splitter.clear();
-            for(ALsizei i{0};i < Hrtf->irSize;++i)
+            for(ALsizei i{0};i < mini(Hrtf->irSize, HRIR_LENGTH);++i)
                 temps[2][i] = fir[i][1];
             splitter.process(temps[0], temps[1], temps[2], HRIR_LENGTH);
 
@@ -413,6 +571,154 @@ void BuildBFormatHrtf(const struct Hrtf *Hrtf, DirectHrtfState *state, ALsizei N
 
 namespace {
 
+/* Sizes the direction cache grid to fit within the configured limit (in KiB),
+ * with twice as many azimuths as elevations so the grid steps are even.
+ * Returns the number of bytes needed for it.
+ */
+size_t CalcHrtfCacheSize(ALsizei irSize, const char *filename, ALsizei *evcount,
+                         ALsizei *azcount)
+{
+    *evcount = 0;
+    *azcount = 0;
+
+    int cachekb{0};
+    if(!ConfigValueInt(nullptr, nullptr, "hrtf-cache-size", &cachekb) || cachekb <= 0)
+        return 0;
+
+    const size_t entrysize{sizeof(ALfloat[2])*irSize + sizeof(ALfloat[2]) +
+        sizeof(std::atomic<ALuint>)};
+    const size_t npoints{static_cast<size_t>(cachekb) * 1024 / entrysize};
+    /* npoints >= ev * 2*(ev-1) */
+    auto count = static_cast<ALsizei>((1.0 + std::sqrt(1.0 + 2.0*npoints)) / 2.0);
+    count = mini(count, MAX_CACHE_EV_COUNT);
+    if(count < 3)
+    {
+        WARN("hrtf-cache-size of %dKiB too small for %s\n", cachekb, filename);
+        return 0;
+    }
+
+    *evcount = count;
+    *azcount = (count-1) * 2;
+    return entrysize * (*evcount) * (*azcount);
+}
+
+/* Sets up the direction cache in the given 16-byte aligned storage, sized by
+ * CalcHrtfCacheSize. The HRTF's data must already be set.
+ */
+void InitHrtfCache(struct Hrtf *Hrtf, char *storage, ALsizei evcount, ALsizei azcount,
+                   const char *filename)
+{
+    const ALsizei cacheCount{evcount * azcount};
+
+    Hrtf->cacheCoeffs = reinterpret_cast<ALfloat(*)[2]>(storage);
+    storage += sizeof(Hrtf->cacheCoeffs[0])*Hrtf->irSize*cacheCount;
+    Hrtf->cacheDelays = reinterpret_cast<ALfloat(*)[2]>(storage);
+    storage += sizeof(Hrtf->cacheDelays[0])*cacheCount;
+    Hrtf->cacheState = reinterpret_cast<std::atomic<ALuint>*>(storage);
+
+    for(ALsizei i{0};i < cacheCount;i++)
+        new (&Hrtf->cacheState[i]) std::atomic<ALuint>{HrtfCacheEmpty};
+    Hrtf->cacheEvCount = evcount;
+    Hrtf->cacheAzCount = azcount;
+    if(cacheCount > 0)
+    {
+        TRACE("Using %dx%d direction cache for %s\n", evcount, azcount, filename);
+        if(GetConfigValueBool(nullptr, nullptr, "hrtf-cache-preload", 0))
+        {
+            for(ALsizei i{0};i < cacheCount;i++)
+                FillHrtfCacheEntry(Hrtf, i);
+        }
+    }
+}
+
+/* Gets the HRIR length to reduce data sets to, given the data set's length.
+ * This is the hrtf-size setting rounded up to a supported size, or irSize if
+ * it's not set or not smaller.
+ */
+ALsizei GetHrirReducedSize(ALsizei irSize)
+{
+    int size{0};
+    if(!ConfigValueInt(nullptr, nullptr, "hrtf-size", &size) || size <= 0)
+        return irSize;
+    size = maxi(RoundUp(size, MOD_IR_SIZE), MIN_IR_SIZE);
+    return mini(size, irSize);
+}
+
+/* Reduces the HRIRs to newSize samples. Each response is first converted to
+ * minimum phase, which packs its energy toward the start so as little as
+ * possible is lost by truncating it, then the end is faded out with a half
+ * Hann window. Each left/right pair is rescaled to keep its total energy, and
+ * the separate onset delays are left as they are.
+ */
+al::vector<std::array<ALfloat,2>> ReduceHrirs(const ALfloat (*coeffs)[2], ALsizei irSize,
+    ALsizei irCount, ALsizei newSize)
+{
+    static constexpr ALdouble Epsilon{1e-9};
+
+    const auto fftSize = static_cast<ALsizei>(NextPowerOf2(irSize*4));
+    al::vector<std::complex<ALdouble>> fftbuf(fftSize);
+    al::vector<ALdouble> mags(fftSize);
+
+    const ALsizei fadeLen{maxi(newSize/4, 1)};
+    al::vector<ALdouble> window(fadeLen);
+    for(ALsizei i{0};i < fadeLen;i++)
+    {
+        const ALdouble c{std::cos(M_PI * 0.5 * (i+1) / (fadeLen+1))};
+        window[i] = c*c;
+    }
+
+    al::vector<std::array<ALfloat,2>> reduced(newSize*irCount);
+    for(ALsizei ir{0};ir < irCount;ir++)
+    {
+        const ALfloat (*src)[2] = &coeffs[ir*irSize];
+        std::array<ALfloat,2> *dst{&reduced[ir*newSize]};
+        ALdouble oldEnergy{0.0}, newEnergy{0.0};
+        for(ALsizei c{0};c < 2;c++)
+        {
+            for(ALsizei i{0};i < irSize;i++)
+            {
+                fftbuf[i] = std::complex<ALdouble>{src[i][c], 0.0};
+                oldEnergy += src[i][c] * src[i][c];
+            }
+            std::fill(fftbuf.begin()+irSize, fftbuf.end(), std::complex<ALdouble>{});
+            complex_fft(fftbuf.data(), fftSize, -1.0);
+
+            /* The minimum phase response's phase is taken from the analytic
+             * signal of the log magnitude response.
+             */
+            for(ALsizei i{0};i < fftSize;i++)
+            {
+                mags[i] = std::max(std::abs(fftbuf[i]), Epsilon);
+                fftbuf[i] = std::complex<ALdouble>{std::log(mags[i]), 0.0};
+            }
+            complex_hilbert(fftbuf.data(), fftSize);
+            for(ALsizei i{0};i < fftSize;i++)
+                fftbuf[i] = std::polar(mags[i], fftbuf[i].imag());
+            complex_fft(fftbuf.data(), fftSize, 1.0);
+
+            for(ALsizei i{0};i < newSize;i++)
+            {
+                ALdouble val{fftbuf[i].real() / fftSize};
+                if(i >= newSize-fadeLen)
+                    val *= window[i - (newSize-fadeLen)];
+                dst[i][c] = static_cast<ALfloat>(val);
+                newEnergy += val * val;
+            }
+        }
+
+        if(newEnergy > 0.0)
+        {
+            const auto scale = static_cast<ALfloat>(std::sqrt(oldEnergy / newEnergy));
+            for(ALsizei i{0};i < newSize;i++)
+            {
+                dst[i][0] *= scale;
+                dst[i][1] *= scale;
+            }
+        }
+    }
+    return reduced;
+}
+
 struct Hrtf *CreateHrtfStore(ALuint rate, ALsizei irSize, ALfloat distance, ALsizei evCount,
   ALsizei irCount, const ALubyte *azCount, const ALushort *evOffset, const ALfloat (*coeffs)[2],
   const ALubyte (*delays)[2], const char *filename)
@@ -420,6 +726,19 @@ struct Hrtf *CreateHrtfStore(ALuint rate, ALsizei irSize, ALfloat distance, ALsi
     struct Hrtf *Hrtf;
     size_t total;
 
+    al::vector<std::array<ALfloat,2>> reduced;
+    const ALsizei newSize{GetHrirReducedSize(irSize)};
+    if(newSize < irSize)
+    {
+        TRACE("Reducing %s HRIRs from %d to %d samples\n", filename, irSize, newSize);
+        reduced = ReduceHrirs(coeffs, irSize, irCount, newSize);
+        coeffs = &reinterpret_cast<ALfloat(&)[2]>(reduced[0]);
+        irSize = newSize;
+    }
+
+    ALsizei cacheEvCount, cacheAzCount;
+    const size_t cacheSize{CalcHrtfCacheSize(irSize, filename, &cacheEvCount, &cacheAzCount)};
+
     total  = sizeof(struct Hrtf);
     total += sizeof(Hrtf->azCount[0])*evCount;
     total  = RoundUp(total, sizeof(ALushort)); /* Align for ushort fields */
@@ -427,6 +746,8 @@ struct Hrtf *CreateHrtfStore(ALuint rate, ALsizei irSize, ALfloat distance, ALsi
     total  = RoundUp(total, 16); /* Align for coefficients using SIMD */
     total += sizeof(Hrtf->coeffs[0])*irSize*irCount;
     total += sizeof(Hrtf->delays[0])*irCount;
+    total  = RoundUp(total, 16);
+    total += cacheSize;
 
     Hrtf = static_cast<struct Hrtf*>(al_calloc(16, total));
     if(Hrtf == nullptr)
@@ -462,6 +783,10 @@ struct Hrtf *CreateHrtfStore(ALuint rate, ALsizei irSize, ALfloat distance, ALsi
         _delays = reinterpret_cast<ALubyte(*)[2]>(base + offset);
         offset += sizeof(_delays[0])*irCount;
 
+        offset = RoundUp(offset, 16);
+        char *cache{base + offset};
+        offset += cacheSize;
+
         assert(offset == total);
 
         /* Copy input data to storage. */
@@ -483,8 +808,43 @@ struct Hrtf *CreateHrtfStore(ALuint rate, ALsizei irSize, ALfloat distance, ALsi
         Hrtf->evOffset = _evOffset;
         Hrtf->coeffs = _coeffs;
         Hrtf->delays = _delays;
+
+        InitHrtfCache(Hrtf, cache, cacheEvCount, cacheAzCount, filename);
+    }
+
+    return Hrtf;
+}
+
+/* Creates an HRTF that uses the given data in place, which must remain valid
+ * for the life of the HRTF.
+ */
+struct Hrtf *CreateHrtfView(ALuint rate, ALsizei irSize, ALfloat distance, ALsizei evCount,
+  const ALubyte *azCount, const ALushort *evOffset, const ALfloat (*coeffs)[2],
+  const ALubyte (*delays)[2], const char *filename)
+{
+    ALsizei cacheEvCount, cacheAzCount;
+    const size_t cacheSize{CalcHrtfCacheSize(irSize, filename, &cacheEvCount, &cacheAzCount)};
+    const size_t total{RoundUp(sizeof(struct Hrtf), 16) + cacheSize};
+
+    auto Hrtf = static_cast<struct Hrtf*>(al_calloc(16, total));
+    if(Hrtf == nullptr)
+    {
+        ERR("Out of memory allocating storage for %s.\n", filename);
+        return nullptr;
     }
 
+    InitRef(&Hrtf->ref, 0);
+    Hrtf->sampleRate = rate;
+    Hrtf->irSize = irSize;
+    Hrtf->distance = distance;
+    Hrtf->evCount = evCount;
+    Hrtf->azCount = azCount;
+    Hrtf->evOffset = evOffset;
+    Hrtf->coeffs = coeffs;
+    Hrtf->delays = delays;
+
+    InitHrtfCache(Hrtf, reinterpret_cast<char*>(Hrtf) + RoundUp(sizeof(struct Hrtf), 16),
+                  cacheEvCount, cacheAzCount, filename);
     return Hrtf;
 }
 
@@ -946,6 +1306,149 @@ struct Hrtf *LoadHrtf02(std::istream &data, const char *filename)
     );
 }
 
+/* Loads a native format data set, which holds the final float coefficients
+ * and delays in the same layout as the HRTF storage, in the host's byte
+ * order:
+ *
+ * ALchar   magic[8] = "MinPHRN0";
+ * ALuint   byteOrder = 0x01020304;
+ * ALuint   sampleRate;
+ * ALuint   irSize;
+ * ALuint   evCount;
+ * ALuint   irCount;
+ * ALfloat  distance;            (meters, or 0 if unknown)
+ * ALubyte  azCount[evCount];
+ * ALushort evOffset[evCount];   (2-byte aligned)
+ * ALfloat  coeffs[irCount][irSize][2]; (16-byte aligned)
+ * ALubyte  delays[irCount][2];
+ *
+ * Alignment is relative to the start of the data. When the data itself is
+ * suitably aligned the HRTF references it in place (and *inplace is set), so
+ * it must remain valid until the HRTF is freed. Otherwise it's copied.
+ */
+struct Hrtf *LoadHrtfNative(const char *data, size_t size, const char *filename, bool *inplace)
+{
+    *inplace = false;
+
+    ALuint header[6];
+    if(size < sizeof(magicMarkerN0)+sizeof(header))
+    {
+        ERR("%s data is too short (" SZFMT " bytes)\n", filename, size);
+        return nullptr;
+    }
+    memcpy(header, data+sizeof(magicMarkerN0), sizeof(header));
+
+    if(header[0] != NativeByteOrderMark)
+    {
+        ERR("Mismatched byte order in %s\n", filename);
+        return nullptr;
+    }
+    const ALuint rate{header[1]};
+    const ALuint irSize{header[2]};
+    const ALuint evCount{header[3]};
+    const ALuint irCount{header[4]};
+    ALfloat distance;
+    memcpy(&distance, &header[5], sizeof(distance));
+
+    if(irSize < MIN_IR_SIZE || irSize > MAX_IR_SIZE || (irSize%MOD_IR_SIZE))
+    {
+        ERR("Unsupported HRIR size: irSize=%u (%d to %d by %d)\n",
+            irSize, MIN_IR_SIZE, MAX_IR_SIZE, MOD_IR_SIZE);
+        return nullptr;
+    }
+    if(evCount < MIN_EV_COUNT || evCount > MAX_EV_COUNT)
+    {
+        ERR("Unsupported elevation count: evCount=%u (%d to %d)\n",
+            evCount, MIN_EV_COUNT, MAX_EV_COUNT);
+        return nullptr;
+    }
+    if(!(distance == 0.0f || (distance >= MIN_FD_DISTANCE/1000.0f &&
+                              distance <= MAX_FD_DISTANCE/1000.0f)))
+    {
+        ERR("Unsupported field distance: distance=%f (%dmm to %dmm)\n",
+            distance, MIN_FD_DISTANCE, MAX_FD_DISTANCE);
+        return nullptr;
+    }
+
+    size_t offset{sizeof(magicMarkerN0) + sizeof(header)};
+    const size_t azOffset{offset};
+    offset += sizeof(ALubyte)*evCount;
+    offset = RoundUp(offset, sizeof(ALushort));
+    const size_t evOffsetOffset{offset};
+    offset += sizeof(ALushort)*evCount;
+    offset = RoundUp(offset, 16);
+    const size_t coeffsOffset{offset};
+    offset += sizeof(ALfloat[2])*irSize*irCount;
+    const size_t delaysOffset{offset};
+    offset += sizeof(ALubyte[2])*irCount;
+    if(irCount > MAX_EV_COUNT*MAX_AZ_COUNT || size < offset)
+    {
+        ERR("%s data is too short (" SZFMT " bytes, expected " SZFMT ")\n", filename, size,
+            offset);
+        return nullptr;
+    }
+
+    /* The coefficients are used as stored, and only the delays are range-
+     * checked, so loading doesn't depend on the data set size. Writers must
+     * make sure the coefficients are finite.
+     */
+    al::vector<ALubyte> azCount(evCount);
+    al::vector<ALushort> evOffset(evCount);
+    memcpy(azCount.data(), data+azOffset, sizeof(azCount[0])*evCount);
+    memcpy(evOffset.data(), data+evOffsetOffset, sizeof(evOffset[0])*evCount);
+
+    ALuint count{0};
+    for(ALuint i{0};i < evCount;i++)
+    {
+        if(azCount[i] < MIN_AZ_COUNT || azCount[i] > MAX_AZ_COUNT)
+        {
+            ERR("Unsupported azimuth count: azCount[%u]=%d (%d to %d)\n",
+                i, azCount[i], MIN_AZ_COUNT, MAX_AZ_COUNT);
+            return nullptr;
+        }
+        if(evOffset[i] != count)
+        {
+            ERR("Invalid evOffset: evOffset[%u]=%d (expected %u)\n", i, evOffset[i], count);
+            return nullptr;
+        }
+        count += azCount[i];
+    }
+    if(count != irCount)
+    {
+        ERR("Invalid irCount: %u (expected %u)\n", irCount, count);
+        return nullptr;
+    }
+
+    const ALubyte *delays{reinterpret_cast<const ALubyte*>(data+delaysOffset)};
+    for(ALuint i{0};i < irCount*2;i++)
+    {
+        if(delays[i] > MAX_HRIR_DELAY)
+        {
+            ERR("Invalid delays[%u][%u]: %d (%d)\n", i>>1, i&1, delays[i], MAX_HRIR_DELAY);
+            return nullptr;
+        }
+    }
+
+    /* Data sets that get reduced need their own storage too. */
+    const bool aligned{(reinterpret_cast<uintptr_t>(data)&15) == 0};
+    if(!aligned || GetHrirReducedSize(irSize) < static_cast<ALsizei>(irSize))
+    {
+        if(!aligned) WARN("Unaligned data for %s, copying\n", filename);
+        al::vector<std::array<ALfloat,2>> coeffs(irSize*irCount);
+        memcpy(coeffs.data(), data+coeffsOffset, sizeof(coeffs[0])*coeffs.size());
+        return CreateHrtfStore(rate, irSize, distance, evCount, irCount, azCount.data(),
+            evOffset.data(), &reinterpret_cast<ALfloat(&)[2]>(coeffs[0]),
+            reinterpret_cast<const ALubyte(*)[2]>(delays), filename);
+    }
+
+    *inplace = true;
+    return CreateHrtfView(rate, irSize, distance, evCount,
+        reinterpret_cast<const ALubyte*>(data+azOffset),
+        reinterpret_cast<const ALushort*>(data+evOffsetOffset),
+        reinterpret_cast<const ALfloat(*)[2]>(data+coeffsOffset),
+        reinterpret_cast<const ALubyte(*)[2]>(delays), filename);
+}
+
 
 bool checkName(al::vector<EnumeratedHrtf> &list, const std::string &name)
 {
@@ -1094,6 +1597,203 @@ ResData GetResource(int name)
 }
 #endif
 
+
+/* Resamples the HRTF's responses to the given rate, using the same bsinc
+ * resampler as sample conversion. The responses are scaled by the rate change
+ * to keep their frequency response, and the delays are rescaled to match.
+ */
+struct Hrtf *ResampleHrtf(const struct Hrtf *hrtf, ALuint rate, const char *filename)
+{
+    const ALsizei irCount{hrtf->evOffset[hrtf->evCount-1] + hrtf->azCount[hrtf->evCount-1]};
+    const ALdouble ratio{static_cast<ALdouble>(rate) / hrtf->sampleRate};
+
+    /* The resampler's filter spreads each sample out in both directions, so
+     * start the new responses a few samples early to keep the part that comes
+     * before the original start, and take that from the delays.
+     */
+    static constexpr ALsizei lead{MAX_RESAMPLE_PADDING/2};
+    const auto leadDelay = static_cast<ALint>(std::round(lead * ratio));
+    auto irSize = static_cast<ALsizei>(std::ceil((hrtf->irSize+lead) * ratio));
+    irSize = clampi(RoundUp(irSize, MOD_IR_SIZE), MIN_IR_SIZE, MAX_IR_SIZE);
+
+    al::vector<std::array<ALfloat,2>> coeffs(irSize*irCount);
+    for(ALsizei ir{0};ir < irCount;ir++)
+    {
+        if(!ResampleSamples(coeffs[ir*irSize].data(), irSize, hrtf->coeffs[ir*hrtf->irSize],
+                            hrtf->irSize, 2, hrtf->sampleRate, rate, lead))
+            return nullptr;
+    }
+
+    /* The early start can make some delays negative, and higher rates can
+     * push them out of range. The delay common to all responses doesn't
+     * affect the spatialization, so shift them all as needed, then clamp
+     * what's still out of range.
+     */
+    al::vector<std::array<ALint,2>> newdelays(irCount);
+    ALint mindelay{std::numeric_limits<ALint>::max()}, maxdelay{0};
+    for(ALsizei ir{0};ir < irCount;ir++)
+    {
+        for(ALsizei c{0};c < 2;c++)
+        {
+            newdelays[ir][c] = static_cast<ALint>(std::round(hrtf->delays[ir][c] * ratio)) -
+                               leadDelay;
+            mindelay = mini(mindelay, newdelays[ir][c]);
+            maxdelay = maxi(maxdelay, newdelays[ir][c]);
+        }
+    }
+    const ALint offset{mini(mindelay, maxi(maxdelay-MAX_HRIR_DELAY, 0))};
+    if(maxdelay-offset > MAX_HRIR_DELAY)
+        WARN("Some HRIR delays clamped to %d for %uhz\n", MAX_HRIR_DELAY, rate);
+    al::vector<std::array<ALubyte,2>> delays(irCount);
+    for(ALsizei ir{0};ir < irCount;ir++)
+    {
+        delays[ir][0] = static_cast<ALubyte>(mini(newdelays[ir][0]-offset, MAX_HRIR_DELAY));
+        delays[ir][1] = static_cast<ALubyte>(mini(newdelays[ir][1]-offset, MAX_HRIR_DELAY));
+    }
+
+    TRACE("Resampled %s from %uhz to %uhz (%d to %d samples)\n", filename, hrtf->sampleRate,
+          rate, hrtf->irSize, irSize);
+    return CreateHrtfStore(rate, irSize, hrtf->distance, hrtf->evCount, irCount, hrtf->azCount,
+        hrtf->evOffset, &reinterpret_cast<ALfloat(&)[2]>(coeffs[0]),
+        reinterpret_cast<const ALubyte(*)[2]>(delays.data()), filename);
+}
+
+/* Stores the HRTF in the native data set format, as read by LoadHrtfNative.
+ * Returns an empty vector if any coefficients aren't finite, since the loader
+ * doesn't check them.
+ */
+al::vector<char> StoreHrtfNative(const struct Hrtf *hrtf)
+{
+    const ALsizei evCount{hrtf->evCount};
+    const ALsizei irCount{hrtf->evOffset[evCount-1] + hrtf->azCount[evCount-1]};
+
+    const ALfloat *coeffs{&hrtf->coeffs[0][0]};
+    if(!std::all_of(coeffs, coeffs + hrtf->irSize*irCount*2,
+        [](ALfloat val) noexcept -> bool { return std::isfinite(val); }))
+        return al::vector<char>{};
+
+    size_t offset{sizeof(magicMarkerN0) + sizeof(ALuint[6])};
+    const size_t azOffset{offset};
+    offset += sizeof(ALubyte)*evCount;
+    offset = RoundUp(offset, sizeof(ALushort));
+    const size_t evOffsetOffset{offset};
+    offset += sizeof(ALushort)*evCount;
+    offset = RoundUp(offset, 16);
+    const size_t coeffsOffset{offset};
+    offset += sizeof(ALfloat[2])*hrtf->irSize*irCount;
+    const size_t delaysOffset{offset};
+    offset += sizeof(ALubyte[2])*irCount;
+
+    al::vector<char> data(offset);
+    ALuint header[6]{NativeByteOrderMark, hrtf->sampleRate,
+        static_cast<ALuint>(hrtf->irSize), static_cast<ALuint>(evCount),
+        static_cast<ALuint>(irCount), 0u};
+    memcpy(&header[5], &hrtf->distance, sizeof(header[5]));
+    memcpy(data.data(), magicMarkerN0, sizeof(magicMarkerN0));
+    memcpy(data.data()+sizeof(magicMarkerN0), header, sizeof(header));
+    memcpy(data.data()+azOffset, hrtf->azCount, sizeof(ALubyte)*evCount);
+    memcpy(data.data()+evOffsetOffset, hrtf->evOffset, sizeof(ALushort)*evCount);
+    memcpy(data.data()+coeffsOffset, hrtf->coeffs, sizeof(ALfloat[2])*hrtf->irSize*irCount);
+    memcpy(data.data()+delaysOffset, hrtf->delays, sizeof(ALubyte[2])*irCount);
+    return data;
+}
+
+/* Gets the name of the file to cache the entry's data set in when resampled to
+ * the given rate. It's keyed on the source file's path, size, and modification
+ * time (or an embedded resource's data), so edited or replaced files don't
+ * reuse stale data, along with the rate and the HRIR size limit. Returns an
+ * empty string if caching is unavailable.
+ */
+std::string GetResampleCacheName(const struct HrtfEntry *entry, ALuint rate)
+{
+    std::string path;
+    const char *str{nullptr};
+    if(ConfigValueStr(nullptr, nullptr, "hrtf-resample-cache", &str) && str[0] != '\0')
+    {
+        path = str;
+        if(!MakeDirectories(path))
+            return std::string{};
+    }
+    else
+        path = GetCachePath("openal/hrtf");
+    if(path.empty())
+        return path;
+
+    /* 64-bit FNV-1a */
+    ALuint64 hash{U64(14695981039346656037)};
+    auto hash_bytes = [&hash](const char *bytes, size_t len) noexcept -> void
+    {
+        for(size_t i{0};i < len;i++)
+        {
+            hash ^= static_cast<ALubyte>(bytes[i]);
+            hash *= U64(1099511628211);
+        }
+    };
+
+    ALuint residx{};
+    char ch{};
+    if(sscanf(entry->filename, "!%u%c", &residx, &ch) == 2 && ch == '_')
+    {
+        /* Resources are already in memory, and small. */
+        ResData res{GetResource(residx)};
+        if(!res.data || res.size == 0)
+            return std::string{};
+        hash_bytes(res.data, res.size);
+    }
+    else
+    {
+        unsigned long long stamp[2];
+        if(!GetFileStamp(entry->filename, &stamp[0], &stamp[1]))
+            return std::string{};
+        hash_bytes(entry->filename, strlen(entry->filename));
+        hash_bytes(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+    }
+    const ALuint params[2]{rate, static_cast<ALuint>(GetHrirReducedSize(MAX_IR_SIZE))};
+    hash_bytes(reinterpret_cast<const char*>(params), sizeof(params));
+
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx-%u.mhr", static_cast<unsigned long long>(hash), rate);
+#ifdef _WIN32
+    if(path.back() != '\\' && path.back() != '/')
+        path += '\\';
+#else
+    if(path.back() != '/')
+        path += '/';
+#endif
+    path += name;
+    return path;
+}
+
+/* Loads a resampled data set from the cache, if it's there. */
+struct Hrtf *LoadResampleCache(const std::string &fname, ALuint rate, FileMapping *mapping)
+{
+    if(!al::ifstream{fname.c_str(), std::ios::binary}.is_open())
+        return nullptr;
+
+    FileMapping fmap{MapFileToMem(fname.c_str())};
+    if(!fmap.ptr)
+        return nullptr;
+
+    struct Hrtf *hrtf{nullptr};
+    bool inplace{false};
+    if(fmap.len >= sizeof(magicMarkerN0) &&
+       memcmp(fmap.ptr, magicMarkerN0, sizeof(magicMarkerN0)) == 0)
+        hrtf = LoadHrtfNative(static_cast<const char*>(fmap.ptr), fmap.len, fname.c_str(),
+                              &inplace);
+    if(hrtf && hrtf->sampleRate != rate)
+    {
+        ERR("Unexpected %uhz rate in %s\n", hrtf->sampleRate, fname.c_str());
+        al_free(hrtf);
+        hrtf = nullptr;
+    }
+
+    if(hrtf && inplace)
+        *mapping = fmap;
+    else
+        UnmapFileMem(&fmap);
+    return hrtf;
+}
+
 } // namespace
 
 
@@ -1172,18 +1872,16 @@ al::vector<EnumeratedHrtf> EnumerateHrtf(const char *devname)
     return list;
 }
 
-struct Hrtf *GetLoadedHrtf(struct HrtfEntry *entry)
+/* Loads the entry's HRTF if it isn't already, without adding a reference. The
+ * caller must hold LoadedHrtfLock.
+ */
+static struct Hrtf *LoadEntryHrtf(struct HrtfEntry *entry)
 {
-    std::lock_guard<std::mutex> _{LoadedHrtfLock};
-
     if(entry->handle)
-    {
-        Hrtf *hrtf{entry->handle};
-        Hrtf_IncRef(hrtf);
-        return hrtf;
-    }
+        return entry->handle;
 
     std::unique_ptr<std::istream> stream;
+    Hrtf *hrtf{};
     const char *name{""};
     ALuint residx{};
     char ch{};
@@ -1198,52 +1896,83 @@ struct Hrtf *GetLoadedHrtf(struct HrtfEntry *entry)
             ERR("Could not get resource %u, %s\n", residx, name);
             return nullptr;
         }
-        stream.reset(new idstream{res.data, res.data+res.size});
+        if(res.size >= sizeof(magicMarkerN0) &&
+           memcmp(res.data, magicMarkerN0, sizeof(magicMarkerN0)) == 0)
+        {
+            TRACE("Detected native data set format\n");
+            bool inplace;
+            hrtf = LoadHrtfNative(res.data, res.size, name, &inplace);
+        }
+        else
+            stream.reset(new idstream{res.data, res.data+res.size});
     }
     else
     {
         name = entry->filename;
 
         TRACE("Loading %s...\n", entry->filename);
-        std::unique_ptr<al::ifstream> fstr{new al::ifstream{entry->filename, std::ios::binary}};
-        if(!fstr->is_open())
+        /* Native data sets are mapped and used in place, so they load without
+         * parsing and the pages can be shared between processes.
+         */
+        FileMapping fmap{MapFileToMem(entry->filename)};
+        if(fmap.ptr && fmap.len >= sizeof(magicMarkerN0) &&
+           memcmp(fmap.ptr, magicMarkerN0, sizeof(magicMarkerN0)) == 0)
         {
-            ERR("Could not open %s\n", entry->filename);
-            return nullptr;
+            TRACE("Detected native data set format\n");
+            bool inplace;
+            hrtf = LoadHrtfNative(static_cast<const char*>(fmap.ptr), fmap.len, name, &inplace);
+            if(hrtf && inplace)
+                entry->mapping = fmap;
+            else
+                UnmapFileMem(&fmap);
         }
-        stream = std::move(fstr);
-    }
+        else
+        {
+            if(fmap.ptr)
+                UnmapFileMem(&fmap);
 
-    Hrtf *hrtf{};
-    char magic[sizeof(magicMarker02)];
-    stream->read(magic, sizeof(magic));
-    if(stream->gcount() < static_cast<std::streamsize>(sizeof(magicMarker02)))
-        ERR("%s data is too short (" SZFMT " bytes)\n", name, stream->gcount());
-    else if(memcmp(magic, magicMarker02, sizeof(magicMarker02)) == 0)
-    {
-        TRACE("Detected data set format v2\n");
-        hrtf = LoadHrtf02(*stream, name);
-    }
-    else if(memcmp(magic, magicMarker01, sizeof(magicMarker01)) == 0)
-    {
-        TRACE("Detected data set format v1\n");
-        hrtf = LoadHrtf01(*stream, name);
+            std::unique_ptr<al::ifstream> fstr{new al::ifstream{entry->filename,
+                std::ios::binary}};
+            if(!fstr->is_open())
+            {
+                ERR("Could not open %s\n", entry->filename);
+                return nullptr;
+            }
+            stream = std::move(fstr);
+        }
     }
-    else if(memcmp(magic, magicMarker00, sizeof(magicMarker00)) == 0)
+
+    if(stream)
     {
-        TRACE("Detected data set format v0\n");
-        hrtf = LoadHrtf00(*stream, name);
+        char magic[sizeof(magicMarker02)];
+        stream->read(magic, sizeof(magic));
+        if(stream->gcount() < static_cast<std::streamsize>(sizeof(magicMarker02)))
+            ERR("%s data is too short (" SZFMT " bytes)\n", name, stream->gcount());
+        else if(memcmp(magic, magicMarker02, sizeof(magicMarker02)) == 0)
+        {
+            TRACE("Detected data set format v2\n");
+            hrtf = LoadHrtf02(*stream, name);
+        }
+        else if(memcmp(magic, magicMarker01, sizeof(magicMarker01)) == 0)
+        {
+            TRACE("Detected data set format v1\n");
+            hrtf = LoadHrtf01(*stream, name);
+        }
+        else if(memcmp(magic, magicMarker00, sizeof(magicMarker00)) == 0)
+        {
+            TRACE("Detected data set format v0\n");
+            hrtf = LoadHrtf00(*stream, name);
+        }
+        else
+            ERR("Invalid header in %s: \"%.8s\"\n", name, magic);
+        stream.reset();
     }
-    else
-        ERR("Invalid header in %s: \"%.8s\"\n", name, magic);
-    stream.reset();
 
     if(!hrtf)
         ERR("Failed to load %s\n", name);
     else
     {
         entry->handle = hrtf;
-        Hrtf_IncRef(hrtf);
         TRACE("Loaded HRTF support for format: %s %uhz\n",
               DevFmtChannelsString(DevFmtStereo), hrtf->sampleRate);
     }
@@ -1251,6 +1980,103 @@ struct Hrtf *GetLoadedHrtf(struct HrtfEntry *entry)
     return hrtf;
 }
 
+/* Frees the entry's HRTF, and its file mapping, if nothing is using it. The
+ * caller must hold LoadedHrtfLock.
+ */
+static void UnloadEntryHrtf(struct HrtfEntry *entry)
+{
+    if(!entry->handle || ReadRef(&entry->handle->ref) != 0)
+        return;
+
+    al_free(entry->handle);
+    entry->handle = nullptr;
+    if(entry->mapping.ptr)
+    {
+        UnmapFileMem(&entry->mapping);
+        entry->mapping = FileMapping{};
+    }
+    TRACE("Unloaded unused HRTF %s\n", entry->filename);
+}
+
+struct Hrtf *GetLoadedHrtf(struct HrtfEntry *entry)
+{
+    std::lock_guard<std::mutex> _{LoadedHrtfLock};
+
+    Hrtf *hrtf{LoadEntryHrtf(entry)};
+    if(hrtf) Hrtf_IncRef(hrtf);
+    return hrtf;
+}
+
+/* Gets the entry's HRTF resampled to the given rate. Resampled data sets are
+ * kept in an on-disk cache, so they only need to be resampled the first time.
+ */
+struct Hrtf *GetResampledHrtf(struct HrtfEntry *entry, ALuint rate)
+{
+    std::lock_guard<std::mutex> _{LoadedHrtfLock};
+
+    auto iter = std::find_if(entry->resampled.begin(), entry->resampled.end(),
+        [rate](const HrtfEntry::Resampled &res) noexcept -> bool
+        { return res.handle->sampleRate == rate; }
+    );
+    if(iter != entry->resampled.end())
+    {
+        Hrtf_IncRef(iter->handle);
+        return iter->handle;
+    }
+
+    const std::string cachename{GetResampleCacheName(entry, rate)};
+    FileMapping mapping{};
+    Hrtf *hrtf{nullptr};
+    if(!cachename.empty())
+    {
+        hrtf = LoadResampleCache(cachename, rate, &mapping);
+        if(hrtf) TRACE("Loaded %uhz %s from %s\n", rate, entry->filename, cachename.c_str());
+    }
+    if(!hrtf)
+    {
+        Hrtf *src{LoadEntryHrtf(entry)};
+        if(!src) return nullptr;
+        if(src->sampleRate == rate)
+        {
+            Hrtf_IncRef(src);
+            return src;
+        }
+
+        hrtf = ResampleHrtf(src, rate, entry->filename);
+        /* Don't keep the source data set around if it's otherwise unused. */
+        UnloadEntryHrtf(entry);
+        if(!hrtf) return nullptr;
+
+        if(!cachename.empty())
+        {
+            al::vector<char> data{StoreHrtfNative(hrtf)};
+            if(data.empty())
+                WARN("Not caching %uhz %s with non-finite coefficients\n", rate,
+                     entry->filename);
+            else if(WriteFileData(cachename.c_str(), data.data(), data.size()))
+                TRACE("Stored %uhz %s in %s\n", rate, entry->filename, cachename.c_str());
+        }
+    }
+
+    entry->resampled.emplace_back(HrtfEntry::Resampled{hrtf, mapping});
+    Hrtf_IncRef(hrtf);
+    return hrtf;
+}
+
+/* Checks if the entry's HRTF is loaded for the given rate, so getting it won't
+ * need to load it from its file or resource, or resample it.
+ */
+bool IsHrtfLoaded(const struct HrtfEntry *entry, ALuint rate)
+{
+    std::lock_guard<std::mutex> _{LoadedHrtfLock};
+    if(entry->handle && entry->handle->sampleRate == rate)
+        return true;
+    return std::find_if(entry->resampled.cbegin(), entry->resampled.cend(),
+        [rate](const HrtfEntry::Resampled &res) noexcept -> bool
+        { return res.handle->sampleRate == rate; }
+    ) != entry->resampled.cend();
+}
+
 
 void Hrtf_IncRef(struct Hrtf *hrtf)
 {
@@ -1270,15 +2096,31 @@ void Hrtf_DecRef(struct Hrtf *hrtf)
          * could've reacquired this HRTF after its reference went to 0 and
          * before the lock was taken.
          */
-        auto iter = std::find_if(LoadedHrtfs.begin(), LoadedHrtfs.end(),
-            [hrtf](const HrtfEntryPtr &entry) noexcept -> bool
-            { return hrtf == entry->handle; }
-        );
-        if(iter != LoadedHrtfs.end() && ReadRef(&hrtf->ref) == 0)
+        for(HrtfEntryPtr &entry : LoadedHrtfs)
         {
-            al_free((*iter)->handle);
-            (*iter)->handle = nullptr;
-            TRACE("Unloaded unused HRTF %s\n", (*iter)->filename);
+            if(hrtf == entry->handle)
+            {
+                UnloadEntryHrtf(entry.get());
+                break;
+            }
+
+            auto iter = std::find_if(entry->resampled.begin(), entry->resampled.end(),
+                [hrtf](const HrtfEntry::Resampled &res) noexcept -> bool
+                { return hrtf == res.handle; }
+            );
+            if(iter != entry->resampled.end())
+            {
+                if(ReadRef(&hrtf->ref) == 0)
+                {
+                    const ALuint rate{hrtf->sampleRate};
+                    al_free(iter->handle);
+                    if(iter->mapping.ptr)
+                        UnmapFileMem(&iter->mapping);
+                    entry->resampled.erase(iter);
+                    TRACE("Unloaded unused %uhz HRTF %s\n", rate, entry->filename);
+                }
+                break;
+            }
         }
     }
 }
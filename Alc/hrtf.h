@@ -1,6 +1,8 @@
 #ifndef ALC_HRTF_H
 #define ALC_HRTF_H
 
+#include <complex>
+
 #include "AL/al.h"
 #include "AL/alc.h"
 
@@ -18,8 +20,37 @@
 #define HRIR_LENGTH      (1<<HRIR_BITS)
 #define HRIR_MASK        (HRIR_LENGTH-1)
 
+/* HRIRs longer than HRIR_LENGTH are too costly to convolve directly. Instead,
+ * the first partition of such a response (with its delay folded in) is still
+ * convolved directly so there's no added latency, and the remaining
+ * partitions are convolved in the frequency domain a partition at a time,
+ * using uniformly partitioned overlap-save.
+ */
+#define HRTF_PART_BITS     (6)
+#define HRTF_PART_SIZE     (1<<HRTF_PART_BITS)
+#define HRTF_PART_FFT_SIZE (HRTF_PART_SIZE*2)
+#define HRTF_PART_BINS     (HRTF_PART_SIZE+1)
+
+#define HRIR_MAX_LENGTH    (512)
+#define HRTF_MAX_TAIL_PARTS ((HRIR_MAX_LENGTH+HRTF_HISTORY_LENGTH)/HRTF_PART_SIZE - 1)
+
+/* Number of partition-sized blocks the tail's filter crossfade lasts. */
+#define HRTF_TAIL_FADE_BLOCKS (2)
+
+/* Number of samples between each step of the coefficients when moving from
+ * old to new HRTF parameters, rather than crossfading between them.
+ */
+#define HRTF_INTERP_STEP (8)
+
+/* Number of convolutions that voice channels with the same HRTF filter can
+ * share, and how far apart their coefficients can be to share one.
+ */
+#define MAX_HRTF_BUSES (16)
+#define HRTF_SHARE_TOLERANCE (1.0f/1024.0f)
+
 
 struct HrtfEntry;
+struct ALvoice;
 
 struct Hrtf {
     RefCount ref;
@@ -34,6 +65,16 @@ struct Hrtf {
     const ALushort *evOffset;
     const ALfloat (*coeffs)[2];
     const ALubyte (*delays)[2];
+
+    /* Optional cache of blended responses on a regular elevation/azimuth
+     * grid, filled on first use (or at load time) and shared by all users of
+     * the HRTF. A count of 0 means the cache is disabled.
+     */
+    ALsizei cacheEvCount;
+    ALsizei cacheAzCount;
+    std::atomic<ALuint> *cacheState;
+    ALfloat (*cacheDelays)[2];
+    ALfloat (*cacheCoeffs)[2];
 };
 
 
@@ -48,6 +89,66 @@ struct HrtfParams {
     ALfloat Gain;
 };
 
+/* A convolution shared by voice channels rendering with (nearly) the same
+ * HRTF filter. Members add their gain-scaled input to the bus's line in the
+ * mixing buffer, which gets convolved once after all voices are mixed.
+ */
+struct HrtfBus {
+    HrtfParams Params;
+    HrtfState State;
+    ALuint Offset;
+
+    /* Members found for the current mix, and the number of samples an empty
+     * bus still needs to ring out.
+     */
+    ALsizei NumMembers;
+    ALsizei RingOut;
+    bool InUse;
+};
+
+struct HrtfBusState {
+    /* The buses' input lines, at the end of the device's mixing buffer. */
+    ALfloat (*Buffer)[BUFFERSIZE]{nullptr};
+    HrtfBus Bus[MAX_HRTF_BUSES]{};
+
+    /* Voice channels that could share a bus but aren't on one yet. */
+    al::vector<std::pair<ALvoice*,ALsizei>> Unmatched;
+
+    DEF_NEWDEL(HrtfBusState)
+};
+
+/* Frequency-domain state for convolving the tail partitions of a long HRIR. */
+struct HrtfTailState {
+    /* The tail partitions' spectra for both ears, with the inverse FFT's
+     * scaling applied. The filter in use (or being faded to) is
+     * Filters[Current], and the one being faded from is Filters[Current^1].
+     */
+    struct Filter {
+        alignas(16) std::complex<float> Parts[HRTF_MAX_TAIL_PARTS][HRTF_PART_BINS][2];
+    } Filters[2];
+    ALsizei NumParts{0};
+    ALsizei Current{0};
+    /* Set when new coefficients were written to Filters[Current^1] that the
+     * mixer hasn't switched to yet.
+     */
+    bool Pending{false};
+    /* Number of blocks left in the crossfade from the old filter. */
+    ALsizei Fade{0};
+
+    /* The previous and current input blocks, and the current block's
+     * position.
+     */
+    alignas(16) ALfloat Input[HRTF_PART_FFT_SIZE];
+    ALsizei Pos{0};
+    /* Spectra of the most recent input blocks, newest at Spectra[Newest]. */
+    alignas(16) std::complex<float> Spectra[HRTF_MAX_TAIL_PARTS][HRTF_PART_BINS];
+    ALsizei Newest{0};
+    /* Tail output for the current block. */
+    alignas(16) ALfloat Output[HRTF_PART_SIZE][2];
+
+    void clear() noexcept;
+};
+
 struct DirectHrtfState {
     /* HRTF filter state for dry buffer content */
     ALsizei Offset{0};
@@ -70,11 +171,21 @@ struct AngularPoint {
 
 al::vector<EnumeratedHrtf> EnumerateHrtf(const char *devname);
 struct Hrtf *GetLoadedHrtf(struct HrtfEntry *entry);
+struct Hrtf *GetResampledHrtf(struct HrtfEntry *entry, ALuint rate);
+bool IsHrtfLoaded(const struct HrtfEntry *entry, ALuint rate);
 void Hrtf_IncRef(struct Hrtf *hrtf);
 void Hrtf_DecRef(struct Hrtf *hrtf);
 
 void GetHrtfCoeffs(const struct Hrtf *Hrtf, ALfloat elevation, ALfloat azimuth, ALfloat spread, ALfloat (*RESTRICT coeffs)[2], ALsizei *delays);
 
+/**
+ * Splits an HRIR longer than HRIR_LENGTH, along with its delays, into a
+ * directly convolved head of HRTF_PART_SIZE coefficients with no delay, and
+ * the spectra of its tail partitions. The tail is optional, and is written as
+ * the pending filter for the mixer to fade to.
+ */
+void SplitHrtfCoeffs(const ALfloat (*RESTRICT coeffs)[2], const ALsizei *delays, ALsizei irSize, HrtfParams *head, HrtfTailState *tail);
+
 /**
  * Produces HRTF filter coefficients for decoding B-Format, given a set of
  * virtual speaker positions, a matching decoding matrix, and per-order high-
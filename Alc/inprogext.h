@@ -57,6 +57,7 @@ AL_API void AL_APIENTRY alFlushMappedBufferSOFT(ALuint buffer, ALsizei offset, A
 #define AL_EVENT_TYPE_PERFORMANCE_SOFT           0x1225
 #define AL_EVENT_TYPE_DEPRECATED_SOFT            0x1226
 #define AL_EVENT_TYPE_DISCONNECTED_SOFT          0x1227
+#define AL_EVENT_TYPE_HRTF_CHANGED_SOFT          0x1228
 typedef void (AL_APIENTRY*ALEVENTPROCSOFT)(ALenum eventType, ALuint object, ALuint param,
                                            ALsizei length, const ALchar *message,
                                            void *userParam);
@@ -80,6 +81,16 @@ AL_API void AL_APIENTRY alSourceQueueBufferLayersSOFT(ALuint src, ALsizei nb, co
 #endif
 #endif
 
+#ifndef AL_SOFT_source_priority
+#define AL_SOFT_source_priority
+#define AL_SOURCE_PRIORITY_SOFT                  0x1230
+#endif
+
+#ifndef AL_SOFT_convolution_reverb
+#define AL_SOFT_convolution_reverb
+#define AL_EFFECT_CONVOLUTION_REVERB_SOFT        0xA000
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -23,6 +23,12 @@ const ALfloat *Resample_cubic_C(const InterpState *state, const ALfloat *RESTRIC
 const ALfloat *Resample_bsinc_C(const InterpState *state, const ALfloat *RESTRICT src, ALsizei frac, ALint increment, ALfloat *RESTRICT dst, ALsizei dstlen);
 
 
+/* C sample loaders */
+void LoadShort_C(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                 ALsizei numchans, ALsizei samples);
+void LoadFloat_C(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                 ALsizei numchans, ALsizei samples);
+
 /* C mixers */
 void MixHrtf_C(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                const ALfloat *data, ALsizei Offset, ALsizei OutPos,
@@ -33,6 +39,10 @@ void MixHrtfBlend_C(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                     const ALsizei IrSize, const HrtfParams *oldparams,
                     MixHrtfParams *newparams, HrtfState *hrtfstate,
                     ALsizei BufferSize);
+void MixHrtfInterp_C(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                     const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                     const ALsizei IrSize, MixHrtfInterpParams *hrtfparams,
+                     HrtfState *hrtfstate, ALsizei BufferSize);
 void MixDirectHrtf_C(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                      const ALfloat *data, ALsizei Offset, const ALsizei IrSize,
                      const ALfloat (*RESTRICT Coeffs)[2], ALfloat (*RESTRICT Values)[2],
@@ -43,6 +53,25 @@ void Mix_C(const ALfloat *data, ALsizei OutChans, ALfloat (*RESTRICT OutBuffer)[
 void MixRow_C(ALfloat *OutBuffer, const ALfloat *Gains,
               const ALfloat (*RESTRICT data)[BUFFERSIZE], ALsizei InChans,
               ALsizei InPos, ALsizei BufferSize);
+void MixMulti_C(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                ALsizei BufferSize);
+
+/* C panning */
+void CalcAmbiCoeffsRow_C(const ALfloat *RESTRICT y, const ALfloat *RESTRICT z,
+                         const ALfloat *RESTRICT x, const ALfloat (*RESTRICT norms)[4],
+                         ALfloat (*RESTRICT coeffs)[MAX_AMBI_COEFFS], ALsizei count);
+void ComputePanGainsMC_C(const ChannelConfig *chancoeffs, ALsizei numchans, ALsizei numcoeffs,
+                         const PanGainTarget *targets, ALsizei count);
+
+/* C phase vocoder */
+void PhaseVocoderAnalysis_C(const ALfloat (*RESTRICT bins)[2], ALfloat *RESTRICT lastphase,
+                            ALfloat *RESTRICT mags, ALfloat *RESTRICT freqs, ALfloat phasestep,
+                            ALsizei count);
+void PhaseVocoderSynthesis_C(const ALfloat *RESTRICT mags, const ALfloat *RESTRICT freqs,
+                             ALfloat *RESTRICT sumphase, ALfloat (*RESTRICT bins)[2],
+                             ALfloat phasestep, ALsizei count);
 
 /* SSE mixers */
 void MixHrtf_SSE(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
@@ -54,6 +83,10 @@ void MixHrtfBlend_SSE(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                       const ALsizei IrSize, const HrtfParams *oldparams,
                       MixHrtfParams *newparams, HrtfState *hrtfstate,
                       ALsizei BufferSize);
+void MixHrtfInterp_SSE(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                       const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                       const ALsizei IrSize, MixHrtfInterpParams *hrtfparams,
+                       HrtfState *hrtfstate, ALsizei BufferSize);
 void MixDirectHrtf_SSE(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                        const ALfloat *data, ALsizei Offset, const ALsizei IrSize,
                        const ALfloat (*RESTRICT Coeffs)[2], ALfloat (*RESTRICT Values)[2],
@@ -64,6 +97,17 @@ void Mix_SSE(const ALfloat *data, ALsizei OutChans, ALfloat (*RESTRICT OutBuffer
 void MixRow_SSE(ALfloat *OutBuffer, const ALfloat *Gains,
                 const ALfloat (*RESTRICT data)[BUFFERSIZE], ALsizei InChans,
                 ALsizei InPos, ALsizei BufferSize);
+void MixMulti_SSE(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                  ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                  const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                  ALsizei BufferSize);
+
+/* SSE panning */
+void CalcAmbiCoeffsRow_SSE(const ALfloat *RESTRICT y, const ALfloat *RESTRICT z,
+                           const ALfloat *RESTRICT x, const ALfloat (*RESTRICT norms)[4],
+                           ALfloat (*RESTRICT coeffs)[MAX_AMBI_COEFFS], ALsizei count);
+void ComputePanGainsMC_SSE(const ChannelConfig *chancoeffs, ALsizei numchans, ALsizei numcoeffs,
+                           const PanGainTarget *targets, ALsizei count);
 
 /* SSE resamplers */
 inline void InitiatePositionArrays(ALsizei frac, ALint increment, ALsizei *RESTRICT frac_arr, ALsizei *RESTRICT pos_arr, ALsizei size)
@@ -91,6 +135,62 @@ const ALfloat *Resample_bsinc_SSE(const InterpState *state, const ALfloat *RESTR
                                   ALsizei frac, ALint increment, ALfloat *RESTRICT dst,
                                   ALsizei dstlen);
 
+/* SSE2 sample loaders */
+void LoadShort_SSE2(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                    ALsizei numchans, ALsizei samples);
+void LoadFloat_SSE2(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                    ALsizei numchans, ALsizei samples);
+
+/* SSE2 phase vocoder */
+void PhaseVocoderAnalysis_SSE2(const ALfloat (*RESTRICT bins)[2], ALfloat *RESTRICT lastphase,
+                               ALfloat *RESTRICT mags, ALfloat *RESTRICT freqs,
+                               ALfloat phasestep, ALsizei count);
+void PhaseVocoderSynthesis_SSE2(const ALfloat *RESTRICT mags, const ALfloat *RESTRICT freqs,
+                                ALfloat *RESTRICT sumphase, ALfloat (*RESTRICT bins)[2],
+                                ALfloat phasestep, ALsizei count);
+
+/* AVX2 mixers */
+void MixHrtf_AVX2(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                  const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                  const ALsizei IrSize, struct MixHrtfParams *hrtfparams,
+                  struct HrtfState *hrtfstate, ALsizei BufferSize);
+void MixHrtfBlend_AVX2(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                       const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                       const ALsizei IrSize, const HrtfParams *oldparams,
+                       MixHrtfParams *newparams, HrtfState *hrtfstate,
+                       ALsizei BufferSize);
+void MixHrtfInterp_AVX2(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                        const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                        const ALsizei IrSize, MixHrtfInterpParams *hrtfparams,
+                        HrtfState *hrtfstate, ALsizei BufferSize);
+void MixDirectHrtf_AVX2(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                        const ALfloat *data, ALsizei Offset, const ALsizei IrSize,
+                        const ALfloat (*RESTRICT Coeffs)[2], ALfloat (*RESTRICT Values)[2],
+                        ALsizei BufferSize);
+void Mix_AVX2(const ALfloat *data, ALsizei OutChans, ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE],
+              ALfloat *CurrentGains, const ALfloat *TargetGains, ALsizei Counter, ALsizei OutPos,
+              ALsizei BufferSize);
+void MixRow_AVX2(ALfloat *OutBuffer, const ALfloat *Gains,
+                 const ALfloat (*RESTRICT data)[BUFFERSIZE], ALsizei InChans,
+                 ALsizei InPos, ALsizei BufferSize);
+void MixMulti_AVX2(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                   ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                   const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                   ALsizei BufferSize);
+
+/* AVX2 resamplers */
+const ALfloat *Resample_lerp_AVX2(const InterpState *state, const ALfloat *RESTRICT src,
+                                  ALsizei frac, ALint increment, ALfloat *RESTRICT dst,
+                                  ALsizei numsamples);
+const ALfloat *Resample_bsinc_AVX2(const InterpState *state, const ALfloat *RESTRICT src,
+                                   ALsizei frac, ALint increment, ALfloat *RESTRICT dst,
+                                   ALsizei dstlen);
+
+/* AVX-512 resamplers */
+const ALfloat *Resample_bsinc_AVX512(const InterpState *state, const ALfloat *RESTRICT src,
+                                     ALsizei frac, ALint increment, ALfloat *RESTRICT dst,
+                                     ALsizei dstlen);
+
 /* Neon mixers */
 void MixHrtf_Neon(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                   const ALfloat *data, ALsizei Offset, ALsizei OutPos,
@@ -101,6 +201,10 @@ void MixHrtfBlend_Neon(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                        const ALsizei IrSize, const HrtfParams *oldparams,
                        MixHrtfParams *newparams, HrtfState *hrtfstate,
                        ALsizei BufferSize);
+void MixHrtfInterp_Neon(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                        const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                        const ALsizei IrSize, MixHrtfInterpParams *hrtfparams,
+                        HrtfState *hrtfstate, ALsizei BufferSize);
 void MixDirectHrtf_Neon(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                         const ALfloat *data, ALsizei Offset, const ALsizei IrSize,
                         const ALfloat (*RESTRICT Coeffs)[2], ALfloat (*RESTRICT Values)[2],
@@ -111,6 +215,14 @@ void Mix_Neon(const ALfloat *data, ALsizei OutChans, ALfloat (*RESTRICT OutBuffe
 void MixRow_Neon(ALfloat *OutBuffer, const ALfloat *Gains,
                  const ALfloat (*RESTRICT data)[BUFFERSIZE], ALsizei InChans,
                  ALsizei InPos, ALsizei BufferSize);
+void MixMulti_Neon(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                   ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                   const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                   ALsizei BufferSize);
+
+/* Neon panning */
+void ComputePanGainsMC_Neon(const ChannelConfig *chancoeffs, ALsizei numchans, ALsizei numcoeffs,
+                            const PanGainTarget *targets, ALsizei count);
 
 /* Neon resamplers */
 const ALfloat *Resample_lerp_Neon(const InterpState *state, const ALfloat *RESTRICT src,
@@ -102,6 +102,74 @@ void MixHrtfBlend(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
     newparams->Gain = newGain + newGainStep*stepcount;
 }
 
+/* Reads the history at the given (non-negative) fractional delay, linearly
+ * interpolating between the two nearest samples.
+ */
+static inline ALfloat ReadDelayed(const ALfloat *RESTRICT History, ALsizei Offset,
+                                  ALfloat delay)
+{
+    const ALsizei idelay = (ALsizei)delay;
+    const ALfloat frac = delay - (ALfloat)idelay;
+    return lerp(History[(Offset-idelay)&HRTF_HISTORY_MASK],
+                History[(Offset-idelay-1)&HRTF_HISTORY_MASK], frac);
+}
+
+void MixHrtfInterp(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                   const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                   const ALsizei IrSize, MixHrtfInterpParams *hrtfparams,
+                   HrtfState *hrtfstate, ALsizei BufferSize)
+{
+    ALfloat (*RESTRICT Coeffs)[2] = hrtfparams->Coeffs;
+    const ALfloat (*RESTRICT CoeffStep)[2] = hrtfparams->CoeffStep;
+    const ALfloat Delay[2] = { hrtfparams->Delay[0], hrtfparams->Delay[1] };
+    const ALfloat DelayStep[2] = { hrtfparams->DelayStep[0], hrtfparams->DelayStep[1] };
+    const ALfloat gainstep = hrtfparams->GainStep;
+    const ALfloat gain = hrtfparams->Gain;
+    ALfloat g, stepcount = 0.0f;
+    ALfloat left, right;
+    ALsizei i, j, todo;
+
+    ASSUME(IrSize >= 4);
+    ASSUME(BufferSize > 0);
+
+    LeftOut  += OutPos;
+    RightOut += OutPos;
+    for(i = 0;i < BufferSize;i += todo)
+    {
+        todo = mini(BufferSize-i, HRTF_INTERP_STEP);
+        for(j = 0;j < todo;j++)
+        {
+            hrtfstate->History[Offset&HRTF_HISTORY_MASK] = *(data++);
+
+            g = gain + gainstep*stepcount;
+            left = ReadDelayed(hrtfstate->History, Offset, Delay[0] + DelayStep[0]*stepcount);
+            right = ReadDelayed(hrtfstate->History, Offset, Delay[1] + DelayStep[1]*stepcount);
+
+            hrtfstate->Values[(Offset+IrSize-1)&HRIR_MASK][0] = 0.0f;
+            hrtfstate->Values[(Offset+IrSize-1)&HRIR_MASK][1] = 0.0f;
+
+            ApplyCoeffs(Offset, hrtfstate->Values, IrSize, Coeffs, left*g, right*g);
+            *(LeftOut++)  += hrtfstate->Values[Offset&HRIR_MASK][0];
+            *(RightOut++) += hrtfstate->Values[Offset&HRIR_MASK][1];
+
+            stepcount += 1.0f;
+            Offset++;
+        }
+
+        /* Move the coefficients toward the target in place, so only the one
+         * set needs to be convolved.
+         */
+        for(j = 0;j < IrSize;j++)
+        {
+            Coeffs[j][0] += CoeffStep[j][0];
+            Coeffs[j][1] += CoeffStep[j][1];
+        }
+    }
+    hrtfparams->Delay[0] = Delay[0] + DelayStep[0]*stepcount;
+    hrtfparams->Delay[1] = Delay[1] + DelayStep[1]*stepcount;
+    hrtfparams->Gain = gain + gainstep*stepcount;
+}
+
 void MixDirectHrtf(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                    const ALfloat *data, ALsizei Offset, const ALsizei IrSize,
                    const ALfloat (*RESTRICT Coeffs)[2], ALfloat (*RESTRICT Values)[2],
@@ -0,0 +1,409 @@
+#include "config.h"
+
+#include <immintrin.h>
+
+#include "AL/al.h"
+#include "AL/alc.h"
+#include "alMain.h"
+#include "alu.h"
+
+#include "alSource.h"
+#include "alAuxEffectSlot.h"
+#include "defs.h"
+
+
+const ALfloat *Resample_lerp_AVX2(const InterpState* UNUSED(state),
+  const ALfloat *RESTRICT src, ALsizei frac, ALint increment,
+  ALfloat *RESTRICT dst, ALsizei numsamples)
+{
+    const __m256i increment8 = _mm256_set1_epi32(increment*8);
+    const __m256 fracOne8 = _mm256_set1_ps(1.0f/FRACTIONONE);
+    const __m256i fracMask8 = _mm256_set1_epi32(FRACTIONMASK);
+    alignas(32) ALsizei pos_[8], frac_[8];
+    __m256i frac8, pos8;
+    ALsizei todo, pos, i;
+
+    ASSUME(numsamples > 0);
+    ASSUME(increment > 0);
+    ASSUME(frac >= 0);
+
+    InitiatePositionArrays(frac, increment, frac_, pos_, 8);
+    frac8 = _mm256_load_si256(reinterpret_cast<const __m256i*>(frac_));
+    pos8 = _mm256_load_si256(reinterpret_cast<const __m256i*>(pos_));
+
+    todo = numsamples & ~7;
+    for(i = 0;i < todo;i += 8)
+    {
+        const __m256 val1 = _mm256_i32gather_ps(src, pos8, 4);
+        const __m256 val2 = _mm256_i32gather_ps(src+1, pos8, 4);
+
+        /* val1 + (val2-val1)*mu */
+        const __m256 r0 = _mm256_sub_ps(val2, val1);
+        const __m256 mu = _mm256_mul_ps(_mm256_cvtepi32_ps(frac8), fracOne8);
+        const __m256 out = _mm256_fmadd_ps(mu, r0, val1);
+
+        _mm256_storeu_ps(&dst[i], out);
+
+        frac8 = _mm256_add_epi32(frac8, increment8);
+        pos8 = _mm256_add_epi32(pos8, _mm256_srli_epi32(frac8, FRACTIONBITS));
+        frac8 = _mm256_and_si256(frac8, fracMask8);
+    }
+
+    /* NOTE: These eight elements represent the position *after* the last
+     * eight samples, so the lowest element is the next position to resample.
+     */
+    pos = _mm256_cvtsi256_si32(pos8);
+    frac = _mm256_cvtsi256_si32(frac8);
+
+    for(;i < numsamples;++i)
+    {
+        dst[i] = lerp(src[pos], src[pos+1], frac * (1.0f/FRACTIONONE));
+
+        frac += increment;
+        pos  += frac>>FRACTIONBITS;
+        frac &= FRACTIONMASK;
+    }
+    return dst;
+}
+
+const ALfloat *Resample_bsinc_AVX2(const InterpState *state, const ALfloat *RESTRICT src,
+                                   ALsizei frac, ALint increment, ALfloat *RESTRICT dst,
+                                   ALsizei dstlen)
+{
+    const ALfloat *const filter = state->bsinc.filter;
+    const __m256 sf8 = _mm256_set1_ps(state->bsinc.sf);
+    const ALsizei m = state->bsinc.m;
+    const ALfloat *fil, *scd, *phd, *spd;
+    ALsizei pi, i, j, offset;
+    ALfloat pf;
+
+    ASSUME(m > 0);
+    ASSUME(dstlen > 0);
+    ASSUME(increment > 0);
+    ASSUME(frac >= 0);
+
+    src -= state->bsinc.l;
+    for(i = 0;i < dstlen;i++)
+    {
+        // Calculate the phase index and factor.
+#define FRAC_PHASE_BITDIFF (FRACTIONBITS-BSINC_PHASE_BITS)
+        pi = frac >> FRAC_PHASE_BITDIFF;
+        pf = (frac & ((1<<FRAC_PHASE_BITDIFF)-1)) * (1.0f/(1<<FRAC_PHASE_BITDIFF));
+#undef FRAC_PHASE_BITDIFF
+
+        offset = m*pi*4;
+        fil = filter + offset; offset += m;
+        scd = filter + offset; offset += m;
+        phd = filter + offset; offset += m;
+        spd = filter + offset;
+
+        // Apply the scale and phase interpolated filter.
+        {
+            const __m256 pf8 = _mm256_set1_ps(pf);
+            __m256 r8 = _mm256_setzero_ps();
+
+            /* The filter length is a multiple of 4, so the coefficients are
+             * processed 8 at a time with a possible 4-sample remainder, which
+             * is folded in after combining the two halves of the sum.
+             */
+            for(j = 0;j < (m&~7);j += 8)
+            {
+                /* f = ((fil + sf*scd) + pf*(phd + sf*spd)) */
+                const __m256 f8 = _mm256_fmadd_ps(pf8,
+                    _mm256_fmadd_ps(sf8, _mm256_loadu_ps(&spd[j]), _mm256_loadu_ps(&phd[j])),
+                    _mm256_fmadd_ps(sf8, _mm256_loadu_ps(&scd[j]), _mm256_loadu_ps(&fil[j]))
+                );
+                /* r += f*src */
+                r8 = _mm256_fmadd_ps(f8, _mm256_loadu_ps(&src[j]), r8);
+            }
+            __m128 r4 = _mm_add_ps(_mm256_castps256_ps128(r8), _mm256_extractf128_ps(r8, 1));
+            if((m&4))
+            {
+                const __m128 sf4 = _mm256_castps256_ps128(sf8);
+                const __m128 pf4 = _mm256_castps256_ps128(pf8);
+                const __m128 f4 = _mm_fmadd_ps(pf4,
+                    _mm_fmadd_ps(sf4, _mm_loadu_ps(&spd[j]), _mm_loadu_ps(&phd[j])),
+                    _mm_fmadd_ps(sf4, _mm_loadu_ps(&scd[j]), _mm_loadu_ps(&fil[j]))
+                );
+                r4 = _mm_fmadd_ps(f4, _mm_loadu_ps(&src[j]), r4);
+            }
+            r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+            r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+            dst[i] = _mm_cvtss_f32(r4);
+        }
+
+        frac += increment;
+        src  += frac>>FRACTIONBITS;
+        frac &= FRACTIONMASK;
+    }
+    return dst;
+}
+
+
+static inline void ApplyCoeffs(ALsizei Offset, ALfloat (*RESTRICT Values)[2],
+                               const ALsizei IrSize,
+                               const ALfloat (*RESTRICT Coeffs)[2],
+                               ALfloat left, ALfloat right)
+{
+    const __m256 lrlr = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+    ALsizei i{0};
+
+    /* Values is updated in blocks of four stereo taps that stay aligned to
+     * the history ring, so each block never wraps and the next sample's loads
+     * line up with this sample's stores. Only the leading and trailing taps
+     * outside of a full block are handled individually.
+     */
+    for(;i < IrSize && ((Offset+i)&3) != 0;i++)
+    {
+        const ALsizei o{(Offset+i)&HRIR_MASK};
+        Values[o][0] += Coeffs[i][0]*left;
+        Values[o][1] += Coeffs[i][1]*right;
+    }
+    for(;IrSize-i > 3;i += 4)
+    {
+        const ALsizei o{(Offset+i)&HRIR_MASK};
+        __m256 vals = _mm256_loadu_ps(&Values[o][0]);
+        vals = _mm256_fmadd_ps(lrlr, _mm256_loadu_ps(&Coeffs[i][0]), vals);
+        _mm256_storeu_ps(&Values[o][0], vals);
+    }
+    for(;i < IrSize;i++)
+    {
+        const ALsizei o{(Offset+i)&HRIR_MASK};
+        Values[o][0] += Coeffs[i][0]*left;
+        Values[o][1] += Coeffs[i][1]*right;
+    }
+}
+
+#define MixHrtf MixHrtf_AVX2
+#define MixHrtfBlend MixHrtfBlend_AVX2
+#define MixHrtfInterp MixHrtfInterp_AVX2
+#define MixDirectHrtf MixDirectHrtf_AVX2
+#include "hrtf_inc.cpp"
+
+
+void Mix_AVX2(const ALfloat *data, ALsizei OutChans, ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE],
+              ALfloat *CurrentGains, const ALfloat *TargetGains, ALsizei Counter, ALsizei OutPos,
+              ALsizei BufferSize)
+{
+    const ALfloat delta = (Counter > 0) ? 1.0f/(ALfloat)Counter : 0.0f;
+    ALsizei c;
+
+    ASSUME(OutChans > 0);
+    ASSUME(BufferSize > 0);
+
+    for(c = 0;c < OutChans;c++)
+    {
+        ALsizei pos = 0;
+        ALfloat gain = CurrentGains[c];
+        const ALfloat diff = TargetGains[c] - gain;
+
+        if(fabsf(diff) > FLT_EPSILON)
+        {
+            ALsizei minsize = mini(BufferSize, Counter);
+            const ALfloat step = diff * delta;
+            ALfloat step_count = 0.0f;
+            /* Mix with applying gain steps in multiples of 8. */
+            if(LIKELY(minsize > 7))
+            {
+                const __m256 eight8 = _mm256_set1_ps(8.0f);
+                const __m256 step8 = _mm256_set1_ps(step);
+                const __m256 gain8 = _mm256_set1_ps(gain);
+                __m256 step_count8 = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f,
+                                                    4.0f, 5.0f, 6.0f, 7.0f);
+                ALsizei todo = minsize >> 3;
+                do {
+                    const __m256 val8 = _mm256_loadu_ps(&data[pos]);
+                    __m256 dry8 = _mm256_loadu_ps(&OutBuffer[c][OutPos+pos]);
+                    /* dry += val * (gain + step*step_count) */
+                    dry8 = _mm256_fmadd_ps(val8, _mm256_fmadd_ps(step8, step_count8, gain8),
+                                           dry8);
+                    _mm256_storeu_ps(&OutBuffer[c][OutPos+pos], dry8);
+                    step_count8 = _mm256_add_ps(step_count8, eight8);
+                    pos += 8;
+                } while(--todo);
+                /* NOTE: step_count8 now represents the next eight counts after
+                 * the last eight mixed samples, so the lowest element
+                 * represents the next step count to apply.
+                 */
+                step_count = _mm256_cvtss_f32(step_count8);
+            }
+            /* Mix with applying left over gain steps that aren't multiples of 8. */
+            for(;pos < minsize;pos++)
+            {
+                OutBuffer[c][OutPos+pos] += data[pos]*(gain + step*step_count);
+                step_count += 1.0f;
+            }
+            if(pos == Counter)
+                gain = TargetGains[c];
+            else
+                gain += step*step_count;
+            CurrentGains[c] = gain;
+
+            /* Mix until pos is aligned with 4 or the mix is done. */
+            minsize = mini(BufferSize, (pos+3)&~3);
+            for(;pos < minsize;pos++)
+                OutBuffer[c][OutPos+pos] += data[pos]*gain;
+        }
+
+        if(!(fabsf(gain) > GAIN_SILENCE_THRESHOLD))
+            continue;
+        if(LIKELY(BufferSize-pos > 7))
+        {
+            ALsizei todo = (BufferSize-pos) >> 3;
+            const __m256 gain8 = _mm256_set1_ps(gain);
+            do {
+                const __m256 val8 = _mm256_loadu_ps(&data[pos]);
+                __m256 dry8 = _mm256_loadu_ps(&OutBuffer[c][OutPos+pos]);
+                dry8 = _mm256_fmadd_ps(val8, gain8, dry8);
+                _mm256_storeu_ps(&OutBuffer[c][OutPos+pos], dry8);
+                pos += 8;
+            } while(--todo);
+        }
+        for(;pos < BufferSize;pos++)
+            OutBuffer[c][OutPos+pos] += data[pos]*gain;
+    }
+}
+
+void MixRow_AVX2(ALfloat *OutBuffer, const ALfloat *Gains, const ALfloat (*RESTRICT data)[BUFFERSIZE], ALsizei InChans, ALsizei InPos, ALsizei BufferSize)
+{
+    ALsizei c;
+
+    ASSUME(InChans > 0);
+    ASSUME(BufferSize > 0);
+
+    for(c = 0;c < InChans;c++)
+    {
+        ALsizei pos = 0;
+        const ALfloat gain = Gains[c];
+        if(!(fabsf(gain) > GAIN_SILENCE_THRESHOLD))
+            continue;
+
+        if(LIKELY(BufferSize > 7))
+        {
+            ALsizei todo = BufferSize >> 3;
+            const __m256 gain8 = _mm256_set1_ps(gain);
+            do {
+                const __m256 val8 = _mm256_loadu_ps(&data[c][InPos+pos]);
+                __m256 dry8 = _mm256_loadu_ps(&OutBuffer[pos]);
+                dry8 = _mm256_fmadd_ps(val8, gain8, dry8);
+                _mm256_storeu_ps(&OutBuffer[pos], dry8);
+                pos += 8;
+            } while(--todo);
+        }
+        for(;pos < BufferSize;pos++)
+            OutBuffer[pos] += data[c][InPos+pos]*gain;
+    }
+}
+
+void MixMulti_AVX2(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                  ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                  const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                  ALsizei BufferSize)
+{
+    const ALfloat delta = (Counter > 0) ? 1.0f/(ALfloat)Counter : 0.0f;
+    const ALsizei minsize = mini(BufferSize, Counter);
+    const ALfloat *srcs[MAX_INPUT_CHANNELS];
+    __m256 gain8[MAX_INPUT_CHANNELS];
+    __m256 step8[MAX_INPUT_CHANNELS];
+    ALsizei c, i, k, n;
+
+    ASSUME(InChans > 0 && InChans <= MAX_INPUT_CHANNELS);
+    ASSUME(OutChans > 0);
+    ASSUME(BufferSize > 0);
+
+    for(c = 0;c < OutChans;c++)
+    {
+        ALfloat *RESTRICT dst = &OutBuffer[c][OutPos];
+        ALsizei pos = 0;
+
+        if(minsize > 0)
+        {
+            n = 0;
+            for(i = 0;i < InChans;i++)
+            {
+                const ALfloat gain = CurrentGains[i][c];
+                const ALfloat diff = TargetGains[i][c] - gain;
+                if(fabsf(diff) > FLT_EPSILON)
+                {
+                    const ALfloat step = diff * delta;
+                    srcs[n] = data[i];
+                    gain8[n] = _mm256_set1_ps(gain);
+                    step8[n] = _mm256_set1_ps(step);
+                    n++;
+                    if(minsize == Counter)
+                        CurrentGains[i][c] = TargetGains[i][c];
+                    else
+                        CurrentGains[i][c] = gain + step*(ALfloat)minsize;
+                }
+                else if(fabsf(gain) > GAIN_SILENCE_THRESHOLD)
+                {
+                    srcs[n] = data[i];
+                    gain8[n] = _mm256_set1_ps(gain);
+                    step8[n] = _mm256_setzero_ps();
+                    n++;
+                }
+            }
+            if(n > 0)
+            {
+                /* Mix with applying gain steps in multiples of 8. */
+                if(LIKELY(minsize > 7))
+                {
+                    const __m256 eight8 = _mm256_set1_ps(8.0f);
+                    __m256 step_count8 = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f,
+                                                        4.0f, 5.0f, 6.0f, 7.0f);
+                    ALsizei todo = minsize >> 3;
+                    do {
+                        __m256 dry8 = _mm256_loadu_ps(&dst[pos]);
+                        /* dry += val * (gain + step*step_count) */
+                        for(k = 0;k < n;k++)
+                            dry8 = _mm256_fmadd_ps(_mm256_loadu_ps(&srcs[k][pos]),
+                                _mm256_fmadd_ps(step8[k], step_count8, gain8[k]), dry8);
+                        _mm256_storeu_ps(&dst[pos], dry8);
+                        step_count8 = _mm256_add_ps(step_count8, eight8);
+                        pos += 8;
+                    } while(--todo);
+                }
+                for(;pos < minsize;pos++)
+                {
+                    ALfloat out = dst[pos];
+                    for(k = 0;k < n;k++)
+                        out += srcs[k][pos] * (_mm256_cvtss_f32(gain8[k]) +
+                                               _mm256_cvtss_f32(step8[k])*(ALfloat)pos);
+                    dst[pos] = out;
+                }
+            }
+            pos = minsize;
+        }
+
+        n = 0;
+        for(i = 0;i < InChans;i++)
+        {
+            const ALfloat gain = CurrentGains[i][c];
+            if(!(fabsf(gain) > GAIN_SILENCE_THRESHOLD))
+                continue;
+            srcs[n] = data[i];
+            gain8[n] = _mm256_set1_ps(gain);
+            n++;
+        }
+        if(n == 0)
+            continue;
+        if(LIKELY(BufferSize-pos > 7))
+        {
+            ALsizei todo = (BufferSize-pos) >> 3;
+            do {
+                __m256 dry8 = _mm256_loadu_ps(&dst[pos]);
+                for(k = 0;k < n;k++)
+                    dry8 = _mm256_fmadd_ps(_mm256_loadu_ps(&srcs[k][pos]), gain8[k], dry8);
+                _mm256_storeu_ps(&dst[pos], dry8);
+                pos += 8;
+            } while(--todo);
+        }
+        for(;pos < BufferSize;pos++)
+        {
+            ALfloat out = dst[pos];
+            for(k = 0;k < n;k++)
+                out += srcs[k][pos] * _mm256_cvtss_f32(gain8[k]);
+            dst[pos] = out;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include "config.h"
+
+#include <immintrin.h>
+
+#include "AL/al.h"
+#include "alMain.h"
+#include "alu.h"
+#include "defs.h"
+
+
+const ALfloat *Resample_bsinc_AVX512(const InterpState *state, const ALfloat *RESTRICT src,
+                                     ALsizei frac, ALint increment, ALfloat *RESTRICT dst,
+                                     ALsizei dstlen)
+{
+    const ALfloat *const filter = state->bsinc.filter;
+    const __m512 sf16 = _mm512_set1_ps(state->bsinc.sf);
+    const ALsizei m = state->bsinc.m;
+    /* The filter length is a multiple of 4, so the last (partial) block of 16
+     * taps is handled with a lane mask instead of a scalar loop.
+     */
+    const __mmask16 tailmask = static_cast<__mmask16>((1u<<(m&15)) - 1u);
+    const ALsizei full = m & ~15;
+    const ALfloat *fil, *scd, *phd, *spd;
+    ALsizei pi, i, j, offset;
+    ALfloat pf;
+
+    ASSUME(m > 0);
+    ASSUME(dstlen > 0);
+    ASSUME(increment > 0);
+    ASSUME(frac >= 0);
+
+    src -= state->bsinc.l;
+    for(i = 0;i < dstlen;i++)
+    {
+        // Calculate the phase index and factor.
+#define FRAC_PHASE_BITDIFF (FRACTIONBITS-BSINC_PHASE_BITS)
+        pi = frac >> FRAC_PHASE_BITDIFF;
+        pf = (frac & ((1<<FRAC_PHASE_BITDIFF)-1)) * (1.0f/(1<<FRAC_PHASE_BITDIFF));
+#undef FRAC_PHASE_BITDIFF
+
+        offset = m*pi*4;
+        fil = filter + offset; offset += m;
+        scd = filter + offset; offset += m;
+        phd = filter + offset; offset += m;
+        spd = filter + offset;
+
+        // Apply the scale and phase interpolated filter.
+        {
+            const __m512 pf16 = _mm512_set1_ps(pf);
+            __m512 r16 = _mm512_setzero_ps();
+
+            for(j = 0;j < full;j += 16)
+            {
+                /* f = ((fil + sf*scd) + pf*(phd + sf*spd)) */
+                const __m512 f16 = _mm512_fmadd_ps(pf16,
+                    _mm512_fmadd_ps(sf16, _mm512_loadu_ps(&spd[j]), _mm512_loadu_ps(&phd[j])),
+                    _mm512_fmadd_ps(sf16, _mm512_loadu_ps(&scd[j]), _mm512_loadu_ps(&fil[j]))
+                );
+                /* r += f*src */
+                r16 = _mm512_fmadd_ps(f16, _mm512_loadu_ps(&src[j]), r16);
+            }
+            if(tailmask)
+            {
+                /* Masked-off lanes load as zero, so they add nothing. */
+                const __m512 f16 = _mm512_fmadd_ps(pf16,
+                    _mm512_fmadd_ps(sf16, _mm512_maskz_loadu_ps(tailmask, &spd[j]),
+                                    _mm512_maskz_loadu_ps(tailmask, &phd[j])),
+                    _mm512_fmadd_ps(sf16, _mm512_maskz_loadu_ps(tailmask, &scd[j]),
+                                    _mm512_maskz_loadu_ps(tailmask, &fil[j]))
+                );
+                r16 = _mm512_fmadd_ps(f16, _mm512_maskz_loadu_ps(tailmask, &src[j]), r16);
+            }
+
+            /* Fold the upper 256 and 128 bits of the sum down onto the lowest
+             * 128 bits, then finish the sum as the SSE version does.
+             */
+            r16 = _mm512_add_ps(r16,
+                _mm512_mask_shuffle_f32x4(r16, 0xffff, r16, r16, _MM_SHUFFLE(1, 0, 3, 2)));
+            r16 = _mm512_add_ps(r16,
+                _mm512_mask_shuffle_f32x4(r16, 0xffff, r16, r16, _MM_SHUFFLE(2, 3, 0, 1)));
+            __m128 r4{_mm512_mask_extractf32x4_ps(_mm_setzero_ps(), 0xf, r16, 0)};
+            r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+            r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+            dst[i] = _mm_cvtss_f32(r4);
+        }
+
+        frac += increment;
+        src  += frac>>FRACTIONBITS;
+        frac &= FRACTIONMASK;
+    }
+    return dst;
+}
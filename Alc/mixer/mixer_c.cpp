@@ -2,6 +2,8 @@
 
 #include <assert.h>
 
+#include <cmath>
+
 #include "alMain.h"
 #include "alu.h"
 #include "alSource.h"
@@ -117,6 +119,7 @@ static inline void ApplyCoeffs(ALsizei Offset, ALfloat (*RESTRICT Values)[2],
 
 #define MixHrtf MixHrtf_C
 #define MixHrtfBlend MixHrtfBlend_C
+#define MixHrtfInterp MixHrtfInterp_C
 #define MixDirectHrtf MixDirectHrtf_C
 #include "hrtf_inc.cpp"
 
@@ -184,3 +187,212 @@ void MixRow_C(ALfloat *OutBuffer, const ALfloat *Gains, const ALfloat (*RESTRICT
             OutBuffer[i] += data[c][InPos+i] * gain;
     }
 }
+
+/* Mixes multiple input channels, each with its own set of output gains, in
+ * one pass over each output channel. This only touches the output buffer once
+ * per output channel, rather than once per input and output channel pair.
+ */
+void MixMulti_C(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                ALsizei BufferSize)
+{
+    const ALfloat delta = (Counter > 0) ? 1.0f/(ALfloat)Counter : 0.0f;
+    const ALsizei minsize = mini(BufferSize, Counter);
+    const ALfloat *srcs[MAX_INPUT_CHANNELS];
+    ALfloat gains[MAX_INPUT_CHANNELS];
+    ALfloat steps[MAX_INPUT_CHANNELS];
+    ALsizei c, i, k, n;
+
+    ASSUME(InChans > 0 && InChans <= MAX_INPUT_CHANNELS);
+    ASSUME(OutChans > 0);
+    ASSUME(BufferSize > 0);
+
+    for(c = 0;c < OutChans;c++)
+    {
+        ALfloat *RESTRICT dst = &OutBuffer[c][OutPos];
+        ALsizei pos = 0;
+
+        if(minsize > 0)
+        {
+            n = 0;
+            for(i = 0;i < InChans;i++)
+            {
+                const ALfloat gain = CurrentGains[i][c];
+                const ALfloat diff = TargetGains[i][c] - gain;
+                if(fabsf(diff) > FLT_EPSILON)
+                {
+                    const ALfloat step = diff * delta;
+                    srcs[n] = data[i];
+                    gains[n] = gain;
+                    steps[n] = step;
+                    n++;
+                    if(minsize == Counter)
+                        CurrentGains[i][c] = TargetGains[i][c];
+                    else
+                        CurrentGains[i][c] = gain + step*(ALfloat)minsize;
+                }
+                else if(fabsf(gain) > GAIN_SILENCE_THRESHOLD)
+                {
+                    srcs[n] = data[i];
+                    gains[n] = gain;
+                    steps[n] = 0.0f;
+                    n++;
+                }
+            }
+            if(n > 0)
+            {
+                for(;pos < minsize;pos++)
+                {
+                    ALfloat out = dst[pos];
+                    for(k = 0;k < n;k++)
+                        out += srcs[k][pos] * (gains[k] + steps[k]*(ALfloat)pos);
+                    dst[pos] = out;
+                }
+            }
+            pos = minsize;
+        }
+
+        n = 0;
+        for(i = 0;i < InChans;i++)
+        {
+            const ALfloat gain = CurrentGains[i][c];
+            if(!(fabsf(gain) > GAIN_SILENCE_THRESHOLD))
+                continue;
+            srcs[n] = data[i];
+            gains[n] = gain;
+            n++;
+        }
+        if(n == 0)
+            continue;
+        for(;pos < BufferSize;pos++)
+        {
+            ALfloat out = dst[pos];
+            for(k = 0;k < n;k++)
+                out += srcs[k][pos] * gains[k];
+            dst[pos] = out;
+        }
+    }
+}
+
+/* Deinterleaves and converts the given samples, adding them into each
+ * channel's line of dst.
+ */
+void LoadShort_C(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                 ALsizei numchans, ALsizei samples)
+{
+    const ALshort *ssrc = static_cast<const ALshort*>(src);
+    ALsizei i, c;
+
+    ASSUME(numchans > 0);
+
+    for(i = 0;i < samples;i++)
+    {
+        for(c = 0;c < numchans;c++)
+            dst[c][dstpos+i] += ssrc[i*numchans + c] * (1.0f/32768.0f);
+    }
+}
+
+void LoadFloat_C(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                 ALsizei numchans, ALsizei samples)
+{
+    const ALfloat *ssrc = static_cast<const ALfloat*>(src);
+    ALsizei i, c;
+
+    ASSUME(numchans > 0);
+
+    for(i = 0;i < samples;i++)
+    {
+        for(c = 0;c < numchans;c++)
+            dst[c][dstpos+i] += ssrc[i*numchans + c];
+    }
+}
+
+/* Calculates the ambisonic coefficients for a number of directions, given as
+ * separate ambisonic Y, Z, and X components, with each order scaled by the
+ * direction's spread norms.
+ */
+void CalcAmbiCoeffsRow_C(const ALfloat *RESTRICT y, const ALfloat *RESTRICT z,
+                         const ALfloat *RESTRICT x, const ALfloat (*RESTRICT norms)[4],
+                         ALfloat (*RESTRICT coeffs)[MAX_AMBI_COEFFS], ALsizei count)
+{
+    static constexpr ALsizei CoeffOrder[MAX_AMBI_COEFFS]{
+        0, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3
+    };
+    ALsizei i, c;
+
+    for(i = 0;i < count;i++)
+    {
+        CalcAmbiCoeffs(y[i], z[i], x[i], 0.0f, coeffs[i]);
+        for(c = 0;c < MAX_AMBI_COEFFS;c++)
+            coeffs[i][c] *= norms[i][CoeffOrder[c]];
+    }
+}
+
+/* Computes the output gains for each target's coefficients, using the same
+ * channel decoder coefficients for all of them.
+ */
+void ComputePanGainsMC_C(const ChannelConfig *chancoeffs, ALsizei numchans, ALsizei numcoeffs,
+                         const PanGainTarget *targets, ALsizei count)
+{
+    ALsizei i;
+
+    ASSUME(count > 0);
+
+    for(i = 0;i < count;i++)
+        ComputePanningGainsMC(chancoeffs, numchans, numcoeffs, targets[i].Coeffs,
+                              targets[i].InGain, *targets[i].Gains);
+}
+
+
+/* Gets the magnitude and true frequency of each bin of a phase vocoder frame.
+ * The frequencies are measured in bins, found from the deviation of each
+ * bin's phase advance since the last frame from the expected one, given by
+ * phasestep in cycles per bin. The last phases, in cycles, are updated for the
+ * next frame.
+ */
+void PhaseVocoderAnalysis_C(const ALfloat (*RESTRICT bins)[2], ALfloat *RESTRICT lastphase,
+                            ALfloat *RESTRICT mags, ALfloat *RESTRICT freqs, ALfloat phasestep,
+                            ALsizei count)
+{
+    const ALfloat invstep{1.0f / phasestep};
+    ALsizei i;
+
+    ASSUME(count > 0);
+
+    for(i = 0;i < count;i++)
+    {
+        const ALfloat phase{std::atan2(bins[i][1], bins[i][0]) * (1.0f/F_TAU)};
+
+        /* Wrap the deviation to +/- half a cycle. */
+        ALfloat delta{phase - lastphase[i] - (ALfloat)i*phasestep};
+        delta -= std::floor(delta + 0.5f);
+
+        mags[i] = std::sqrt(bins[i][0]*bins[i][0] + bins[i][1]*bins[i][1]);
+        freqs[i] = (ALfloat)i + delta*invstep;
+        lastphase[i] = phase;
+    }
+}
+
+/* Advances the phase of each bin of a phase vocoder frame by its frequency,
+ * and sets the bins from the given magnitudes and the new phases.
+ */
+void PhaseVocoderSynthesis_C(const ALfloat *RESTRICT mags, const ALfloat *RESTRICT freqs,
+                             ALfloat *RESTRICT sumphase, ALfloat (*RESTRICT bins)[2],
+                             ALfloat phasestep, ALsizei count)
+{
+    ALsizei i;
+
+    ASSUME(count > 0);
+
+    for(i = 0;i < count;i++)
+    {
+        /* Keep the phase within +/- half a cycle, to maintain precision. */
+        ALfloat phase{sumphase[i] + freqs[i]*phasestep};
+        phase -= std::floor(phase + 0.5f);
+        sumphase[i] = phase;
+
+        bins[i][0] = mags[i] * std::cos(phase*F_TAU);
+        bins[i][1] = mags[i] * std::sin(phase*F_TAU);
+    }
+}
@@ -162,6 +162,7 @@ static inline void ApplyCoeffs(ALsizei Offset, ALfloat (*RESTRICT Values)[2],
 
 #define MixHrtf MixHrtf_Neon
 #define MixHrtfBlend MixHrtfBlend_Neon
+#define MixHrtfInterp MixHrtfInterp_Neon
 #define MixDirectHrtf MixDirectHrtf_Neon
 #include "hrtf_inc.cpp"
 
@@ -282,3 +283,167 @@ void MixRow_Neon(ALfloat *OutBuffer, const ALfloat *Gains, const ALfloat (*RESTR
             OutBuffer[pos] += data[c][InPos+pos]*gain;
     }
 }
+
+void MixMulti_Neon(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                  ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                  const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                  ALsizei BufferSize)
+{
+    const ALfloat delta = (Counter > 0) ? 1.0f/(ALfloat)Counter : 0.0f;
+    const ALsizei minsize = mini(BufferSize, Counter);
+    const ALfloat *srcs[MAX_INPUT_CHANNELS];
+    float32x4_t gain4[MAX_INPUT_CHANNELS];
+    float32x4_t step4[MAX_INPUT_CHANNELS];
+    ALsizei c, i, k, n;
+
+    ASSUME(InChans > 0 && InChans <= MAX_INPUT_CHANNELS);
+    ASSUME(OutChans > 0);
+    ASSUME(BufferSize > 0);
+
+    for(c = 0;c < OutChans;c++)
+    {
+        ALfloat *RESTRICT dst = &OutBuffer[c][OutPos];
+        ALsizei pos = 0;
+
+        if(minsize > 0)
+        {
+            n = 0;
+            for(i = 0;i < InChans;i++)
+            {
+                const ALfloat gain = CurrentGains[i][c];
+                const ALfloat diff = TargetGains[i][c] - gain;
+                if(fabsf(diff) > FLT_EPSILON)
+                {
+                    const ALfloat step = diff * delta;
+                    srcs[n] = data[i];
+                    gain4[n] = vdupq_n_f32(gain);
+                    step4[n] = vdupq_n_f32(step);
+                    n++;
+                    if(minsize == Counter)
+                        CurrentGains[i][c] = TargetGains[i][c];
+                    else
+                        CurrentGains[i][c] = gain + step*(ALfloat)minsize;
+                }
+                else if(fabsf(gain) > GAIN_SILENCE_THRESHOLD)
+                {
+                    srcs[n] = data[i];
+                    gain4[n] = vdupq_n_f32(gain);
+                    step4[n] = vdupq_n_f32(0.0f);
+                    n++;
+                }
+            }
+            if(n > 0)
+            {
+                /* Mix with applying gain steps in multiples of 4. */
+                if(LIKELY(minsize > 3))
+                {
+                    const float32x4_t four4 = vdupq_n_f32(4.0f);
+                    float32x4_t step_count4 = vsetq_lane_f32(0.0f,
+                        vsetq_lane_f32(1.0f,
+                        vsetq_lane_f32(2.0f,
+                        vsetq_lane_f32(3.0f, vdupq_n_f32(0.0f), 3),
+                        2), 1), 0
+                    );
+                    ALsizei todo = minsize >> 2;
+                    do {
+                        float32x4_t dry4 = vld1q_f32(&dst[pos]);
+                        /* dry += val * (gain + step*step_count) */
+                        for(k = 0;k < n;k++)
+                            dry4 = vmlaq_f32(dry4, vld1q_f32(&srcs[k][pos]),
+                                             vmlaq_f32(gain4[k], step4[k], step_count4));
+                        vst1q_f32(&dst[pos], dry4);
+                        step_count4 = vaddq_f32(step_count4, four4);
+                        pos += 4;
+                    } while(--todo);
+                }
+                for(;pos < minsize;pos++)
+                {
+                    ALfloat out = dst[pos];
+                    for(k = 0;k < n;k++)
+                        out += srcs[k][pos] * (vgetq_lane_f32(gain4[k], 0) +
+                                               vgetq_lane_f32(step4[k], 0)*(ALfloat)pos);
+                    dst[pos] = out;
+                }
+            }
+            pos = minsize;
+        }
+
+        n = 0;
+        for(i = 0;i < InChans;i++)
+        {
+            const ALfloat gain = CurrentGains[i][c];
+            if(!(fabsf(gain) > GAIN_SILENCE_THRESHOLD))
+                continue;
+            srcs[n] = data[i];
+            gain4[n] = vdupq_n_f32(gain);
+            n++;
+        }
+        if(n == 0)
+            continue;
+        if(LIKELY(BufferSize-pos > 3))
+        {
+            ALsizei todo = (BufferSize-pos) >> 2;
+            do {
+                float32x4_t dry4 = vld1q_f32(&dst[pos]);
+                for(k = 0;k < n;k++)
+                    dry4 = vmlaq_f32(dry4, vld1q_f32(&srcs[k][pos]), gain4[k]);
+                vst1q_f32(&dst[pos], dry4);
+                pos += 4;
+            } while(--todo);
+        }
+        for(;pos < BufferSize;pos++)
+        {
+            ALfloat out = dst[pos];
+            for(k = 0;k < n;k++)
+                out += srcs[k][pos] * vgetq_lane_f32(gain4[k], 0);
+            dst[pos] = out;
+        }
+    }
+}
+
+void ComputePanGainsMC_Neon(const ChannelConfig *chancoeffs, ALsizei numchans, ALsizei numcoeffs,
+                            const PanGainTarget *targets, ALsizei count)
+{
+    alignas(16) static const ALfloat offsets[4]{ 0.0f, 1.0f, 2.0f, 3.0f };
+    const ALsizei numvecs = (numcoeffs+3) >> 2;
+    const float32x4_t numcoeffs4 = vdupq_n_f32((ALfloat)numcoeffs);
+    uint32x4_t mask4[MAX_AMBI_COEFFS/4];
+    ALsizei i, c, v;
+
+    ASSUME(numchans > 0);
+    ASSUME(numcoeffs > 0 && numcoeffs <= MAX_AMBI_COEFFS);
+    ASSUME(count > 0);
+
+    /* Mask off the coefficients past the count in the last vector, so they
+     * don't contribute to the gains.
+     */
+    for(v = 0;v < numvecs;v++)
+    {
+        const float32x4_t idx4 = vaddq_f32(vld1q_f32(offsets), vdupq_n_f32((ALfloat)(v*4)));
+        mask4[v] = vcltq_f32(idx4, numcoeffs4);
+    }
+
+    for(i = 0;i < count;i++)
+    {
+        ALfloat (&gains)[MAX_OUTPUT_CHANNELS] = *targets[i].Gains;
+        const ALfloat *RESTRICT coeffs = targets[i].Coeffs;
+        float32x4_t coeffs4[MAX_AMBI_COEFFS/4];
+
+        for(v = 0;v < numvecs;v++)
+            coeffs4[v] = vreinterpretq_f32_u32(vandq_u32(
+                vreinterpretq_u32_f32(vld1q_f32(&coeffs[v*4])), mask4[v]));
+
+        for(c = 0;c < numchans;c++)
+        {
+            float32x4_t gain4 = vmulq_f32(vld1q_f32(&chancoeffs[c][0]), coeffs4[0]);
+            float32x2_t gain2;
+            for(v = 1;v < numvecs;v++)
+                gain4 = vmlaq_f32(gain4, vld1q_f32(&chancoeffs[c][v*4]), coeffs4[v]);
+            gain2 = vadd_f32(vget_low_f32(gain4), vget_high_f32(gain4));
+            gain2 = vpadd_f32(gain2, gain2);
+            gains[c] = clampf(vget_lane_f32(gain2, 0), 0.0f, 1.0f) * targets[i].InGain;
+        }
+        for(;c < MAX_OUTPUT_CHANNELS;c++)
+            gains[c] = 0.0f;
+    }
+}
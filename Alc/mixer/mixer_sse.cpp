@@ -131,6 +131,7 @@ static inline void ApplyCoeffs(ALsizei Offset, ALfloat (*RESTRICT Values)[2],
 
 #define MixHrtf MixHrtf_SSE
 #define MixHrtfBlend MixHrtfBlend_SSE
+#define MixHrtfInterp MixHrtfInterp_SSE
 #define MixDirectHrtf MixDirectHrtf_SSE
 #include "hrtf_inc.cpp"
 
@@ -248,3 +249,233 @@ void MixRow_SSE(ALfloat *OutBuffer, const ALfloat *Gains, const ALfloat (*RESTRI
             OutBuffer[pos] += data[c][InPos+pos]*gain;
     }
 }
+
+void MixMulti_SSE(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                  ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE], ALfloat *const *CurrentGains,
+                  const ALfloat *const *TargetGains, ALsizei Counter, ALsizei OutPos,
+                  ALsizei BufferSize)
+{
+    const ALfloat delta = (Counter > 0) ? 1.0f/(ALfloat)Counter : 0.0f;
+    const ALsizei minsize = mini(BufferSize, Counter);
+    const ALfloat *srcs[MAX_INPUT_CHANNELS];
+    __m128 gain4[MAX_INPUT_CHANNELS];
+    __m128 step4[MAX_INPUT_CHANNELS];
+    ALsizei c, i, k, n;
+
+    ASSUME(InChans > 0 && InChans <= MAX_INPUT_CHANNELS);
+    ASSUME(OutChans > 0);
+    ASSUME(BufferSize > 0);
+
+    for(c = 0;c < OutChans;c++)
+    {
+        ALfloat *RESTRICT dst = &OutBuffer[c][OutPos];
+        ALsizei pos = 0;
+
+        if(minsize > 0)
+        {
+            n = 0;
+            for(i = 0;i < InChans;i++)
+            {
+                const ALfloat gain = CurrentGains[i][c];
+                const ALfloat diff = TargetGains[i][c] - gain;
+                if(fabsf(diff) > FLT_EPSILON)
+                {
+                    const ALfloat step = diff * delta;
+                    srcs[n] = data[i];
+                    gain4[n] = _mm_set1_ps(gain);
+                    step4[n] = _mm_set1_ps(step);
+                    n++;
+                    if(minsize == Counter)
+                        CurrentGains[i][c] = TargetGains[i][c];
+                    else
+                        CurrentGains[i][c] = gain + step*(ALfloat)minsize;
+                }
+                else if(fabsf(gain) > GAIN_SILENCE_THRESHOLD)
+                {
+                    srcs[n] = data[i];
+                    gain4[n] = _mm_set1_ps(gain);
+                    step4[n] = _mm_setzero_ps();
+                    n++;
+                }
+            }
+            if(n > 0)
+            {
+                /* Mix with applying gain steps in multiples of 4. */
+                if(LIKELY(minsize > 3))
+                {
+                    const __m128 four4 = _mm_set1_ps(4.0f);
+                    __m128 step_count4 = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+                    ALsizei todo = minsize >> 2;
+                    do {
+                        __m128 dry4 = _mm_loadu_ps(&dst[pos]);
+#define MLA4(x, y, z) _mm_add_ps(x, _mm_mul_ps(y, z))
+                        /* dry += val * (gain + step*step_count) */
+                        for(k = 0;k < n;k++)
+                            dry4 = MLA4(dry4, _mm_loadu_ps(&srcs[k][pos]),
+                                        MLA4(gain4[k], step4[k], step_count4));
+#undef MLA4
+                        _mm_storeu_ps(&dst[pos], dry4);
+                        step_count4 = _mm_add_ps(step_count4, four4);
+                        pos += 4;
+                    } while(--todo);
+                }
+                for(;pos < minsize;pos++)
+                {
+                    ALfloat out = dst[pos];
+                    for(k = 0;k < n;k++)
+                        out += srcs[k][pos] * (_mm_cvtss_f32(gain4[k]) +
+                                               _mm_cvtss_f32(step4[k])*(ALfloat)pos);
+                    dst[pos] = out;
+                }
+            }
+            pos = minsize;
+        }
+
+        n = 0;
+        for(i = 0;i < InChans;i++)
+        {
+            const ALfloat gain = CurrentGains[i][c];
+            if(!(fabsf(gain) > GAIN_SILENCE_THRESHOLD))
+                continue;
+            srcs[n] = data[i];
+            gain4[n] = _mm_set1_ps(gain);
+            n++;
+        }
+        if(n == 0)
+            continue;
+        if(LIKELY(BufferSize-pos > 3))
+        {
+            ALsizei todo = (BufferSize-pos) >> 2;
+            do {
+                __m128 dry4 = _mm_loadu_ps(&dst[pos]);
+                for(k = 0;k < n;k++)
+                    dry4 = _mm_add_ps(dry4, _mm_mul_ps(_mm_loadu_ps(&srcs[k][pos]), gain4[k]));
+                _mm_storeu_ps(&dst[pos], dry4);
+                pos += 4;
+            } while(--todo);
+        }
+        for(;pos < BufferSize;pos++)
+        {
+            ALfloat out = dst[pos];
+            for(k = 0;k < n;k++)
+                out += srcs[k][pos] * _mm_cvtss_f32(gain4[k]);
+            dst[pos] = out;
+        }
+    }
+}
+
+void CalcAmbiCoeffsRow_SSE(const ALfloat *RESTRICT y, const ALfloat *RESTRICT z,
+                           const ALfloat *RESTRICT x, const ALfloat (*RESTRICT norms)[4],
+                           ALfloat (*RESTRICT coeffs)[MAX_AMBI_COEFFS], ALsizei count)
+{
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    const __m128 three4 = _mm_set1_ps(3.0f);
+    const __m128 five4 = _mm_set1_ps(5.0f);
+    ALsizei i = 0;
+
+    /* Calculate four directions at a time, with each coefficient in its own
+     * vector, then transpose them back into the output rows.
+     */
+    for(;count-i > 3;i += 4)
+    {
+        const __m128 y4 = _mm_loadu_ps(&y[i]);
+        const __m128 z4 = _mm_loadu_ps(&z[i]);
+        const __m128 x4 = _mm_loadu_ps(&x[i]);
+        const __m128 xx4 = _mm_mul_ps(x4, x4);
+        const __m128 yy4 = _mm_mul_ps(y4, y4);
+        const __m128 zz4 = _mm_mul_ps(z4, z4);
+        const __m128 xxmyy4 = _mm_sub_ps(xx4, yy4);
+        const __m128 zz5m1 = _mm_sub_ps(_mm_mul_ps(zz4, five4), one4);
+        __m128 n0 = _mm_loadu_ps(norms[i+0]);
+        __m128 n1 = _mm_loadu_ps(norms[i+1]);
+        __m128 n2 = _mm_loadu_ps(norms[i+2]);
+        __m128 n3 = _mm_loadu_ps(norms[i+3]);
+        __m128 c[MAX_AMBI_COEFFS];
+        ALsizei k;
+
+        _MM_TRANSPOSE4_PS(n0, n1, n2, n3);
+
+#define MUL2(a, b) _mm_mul_ps(a, b)
+#define CONST4(v) _mm_set1_ps(v)
+        /* Zeroth-order */
+        c[0]  = n0;
+        /* First-order */
+        c[1]  = MUL2(MUL2(CONST4(SQRTF_3), y4), n1);
+        c[2]  = MUL2(MUL2(CONST4(SQRTF_3), z4), n1);
+        c[3]  = MUL2(MUL2(CONST4(SQRTF_3), x4), n1);
+        /* Second-order */
+        c[4]  = MUL2(MUL2(MUL2(CONST4(3.872983346f), x4), y4), n2);
+        c[5]  = MUL2(MUL2(MUL2(CONST4(3.872983346f), y4), z4), n2);
+        c[6]  = MUL2(MUL2(CONST4(1.118033989f), _mm_sub_ps(MUL2(zz4, three4), one4)), n2);
+        c[7]  = MUL2(MUL2(MUL2(CONST4(3.872983346f), x4), z4), n2);
+        c[8]  = MUL2(MUL2(CONST4(1.936491673f), xxmyy4), n2);
+        /* Third-order */
+        c[9]  = MUL2(MUL2(MUL2(CONST4(2.091650066f), y4), _mm_sub_ps(MUL2(xx4, three4), yy4)), n3);
+        c[10] = MUL2(MUL2(MUL2(MUL2(CONST4(10.246950766f), z4), x4), y4), n3);
+        c[11] = MUL2(MUL2(MUL2(CONST4(1.620185175f), y4), zz5m1), n3);
+        c[12] = MUL2(MUL2(MUL2(CONST4(1.322875656f), z4),
+                          _mm_sub_ps(MUL2(zz4, five4), three4)), n3);
+        c[13] = MUL2(MUL2(MUL2(CONST4(1.620185175f), x4), zz5m1), n3);
+        c[14] = MUL2(MUL2(MUL2(CONST4(5.123475383f), z4), xxmyy4), n3);
+        c[15] = MUL2(MUL2(MUL2(CONST4(2.091650066f), x4), _mm_sub_ps(xx4, MUL2(yy4, three4))), n3);
+#undef CONST4
+#undef MUL2
+
+        for(k = 0;k < MAX_AMBI_COEFFS;k += 4)
+        {
+            _MM_TRANSPOSE4_PS(c[k+0], c[k+1], c[k+2], c[k+3]);
+            _mm_storeu_ps(&coeffs[i+0][k], c[k+0]);
+            _mm_storeu_ps(&coeffs[i+1][k], c[k+1]);
+            _mm_storeu_ps(&coeffs[i+2][k], c[k+2]);
+            _mm_storeu_ps(&coeffs[i+3][k], c[k+3]);
+        }
+    }
+    if(i < count)
+        CalcAmbiCoeffsRow_C(y+i, z+i, x+i, norms+i, coeffs+i, count-i);
+}
+
+void ComputePanGainsMC_SSE(const ChannelConfig *chancoeffs, ALsizei numchans, ALsizei numcoeffs,
+                           const PanGainTarget *targets, ALsizei count)
+{
+    const ALsizei numvecs = (numcoeffs+3) >> 2;
+    const __m128 numcoeffs4 = _mm_set1_ps((ALfloat)numcoeffs);
+    __m128 mask4[MAX_AMBI_COEFFS/4];
+    ALsizei i, c, v;
+
+    ASSUME(numchans > 0);
+    ASSUME(numcoeffs > 0 && numcoeffs <= MAX_AMBI_COEFFS);
+    ASSUME(count > 0);
+
+    /* Mask off the coefficients past the count in the last vector, so they
+     * don't contribute to the gains.
+     */
+    for(v = 0;v < numvecs;v++)
+    {
+        const __m128 idx4 = _mm_setr_ps((ALfloat)(v*4+0), (ALfloat)(v*4+1),
+                                        (ALfloat)(v*4+2), (ALfloat)(v*4+3));
+        mask4[v] = _mm_cmplt_ps(idx4, numcoeffs4);
+    }
+
+    for(i = 0;i < count;i++)
+    {
+        ALfloat (&gains)[MAX_OUTPUT_CHANNELS] = *targets[i].Gains;
+        const ALfloat *RESTRICT coeffs = targets[i].Coeffs;
+        __m128 coeffs4[MAX_AMBI_COEFFS/4];
+
+        for(v = 0;v < numvecs;v++)
+            coeffs4[v] = _mm_and_ps(_mm_loadu_ps(&coeffs[v*4]), mask4[v]);
+
+        for(c = 0;c < numchans;c++)
+        {
+            __m128 gain4 = _mm_mul_ps(_mm_loadu_ps(&chancoeffs[c][0]), coeffs4[0]);
+            for(v = 1;v < numvecs;v++)
+                gain4 = _mm_add_ps(gain4, _mm_mul_ps(_mm_loadu_ps(&chancoeffs[c][v*4]),
+                                                     coeffs4[v]));
+            gain4 = _mm_add_ps(gain4, _mm_movehl_ps(gain4, gain4));
+            gain4 = _mm_add_ss(gain4, _mm_shuffle_ps(gain4, gain4, _MM_SHUFFLE(1,1,1,1)));
+            gains[c] = clampf(_mm_cvtss_f32(gain4), 0.0f, 1.0f) * targets[i].InGain;
+        }
+        for(;c < MAX_OUTPUT_CHANNELS;c++)
+            gains[c] = 0.0f;
+    }
+}
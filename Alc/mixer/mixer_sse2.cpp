@@ -23,6 +23,9 @@
 #include <xmmintrin.h>
 #include <emmintrin.h>
 
+#include <cfloat>
+#include <algorithm>
+
 #include "alu.h"
 #include "defs.h"
 
@@ -84,3 +87,257 @@ const ALfloat *Resample_lerp_SSE2(const InterpState* UNUSED(state),
     }
     return dst;
 }
+
+
+static inline __m128 LoadFour(const ALfloat *src)
+{ return _mm_loadu_ps(src); }
+static inline __m128 LoadFour(const ALshort *src)
+{
+    /* Sign-extend the four 16-bit samples to 32-bit, then convert. */
+    const __m128i vals = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    const __m128i ivals = _mm_srai_epi32(_mm_unpacklo_epi16(vals, vals), 16);
+    return _mm_mul_ps(_mm_cvtepi32_ps(ivals), _mm_set1_ps(1.0f/32768.0f));
+}
+
+static inline ALfloat LoadOne(ALfloat val)
+{ return val; }
+static inline ALfloat LoadOne(ALshort val)
+{ return val * (1.0f/32768.0f); }
+
+static inline void AddFour(ALfloat *dst, const __m128 vals)
+{ _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), vals)); }
+
+/* Deinterleaves four sample frames at a time. Mono and stereo are handled
+ * with plain loads and shuffles, while four or more channels are transposed in
+ * groups of four (the last group overlapping the previous one if needed, with
+ * only the new channels being stored). Three channels, and any remaining
+ * frames, are done one sample at a time.
+ */
+template<typename T>
+static void LoadDeinterleaved(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos,
+                              const T *RESTRICT src, ALsizei numchans, ALsizei samples)
+{
+    ALsizei i{0};
+
+    ASSUME(numchans > 0);
+
+    if(numchans == 1)
+    {
+        for(;samples-i > 3;i += 4)
+            AddFour(&dst[0][dstpos+i], LoadFour(&src[i]));
+    }
+    else if(numchans == 2)
+    {
+        for(;samples-i > 3;i += 4)
+        {
+            const __m128 lrlr0 = LoadFour(&src[i*2]);
+            const __m128 lrlr1 = LoadFour(&src[i*2 + 4]);
+            AddFour(&dst[0][dstpos+i], _mm_shuffle_ps(lrlr0, lrlr1, _MM_SHUFFLE(2, 0, 2, 0)));
+            AddFour(&dst[1][dstpos+i], _mm_shuffle_ps(lrlr0, lrlr1, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+    else if(numchans >= 4)
+    {
+        for(;samples-i > 3;i += 4)
+        {
+            const T *frames{&src[i*numchans]};
+            for(ALsizei cg{0};cg < numchans;cg += 4)
+            {
+                const ALsizei c0{mini(cg, numchans-4)};
+                __m128 row0{LoadFour(&frames[c0])};
+                __m128 row1{LoadFour(&frames[numchans + c0])};
+                __m128 row2{LoadFour(&frames[numchans*2 + c0])};
+                __m128 row3{LoadFour(&frames[numchans*3 + c0])};
+                _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                if(c0 >= cg)
+                    AddFour(&dst[c0][dstpos+i], row0);
+                if(c0+1 >= cg)
+                    AddFour(&dst[c0+1][dstpos+i], row1);
+                if(c0+2 >= cg)
+                    AddFour(&dst[c0+2][dstpos+i], row2);
+                AddFour(&dst[c0+3][dstpos+i], row3);
+            }
+        }
+    }
+
+    for(;i < samples;i++)
+    {
+        for(ALsizei c{0};c < numchans;c++)
+            dst[c][dstpos+i] += LoadOne(src[i*numchans + c]);
+    }
+}
+
+void LoadShort_SSE2(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                    ALsizei numchans, ALsizei samples)
+{
+    LoadDeinterleaved(dst, dstpos, static_cast<const ALshort*>(src), numchans, samples);
+}
+
+void LoadFloat_SSE2(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const ALvoid *src,
+                    ALsizei numchans, ALsizei samples)
+{
+    LoadDeinterleaved(dst, dstpos, static_cast<const ALfloat*>(src), numchans, samples);
+}
+
+
+/* Rounds to the nearest integer, assuming the default rounding mode. */
+static inline __m128 RoundFour(const __m128 vals)
+{ return _mm_cvtepi32_ps(_mm_cvtps_epi32(vals)); }
+
+/* Approximates atan2(y, x), in cycles rather than radians. Arctangents of
+ * [0,1] use a polynomial with an error of at most 1e-5 radians (Abramowitz and
+ * Stegun, 4.4.49), and are reflected into the other octants.
+ */
+static inline __m128 Atan2CyclesFour(const __m128 y, const __m128 x)
+{
+    const __m128 signmask{_mm_set1_ps(-0.0f)};
+    const __m128 ax{_mm_andnot_ps(signmask, x)};
+    const __m128 ay{_mm_andnot_ps(signmask, y)};
+    /* Avoid dividing 0 by 0 when both are 0. */
+    const __m128 t{_mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay),
+                                                             _mm_set1_ps(FLT_MIN)))};
+    const __m128 t2{_mm_mul_ps(t, t)};
+
+    __m128 r{_mm_set1_ps(0.0208351f)};
+    r = _mm_add_ps(_mm_mul_ps(r, t2), _mm_set1_ps(-0.0851330f));
+    r = _mm_add_ps(_mm_mul_ps(r, t2), _mm_set1_ps(0.1801410f));
+    r = _mm_add_ps(_mm_mul_ps(r, t2), _mm_set1_ps(-0.3302995f));
+    r = _mm_add_ps(_mm_mul_ps(r, t2), _mm_set1_ps(0.9998660f));
+    r = _mm_mul_ps(r, _mm_mul_ps(t, _mm_set1_ps(1.0f/F_TAU)));
+
+    __m128 mask{_mm_cmpgt_ps(ay, ax)};
+    r = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(_mm_set1_ps(0.25f), r)), _mm_andnot_ps(mask, r));
+    mask = _mm_cmplt_ps(x, _mm_setzero_ps());
+    r = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(_mm_set1_ps(0.5f), r)), _mm_andnot_ps(mask, r));
+    return _mm_xor_ps(r, _mm_and_ps(signmask, y));
+}
+
+/* Approximates the sine and cosine of phases given in cycles, within +/- half
+ * a cycle. The phases are split into the nearest quarter cycle and a remainder
+ * of at most an eighth of a cycle, whose sine and cosine are found with Taylor
+ * series (to within 3e-7), then rotated by the quarter cycles.
+ */
+static inline void SinCosCyclesFour(const __m128 phase, __m128 *RESTRICT sinout,
+                                    __m128 *RESTRICT cosout)
+{
+    const __m128i quad{_mm_cvtps_epi32(_mm_mul_ps(phase, _mm_set1_ps(4.0f)))};
+    const __m128 x{_mm_mul_ps(_mm_sub_ps(phase, _mm_mul_ps(_mm_cvtepi32_ps(quad),
+        _mm_set1_ps(0.25f))), _mm_set1_ps(F_TAU))};
+    const __m128 x2{_mm_mul_ps(x, x)};
+
+    __m128 s{_mm_set1_ps(-1.0f/5040.0f)};
+    s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f/120.0f));
+    s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.0f/6.0f));
+    s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f));
+    s = _mm_mul_ps(s, x);
+
+    __m128 c{_mm_set1_ps(1.0f/40320.0f)};
+    c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.0f/720.0f));
+    c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f/24.0f));
+    c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-0.5f));
+    c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f));
+
+    /* Odd quarters swap the sine and cosine. The sine is negated for quarters
+     * 2 and 3, and the cosine for quarters 1 and 2.
+     */
+    const __m128i one{_mm_set1_epi32(1)}, two{_mm_set1_epi32(2)};
+    const __m128 swap{_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quad, one), one))};
+    const __m128 sinsign{_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quad, two), 30))};
+    const __m128 cossign{_mm_castsi128_ps(_mm_slli_epi32(
+        _mm_and_si128(_mm_add_epi32(quad, one), two), 30))};
+
+    *sinout = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sinsign);
+    *cosout = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cossign);
+}
+
+static inline void AnalyzeFour(const ALfloat *RESTRICT bins, ALfloat *RESTRICT lastphase,
+                               ALfloat *RESTRICT mags, ALfloat *RESTRICT freqs,
+                               const __m128 binidx, const __m128 phasestep,
+                               const __m128 invstep)
+{
+    const __m128 bins01{_mm_loadu_ps(bins)};
+    const __m128 bins23{_mm_loadu_ps(bins+4)};
+    const __m128 re{_mm_shuffle_ps(bins01, bins23, _MM_SHUFFLE(2,0,2,0))};
+    const __m128 im{_mm_shuffle_ps(bins01, bins23, _MM_SHUFFLE(3,1,3,1))};
+
+    const __m128 phase{Atan2CyclesFour(im, re)};
+    __m128 delta{_mm_sub_ps(_mm_sub_ps(phase, _mm_loadu_ps(lastphase)),
+                            _mm_mul_ps(binidx, phasestep))};
+    delta = _mm_sub_ps(delta, RoundFour(delta));
+
+    _mm_storeu_ps(mags, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im))));
+    _mm_storeu_ps(freqs, _mm_add_ps(binidx, _mm_mul_ps(delta, invstep)));
+    _mm_storeu_ps(lastphase, phase);
+}
+
+void PhaseVocoderAnalysis_SSE2(const ALfloat (*RESTRICT bins)[2], ALfloat *RESTRICT lastphase,
+                               ALfloat *RESTRICT mags, ALfloat *RESTRICT freqs,
+                               ALfloat phasestep, ALsizei count)
+{
+    const __m128 step4{_mm_set1_ps(phasestep)};
+    const __m128 invstep4{_mm_set1_ps(1.0f / phasestep)};
+    __m128 binidx4{_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)};
+    ALsizei i{0};
+
+    ASSUME(count > 0);
+
+    for(;count-i > 3;i += 4)
+    {
+        AnalyzeFour(bins[i], &lastphase[i], &mags[i], &freqs[i], binidx4, step4, invstep4);
+        binidx4 = _mm_add_ps(binidx4, _mm_set1_ps(4.0f));
+    }
+    if(i < count)
+    {
+        /* Do the remaining bins with zero-padded copies. */
+        const ALsizei rem{count - i};
+        alignas(16) ALfloat tbins[4][2]{}, tlast[4]{}, tmags[4], tfreqs[4];
+        std::copy_n(bins[i], rem*2, tbins[0]);
+        std::copy_n(&lastphase[i], rem, tlast);
+        AnalyzeFour(tbins[0], tlast, tmags, tfreqs, binidx4, step4, invstep4);
+        std::copy_n(tlast, rem, &lastphase[i]);
+        std::copy_n(tmags, rem, &mags[i]);
+        std::copy_n(tfreqs, rem, &freqs[i]);
+    }
+}
+
+static inline void SynthesizeFour(const ALfloat *RESTRICT mags, const ALfloat *RESTRICT freqs,
+                                  ALfloat *RESTRICT sumphase, ALfloat *RESTRICT bins,
+                                  const __m128 phasestep)
+{
+    __m128 phase{_mm_add_ps(_mm_loadu_ps(sumphase),
+                            _mm_mul_ps(_mm_loadu_ps(freqs), phasestep))};
+    phase = _mm_sub_ps(phase, RoundFour(phase));
+    _mm_storeu_ps(sumphase, phase);
+
+    __m128 s, c;
+    SinCosCyclesFour(phase, &s, &c);
+    const __m128 mag{_mm_loadu_ps(mags)};
+    const __m128 re{_mm_mul_ps(mag, c)};
+    const __m128 im{_mm_mul_ps(mag, s)};
+    _mm_storeu_ps(bins, _mm_unpacklo_ps(re, im));
+    _mm_storeu_ps(bins+4, _mm_unpackhi_ps(re, im));
+}
+
+void PhaseVocoderSynthesis_SSE2(const ALfloat *RESTRICT mags, const ALfloat *RESTRICT freqs,
+                                ALfloat *RESTRICT sumphase, ALfloat (*RESTRICT bins)[2],
+                                ALfloat phasestep, ALsizei count)
+{
+    const __m128 step4{_mm_set1_ps(phasestep)};
+    ALsizei i{0};
+
+    ASSUME(count > 0);
+
+    for(;count-i > 3;i += 4)
+        SynthesizeFour(&mags[i], &freqs[i], &sumphase[i], bins[i], step4);
+    if(i < count)
+    {
+        const ALsizei rem{count - i};
+        alignas(16) ALfloat tmags[4]{}, tfreqs[4]{}, tsum[4]{}, tbins[4][2];
+        std::copy_n(&mags[i], rem, tmags);
+        std::copy_n(&freqs[i], rem, tfreqs);
+        std::copy_n(&sumphase[i], rem, tsum);
+        SynthesizeFour(tmags, tfreqs, tsum, tbins[0], step4);
+        std::copy_n(tsum, rem, &sumphase[i]);
+        std::copy_n(tbins[0], rem*2, bins[i]);
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 2018 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include "mixerpool.h"
+
+#include <functional>
+
+#include "alMain.h"
+#include "fpu_modes.h"
+
+
+MixerPool::MixerPool(size_t numthreads)
+{
+    mWorkers.reserve(numthreads > 1 ? numthreads-1 : 0);
+    for(size_t i{1};i < numthreads;i++)
+    {
+        mWorkers.emplace_back(new Worker{});
+        try {
+            mWorkers.back()->mThread = std::thread{std::mem_fn(&MixerPool::workerProc), this,
+                mWorkers.back().get(), i};
+        }
+        catch(std::exception& e) {
+            ERR("Failed to start mixer thread " SZFMT ": %s\n", i, e.what());
+            mWorkers.pop_back();
+            break;
+        }
+    }
+    TRACE("Created mixer pool with " SZFMT " thread%s\n", size(), (size()==1)?"":"s");
+}
+
+MixerPool::~MixerPool()
+{
+    mQuit.store(true, std::memory_order_release);
+    for(auto &worker : mWorkers)
+    {
+        worker->mStart.post();
+        worker->mThread.join();
+    }
+    mWorkers.clear();
+}
+
+
+void MixerPool::doJobs(size_t thread)
+{
+    ALsizei job;
+    while((job=mNextJob.fetch_add(1, std::memory_order_relaxed)) < mNumJobs)
+        mTask(mUserData, thread, job);
+}
+
+FORCE_ALIGN int MixerPool::workerProc(Worker *self, size_t thread)
+{
+    SetRTPriority();
+    althrd_setname(MIXER_THREAD_NAME);
+
+    /* Match the denormal handling of the main mixer thread. */
+    FPUCtl mixer_mode{};
+    while(1)
+    {
+        self->mStart.wait();
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+
+        doJobs(thread);
+        mDone.post();
+    }
+
+    return 0;
+}
+
+
+void MixerPool::run(ALsizei numjobs, TaskFunc task, void *userdata)
+{
+    mTask = task;
+    mUserData = userdata;
+    mNumJobs = numjobs;
+    mNextJob.store(0, std::memory_order_relaxed);
+
+    /* The semaphores provide the necessary synchronization for the job info
+     * and the results.
+     */
+    for(auto &worker : mWorkers)
+        worker->mStart.post();
+
+    doJobs(0);
+
+    for(size_t i{0};i < mWorkers.size();i++)
+        mDone.wait();
+}
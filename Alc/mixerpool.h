@@ -0,0 +1,65 @@
+#ifndef MIXERPOOL_H
+#define MIXERPOOL_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "AL/al.h"
+
+#include "threads.h"
+#include "vector.h"
+#include "almalloc.h"
+
+
+/* A fixed set of helper threads the mixer can hand work off to. Work is given
+ * as a count of jobs, which the participating threads pull from a shared
+ * counter until all are done. The calling thread always participates as
+ * thread index 0, so a pool of N threads only spawns N-1 helpers.
+ */
+class MixerPool {
+public:
+    using TaskFunc = void(*)(void *userdata, size_t thread, ALsizei job);
+
+private:
+    struct Worker {
+        std::thread mThread;
+        al::semaphore mStart;
+    };
+    al::vector<std::unique_ptr<Worker>> mWorkers;
+    al::semaphore mDone;
+    std::atomic<bool> mQuit{false};
+
+    TaskFunc mTask{nullptr};
+    void *mUserData{nullptr};
+    ALsizei mNumJobs{0};
+    std::atomic<ALsizei> mNextJob{0};
+
+    void doJobs(size_t thread);
+    int workerProc(Worker *self, size_t thread);
+
+public:
+    MixerPool(size_t numthreads);
+    MixerPool(const MixerPool&) = delete;
+    MixerPool& operator=(const MixerPool&) = delete;
+    ~MixerPool();
+
+    /* Total number of threads that can process jobs, including the caller. */
+    size_t size() const noexcept { return mWorkers.size() + 1; }
+
+    /* Runs numjobs jobs across the pool, returning once all have completed. */
+    void run(ALsizei numjobs, TaskFunc task, void *userdata);
+
+    template<typename F>
+    void run(ALsizei numjobs, F &func)
+    {
+        run(numjobs,
+            [](void *userdata, size_t thread, ALsizei job) -> void
+            { (*static_cast<F*>(userdata))(thread, job); },
+            &func);
+    }
+
+    DEF_NEWDEL(MixerPool)
+};
+
+#endif /* MIXERPOOL_H */
@@ -39,6 +39,7 @@
 #include "alu.h"
 #include "alconfig.h"
 #include "ringbuffer.h"
+#include "alcomplex.h"
 
 #include "cpu_caps.h"
 #include "mixer/defs.h"
@@ -55,8 +56,12 @@ enum Resampler ResamplerDefault = LinearResampler;
 
 MixerFunc MixSamples = Mix_C;
 RowMixerFunc MixRowSamples = MixRow_C;
+static MultiMixerFunc MixMultiSamples = MixMulti_C;
+static SampleLoaderFunc LoadShortSamples = LoadShort_C;
+static SampleLoaderFunc LoadFloatSamples = LoadFloat_C;
 static HrtfMixerFunc MixHrtfSamples = MixHrtf_C;
 static HrtfMixerBlendFunc MixHrtfBlendSamples = MixHrtfBlend_C;
+static HrtfMixerInterpFunc MixHrtfInterpSamples = MixHrtfInterp_C;
 
 static MixerFunc SelectMixer(void)
 {
@@ -64,6 +69,10 @@ static MixerFunc SelectMixer(void)
     if((CPUCapFlags&CPU_CAP_NEON))
         return Mix_Neon;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return Mix_AVX2;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return Mix_SSE;
@@ -77,6 +86,10 @@ static RowMixerFunc SelectRowMixer(void)
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixRow_Neon;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixRow_AVX2;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixRow_SSE;
@@ -84,12 +97,51 @@ static RowMixerFunc SelectRowMixer(void)
     return MixRow_C;
 }
 
+static MultiMixerFunc SelectMultiMixer(void)
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return MixMulti_Neon;
+#endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixMulti_AVX2;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return MixMulti_SSE;
+#endif
+    return MixMulti_C;
+}
+
+static SampleLoaderFunc SelectShortLoader(void)
+{
+#ifdef HAVE_SSE2
+    if((CPUCapFlags&CPU_CAP_SSE2))
+        return LoadShort_SSE2;
+#endif
+    return LoadShort_C;
+}
+
+static SampleLoaderFunc SelectFloatLoader(void)
+{
+#ifdef HAVE_SSE2
+    if((CPUCapFlags&CPU_CAP_SSE2))
+        return LoadFloat_SSE2;
+#endif
+    return LoadFloat_C;
+}
+
 static inline HrtfMixerFunc SelectHrtfMixer(void)
 {
 #ifdef HAVE_NEON
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixHrtf_Neon;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixHrtf_AVX2;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixHrtf_SSE;
@@ -103,6 +155,10 @@ static inline HrtfMixerBlendFunc SelectHrtfBlendMixer(void)
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixHrtfBlend_Neon;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixHrtfBlend_AVX2;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixHrtfBlend_SSE;
@@ -110,6 +166,23 @@ static inline HrtfMixerBlendFunc SelectHrtfBlendMixer(void)
     return MixHrtfBlend_C;
 }
 
+static inline HrtfMixerInterpFunc SelectHrtfInterpMixer(void)
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return MixHrtfInterp_Neon;
+#endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixHrtfInterp_AVX2;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return MixHrtfInterp_SSE;
+#endif
+    return MixHrtfInterp_C;
+}
+
 ResamplerFunc SelectResampler(enum Resampler resampler)
 {
     switch(resampler)
@@ -121,6 +194,10 @@ ResamplerFunc SelectResampler(enum Resampler resampler)
             if((CPUCapFlags&CPU_CAP_NEON))
                 return Resample_lerp_Neon;
 #endif
+#ifdef HAVE_AVX2
+            if((CPUCapFlags&CPU_CAP_AVX2))
+                return Resample_lerp_AVX2;
+#endif
 #ifdef HAVE_SSE4_1
             if((CPUCapFlags&CPU_CAP_SSE4_1))
                 return Resample_lerp_SSE41;
@@ -138,6 +215,14 @@ ResamplerFunc SelectResampler(enum Resampler resampler)
             if((CPUCapFlags&CPU_CAP_NEON))
                 return Resample_bsinc_Neon;
 #endif
+#ifdef HAVE_AVX512
+            if((CPUCapFlags&CPU_CAP_AVX512))
+                return Resample_bsinc_AVX512;
+#endif
+#ifdef HAVE_AVX2
+            if((CPUCapFlags&CPU_CAP_AVX2))
+                return Resample_bsinc_AVX2;
+#endif
 #ifdef HAVE_SSE
             if((CPUCapFlags&CPU_CAP_SSE))
                 return Resample_bsinc_SSE;
@@ -187,9 +272,13 @@ void aluInitMixer(void)
     }
 
     MixHrtfBlendSamples = SelectHrtfBlendMixer();
+    MixHrtfInterpSamples = SelectHrtfInterpMixer();
     MixHrtfSamples = SelectHrtfMixer();
     MixSamples = SelectMixer();
     MixRowSamples = SelectRowMixer();
+    MixMultiSamples = SelectMultiMixer();
+    LoadShortSamples = SelectShortLoader();
+    LoadFloatSamples = SelectFloatLoader();
 }
 
 
@@ -215,25 +304,33 @@ template<> inline ALfloat LoadSample<FmtAlaw>(FmtTypeTraits<FmtAlaw>::Type val)
 { return aLawDecompressionTable[val] * (1.0f/32768.0f); }
 
 template<FmtType T>
-inline void LoadSampleArray(ALfloat *RESTRICT dst, const void *src, ALint srcstep, ALsizei samples)
+inline void LoadSampleArray(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos, const void *src,
+                            ALsizei numchans, ALsizei samples)
 {
     using SampleType = typename FmtTypeTraits<T>::Type;
 
     const SampleType *ssrc = static_cast<const SampleType*>(src);
     for(ALsizei i{0};i < samples;i++)
-        dst[i] += LoadSample<T>(ssrc[i*srcstep]);
+    {
+        for(ALsizei c{0};c < numchans;c++)
+            dst[c][dstpos+i] += LoadSample<T>(ssrc[i*numchans + c]);
+    }
 }
 
-void LoadSamples(ALfloat *RESTRICT dst, const ALvoid *RESTRICT src, ALint srcstep, FmtType srctype,
-                 ALsizei samples)
+/* Adds the given interleaved samples into each channel's line of dst,
+ * starting at dstpos.
+ */
+void LoadSamplesMulti(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos,
+                      const ALvoid *RESTRICT src, ALsizei numchans, FmtType srctype,
+                      ALsizei samples)
 {
 #define HANDLE_FMT(T)                                                         \
-    case T: LoadSampleArray<T>(dst, src, srcstep, samples); break
+    case T: LoadSampleArray<T>(dst, dstpos, src, numchans, samples); break
     switch(srctype)
     {
         HANDLE_FMT(FmtUByte);
-        HANDLE_FMT(FmtShort);
-        HANDLE_FMT(FmtFloat);
+        case FmtShort: LoadShortSamples(dst, dstpos, src, numchans, samples); break;
+        case FmtFloat: LoadFloatSamples(dst, dstpos, src, numchans, samples); break;
         HANDLE_FMT(FmtDouble);
         HANDLE_FMT(FmtMulaw);
         HANDLE_FMT(FmtAlaw);
@@ -242,11 +339,10 @@ void LoadSamples(ALfloat *RESTRICT dst, const ALvoid *RESTRICT src, ALint srcste
 }
 
 
-const ALfloat *DoFilters(BiquadFilter *lpfilter, BiquadFilter *hpfilter,
-                         ALfloat *RESTRICT dst, const ALfloat *RESTRICT src,
-                         ALsizei numsamples, int type)
+const ALfloat *DoFilters(BiquadFilter *lpfilter, BiquadFilter *hpfilter, ALfloat *RESTRICT dst,
+                         ALfloat *RESTRICT temp, const ALfloat *RESTRICT src, ALsizei numsamples,
+                         int type)
 {
-    ALsizei i;
     switch(type)
     {
         case AF_None:
@@ -264,15 +360,8 @@ const ALfloat *DoFilters(BiquadFilter *lpfilter, BiquadFilter *hpfilter,
             return dst;
 
         case AF_BandPass:
-            for(i = 0;i < numsamples;)
-            {
-                ALfloat temp[256];
-                ALsizei todo = mini(256, numsamples-i);
-
-                lpfilter->process(temp, src+i, todo);
-                hpfilter->process(dst+i, temp, todo);
-                i += todo;
-            }
+            lpfilter->process(temp, src, numsamples);
+            hpfilter->process(dst, temp, numsamples);
             return dst;
     }
     return src;
@@ -280,25 +369,413 @@ const ALfloat *DoFilters(BiquadFilter *lpfilter, BiquadFilter *hpfilter,
 
 } // namespace
 
-/* This function uses these device temp buffers. */
-#define SOURCE_DATA_BUF 0
-#define RESAMPLED_BUF 1
-#define FILTERED_BUF 2
-#define NFC_DATA_BUF 3
-ALboolean MixSource(ALvoice *voice, ALuint SourceID, ALCcontext *Context, ALsizei SamplesToDo)
+void MixerScratch::resize(ALuint update_size)
+{
+    /* Keep the output size a multiple of 4 for the SIMD mixers. */
+    ALsizei size{BUFFERSIZE};
+    if(update_size > 0 && update_size < BUFFERSIZE)
+        size = static_cast<ALsizei>((update_size+3) & ~3u);
+    if(size == OutputSize)
+        return;
+
+    OutputStorage.resize(size*(MAX_INPUT_CHANNELS*2 + 2));
+    OutputStorage.shrink_to_fit();
+    ALfloat *storage{OutputStorage.data()};
+    for(ALfloat *&data : ResampledData)
+    {
+        data = storage;
+        storage += size;
+    }
+    for(ALfloat *&data : FilteredData)
+    {
+        data = storage;
+        storage += size;
+    }
+    FilterTemp = storage;
+    NfcData = FilterTemp + size;
+    OutputSize = size;
+}
+
+namespace {
+
+inline bool IsGainSilent(const ALfloat gain) noexcept
+{ return !(std::fabs(gain) > GAIN_SILENCE_THRESHOLD); }
+
+/* Checks if a set of channel gains is silent, including the current gains if
+ * they're still fading toward the target.
+ */
+inline bool AreGainsSilent(const ALfloat *current, const ALfloat *target, ALsizei count,
+    bool fading) noexcept
+{
+    return std::all_of(target, target+count, IsGainSilent) &&
+        (!fading || std::all_of(current, current+count, IsGainSilent));
+}
+
+/* Checks if a send would feed anything above the silence threshold into its
+ * effect slot.
+ */
+bool IsSendSilent(const ALvoice::SendData &send, ALsizei NumChannels, bool fading) noexcept
+{
+    for(ALsizei chan{0};chan < NumChannels;chan++)
+    {
+        if(!AreGainsSilent(send.Params[chan].Gains.Current, send.Params[chan].Gains.Target,
+                           send.Channels, fading))
+            return false;
+    }
+    return true;
+}
+
+/* Checks if everything the voice would mix this update is below the silence
+ * threshold, including any gain fading still in progress.
+ */
+bool IsVoiceSilent(const ALvoice *voice, ALsizei NumSends)
+{
+    const bool fading{(voice->State->Flags&VOICE_IS_FADING) != 0};
+
+    for(ALsizei chan{0};chan < voice->NumChannels;chan++)
+    {
+        const DirectParams &parms = voice->Direct.Params[chan];
+        if((voice->State->Flags&VOICE_HAS_HRTF))
+        {
+            if(!IsGainSilent(parms.Hrtf.Target.Gain) ||
+               (fading && !IsGainSilent(parms.Hrtf.Old.Gain)))
+                return false;
+        }
+        else if(!AreGainsSilent(parms.Gains.Current, parms.Gains.Target,
+                                voice->Direct.Channels, fading))
+            return false;
+    }
+
+    for(ALsizei i{0};i < NumSends;i++)
+    {
+        const ALvoice::SendData &send = voice->Send[i];
+        if(send.Buffer && !IsSendSilent(send, voice->NumChannels, fading))
+            return false;
+    }
+    return true;
+}
+
+const RealFftPlan HrtfTailFft{HRTF_PART_FFT_SIZE};
+const FftPlan HrtfTailIfft{HRTF_PART_FFT_SIZE};
+
+/* Convolves the last two input blocks with the HRIR tail partitions to get
+ * the tail output for the next block. The partitions after the first apply
+ * to older blocks, so only past input is needed and there's no added latency.
+ */
+void ProcessHrtfTailBlock(HrtfTailState *tail)
+{
+    const ALsizei num_parts{tail->NumParts};
+
+    tail->Newest = (tail->Newest+num_parts-1) % num_parts;
+    HrtfTailFft.forward(tail->Input, tail->Spectra[tail->Newest]);
+    std::copy(std::begin(tail->Input)+HRTF_PART_SIZE, std::end(tail->Input),
+              std::begin(tail->Input));
+
+    auto accumulate = [tail,num_parts](const HrtfTailState::Filter &filter,
+        std::complex<float> (*RESTRICT out)[2]) noexcept -> void
+    {
+        std::fill_n(&out[0][0], HRTF_PART_BINS*2, std::complex<float>{});
+        ALsizei idx{tail->Newest};
+        for(ALsizei p{0};p < num_parts;p++)
+        {
+            const std::complex<float> *RESTRICT input{tail->Spectra[idx]};
+            const std::complex<float> (*RESTRICT coeffs)[2] = filter.Parts[p];
+            /* Written out to avoid the library's checks for infinities. */
+            for(ALsizei k{0};k < HRTF_PART_BINS;k++)
+            {
+                const ALfloat re{input[k].real()}, im{input[k].imag()};
+                out[k][0] += std::complex<float>{re*coeffs[k][0].real() - im*coeffs[k][0].imag(),
+                                                 re*coeffs[k][0].imag() + im*coeffs[k][0].real()};
+                out[k][1] += std::complex<float>{re*coeffs[k][1].real() - im*coeffs[k][1].imag(),
+                                                 re*coeffs[k][1].imag() + im*coeffs[k][1].real()};
+            }
+            if(++idx == num_parts) idx = 0;
+        }
+    };
+
+    alignas(16) std::complex<float> result[HRTF_PART_BINS][2];
+    accumulate(tail->Filters[tail->Current], result);
+    if(tail->Fade > 0)
+    {
+        /* Crossfade from the old filter's output, a block at a time. */
+        alignas(16) std::complex<float> oldresult[HRTF_PART_BINS][2];
+        accumulate(tail->Filters[tail->Current^1], oldresult);
+
+        const ALfloat oldgain{(ALfloat)tail->Fade / (ALfloat)(HRTF_TAIL_FADE_BLOCKS+1)};
+        for(ALsizei k{0};k < HRTF_PART_BINS;k++)
+        {
+            result[k][0] += (oldresult[k][0]-result[k][0]) * oldgain;
+            result[k][1] += (oldresult[k][1]-result[k][1]) * oldgain;
+        }
+        tail->Fade--;
+    }
+
+    /* Both ears' outputs are real, so they're inverse transformed together as
+     * the real and imaginary parts of one signal.
+     */
+    alignas(16) std::complex<float> fftbuf[HRTF_PART_FFT_SIZE];
+    for(ALsizei k{0};k < HRTF_PART_BINS;k++)
+        fftbuf[k] = std::complex<float>{result[k][0].real() - result[k][1].imag(),
+                                        result[k][0].imag() + result[k][1].real()};
+    for(ALsizei k{HRTF_PART_BINS};k < HRTF_PART_FFT_SIZE;k++)
+    {
+        const ALsizei k2{HRTF_PART_FFT_SIZE - k};
+        fftbuf[k] = std::complex<float>{result[k2][0].real() + result[k2][1].imag(),
+                                        result[k2][1].real() - result[k2][0].imag()};
+    }
+    HrtfTailIfft.inverse(fftbuf);
+
+    for(ALsizei i{0};i < HRTF_PART_SIZE;i++)
+    {
+        tail->Output[i][0] = fftbuf[HRTF_PART_SIZE+i].real();
+        tail->Output[i][1] = fftbuf[HRTF_PART_SIZE+i].imag();
+    }
+}
+
+void MixHrtfTail(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut, const ALfloat *data,
+                 ALsizei OutPos, const ALfloat gain, const ALfloat gainstep,
+                 HrtfTailState *tail, ALsizei BufferSize)
+{
+    ASSUME(BufferSize > 0);
+
+    LeftOut  += OutPos;
+    RightOut += OutPos;
+    ALfloat stepcount{0.0f};
+    ALsizei pos{0};
+    while(pos < BufferSize)
+    {
+        const ALsizei todo{mini(BufferSize-pos, HRTF_PART_SIZE-tail->Pos)};
+        ALfloat *RESTRICT input{tail->Input + HRTF_PART_SIZE + tail->Pos};
+        const ALfloat (*RESTRICT output)[2] = tail->Output + tail->Pos;
+        for(ALsizei i{0};i < todo;i++)
+        {
+            input[i] = data[pos+i] * (gain + gainstep*stepcount);
+            LeftOut[pos+i]  += output[i][0];
+            RightOut[pos+i] += output[i][1];
+            stepcount += 1.0f;
+        }
+        pos += todo;
+
+        tail->Pos += todo;
+        if(tail->Pos == HRTF_PART_SIZE)
+        {
+            tail->Pos = 0;
+            ProcessHrtfTailBlock(tail);
+        }
+    }
+}
+
+/* Checks if a voice channel's HRTF filter is settled (not fading to new
+ * parameters) and audible, so it could be mixed with a shared bus.
+ */
+bool IsHrtfShareable(const DirectParams &parms, ALsizei irSize)
+{
+    const HrtfParams &oldparams = parms.Hrtf.Old;
+    const HrtfParams &target = parms.Hrtf.Target;
+    if(!(oldparams.Gain > GAIN_SILENCE_THRESHOLD) || oldparams.Gain != target.Gain ||
+       oldparams.Delay[0] != target.Delay[0] || oldparams.Delay[1] != target.Delay[1])
+        return false;
+    return std::equal(&oldparams.Coeffs[0][0], &oldparams.Coeffs[irSize][0],
+                      &target.Coeffs[0][0]);
+}
+
+bool HrtfFiltersMatch(const HrtfParams &lhs, const HrtfParams &rhs, ALsizei irSize)
+{
+    if(lhs.Delay[0] != rhs.Delay[0] || lhs.Delay[1] != rhs.Delay[1])
+        return false;
+    return std::equal(&lhs.Coeffs[0][0], &lhs.Coeffs[irSize][0], &rhs.Coeffs[0][0],
+        [](const ALfloat a, const ALfloat b) noexcept -> bool
+        { return std::fabs(a - b) <= HRTF_SHARE_TOLERANCE; }
+    );
+}
+
+/* Puts a voice channel on a bus. Its delayed input and pending output are
+ * added to the bus's, so the bus continues where the channel's own filter
+ * left off.
+ */
+void JoinHrtfBus(HrtfBusState *buses, ALsizei busidx, const ALvoice *voice,
+                 DirectParams &parms, ALsizei irSize)
+{
+    HrtfBus &bus = buses->Bus[busidx];
+    HrtfState &state = parms.Hrtf.State;
+    const ALfloat gain{parms.Hrtf.Old.Gain};
+
+    for(ALsizei i{1};i < HRTF_HISTORY_LENGTH;i++)
+        bus.State.History[(bus.Offset-i)&HRTF_HISTORY_MASK] +=
+            state.History[(voice->Offset-i)&HRTF_HISTORY_MASK] * gain;
+    for(ALsizei i{0};i < irSize-1;i++)
+    {
+        bus.State.Values[(bus.Offset+i)&HRIR_MASK][0] +=
+            state.Values[(voice->Offset+i)&HRIR_MASK][0];
+        bus.State.Values[(bus.Offset+i)&HRIR_MASK][1] +=
+            state.Values[(voice->Offset+i)&HRIR_MASK][1];
+    }
+    std::fill_n(&state.Values[0][0], HRIR_LENGTH*2, 0.0f);
+
+    parms.Hrtf.Bus = busidx;
+    bus.NumMembers++;
+}
+
+/* Takes a voice channel off its bus. If the channel keeps playing, it takes
+ * back its delayed input for its own filter to continue with. Otherwise the
+ * bus plays out the rest of it, along with what it already convolved.
+ */
+void LeaveHrtfBus(HrtfBusState *buses, const ALvoice *voice, DirectParams &parms,
+                  bool keepplaying)
+{
+    HrtfBus &bus = buses->Bus[parms.Hrtf.Bus];
+    HrtfState &state = parms.Hrtf.State;
+    if(!keepplaying)
+        std::fill(std::begin(state.History), std::end(state.History), 0.0f);
+    else if(bus.InUse)
+    {
+        const ALfloat gain{parms.Hrtf.Old.Gain};
+        for(ALsizei i{1};i < HRTF_HISTORY_LENGTH;i++)
+            bus.State.History[(bus.Offset-i)&HRTF_HISTORY_MASK] -=
+                state.History[(voice->Offset-i)&HRTF_HISTORY_MASK] * gain;
+    }
+    parms.Hrtf.Bus = -1;
+    parms.Hrtf.Checked = false;
+}
+
+} // namespace
+
+/* Advances a voice through its buffer queue by the given number of output
+ * samples without loading, resampling, filtering, or mixing anything. Buffer
+ * completion and the end of the queue are handled the same as when mixing.
+ */
+ALboolean AdvanceVoice(ALvoice *voice, ALCcontext *Context, ALsizei *BuffersDone,
+                       ALsizei SamplesToDo)
+{
+    ASSUME(SamplesToDo > 0);
+
+    ALsizei DataPosInt{(ALsizei)voice->position.load(std::memory_order_acquire)};
+    ALsizei DataPosFrac{voice->position_fraction.load(std::memory_order_relaxed)};
+    ALbufferlistitem *BufferListItem{voice->current_buffer.load(std::memory_order_relaxed)};
+    ALbufferlistitem *BufferLoopItem{voice->loop_buffer.load(std::memory_order_relaxed)};
+    const ALsizei NumChannels{voice->NumChannels};
+    const ALsizei NumSends{Context->Device->NumAuxSends};
+    const ALint increment{voice->State->Step};
+    bool isplaying{true};
+    ALsizei buffers_done{0};
+
+    ASSUME(DataPosInt >= 0);
+    ASSUME(DataPosFrac >= 0);
+    ASSUME(increment > 0);
+
+    if(!(voice->State->Flags&VOICE_IS_VIRTUAL))
+    {
+        /* Drop the filter and resampler history when the voice goes virtual,
+         * so stale samples don't come back once it's audible again, and
+         * silence the current gains so it fades back in.
+         */
+        for(ALsizei chan{0};chan < NumChannels;chan++)
+        {
+            voice->PrevSamples[chan].fill(0.0f);
+
+            DirectParams &parms = voice->Direct.Params[chan];
+            parms.LowPass.clear();
+            parms.HighPass.clear();
+            std::fill(std::begin(parms.Gains.Current), std::end(parms.Gains.Current), 0.0f);
+            if((voice->State->Flags&VOICE_HAS_HRTF))
+            {
+                parms.Hrtf.State = HrtfState{};
+                parms.Hrtf.Old.Gain = 0.0f;
+                if(static_cast<size_t>(chan) < voice->HrtfTail.size())
+                    voice->HrtfTail[chan].clear();
+            }
+            for(ALsizei i{0};i < NumSends;i++)
+            {
+                SendParams &sparms = voice->Send[i].Params[chan];
+                sparms.LowPass.clear();
+                sparms.HighPass.clear();
+                std::fill(std::begin(sparms.Gains.Current), std::end(sparms.Gains.Current),
+                          0.0f);
+            }
+        }
+        voice->State->Flags |= VOICE_IS_VIRTUAL;
+    }
+
+    /* Update positions */
+    const ALint64 DataPos64{(ALint64)increment*SamplesToDo + DataPosFrac};
+    DataPosInt += static_cast<ALsizei>(DataPos64 >> FRACTIONBITS);
+    DataPosFrac = static_cast<ALsizei>(DataPos64 & FRACTIONMASK);
+
+    if((voice->State->Flags&VOICE_IS_STATIC))
+    {
+        const ALbuffer *Buffer{BufferListItem->buffers[0]};
+        const ALsizei LoopStart{Buffer->LoopStart};
+        const ALsizei LoopEnd{Buffer->LoopEnd};
+        const ALsizei OldPosInt{(ALsizei)voice->position.load(std::memory_order_relaxed)};
+
+        /* If the position started beyond the loop range, it doesn't loop. */
+        if(BufferLoopItem && OldPosInt < LoopEnd)
+        {
+            if(DataPosInt >= LoopEnd)
+            {
+                assert(LoopEnd > LoopStart);
+                DataPosInt = ((DataPosInt-LoopStart)%(LoopEnd-LoopStart)) + LoopStart;
+            }
+        }
+        else if(DataPosInt >= BufferListItem->max_samples)
+        {
+            isplaying = false;
+            BufferListItem = nullptr;
+            DataPosInt = 0;
+            DataPosFrac = 0;
+        }
+    }
+    else while(BufferListItem->max_samples <= DataPosInt)
+    {
+        /* Handle streaming source */
+        DataPosInt -= BufferListItem->max_samples;
+
+        buffers_done += BufferListItem->num_buffers;
+        BufferListItem = BufferListItem->next.load(std::memory_order_relaxed);
+        if(!BufferListItem && !(BufferListItem=BufferLoopItem))
+        {
+            isplaying = false;
+            DataPosInt = 0;
+            DataPosFrac = 0;
+            break;
+        }
+    }
+
+    voice->State->Flags |= VOICE_IS_FADING;
+    voice->Offset += SamplesToDo;
+
+    /* Update source info */
+    voice->position.store(DataPosInt, std::memory_order_relaxed);
+    voice->position_fraction.store(DataPosFrac, std::memory_order_relaxed);
+    voice->current_buffer.store(BufferListItem, std::memory_order_release);
+
+    *BuffersDone = buffers_done;
+
+    return isplaying;
+}
+
+ALboolean MixSource(ALvoice *voice, ALCcontext *Context, MixerScratch *Scratch,
+                    ALsizei *BuffersDone, ALsizei SamplesToDo)
 {
     ASSUME(SamplesToDo > 0);
 
+    /* Inaudible and culled voices only need to keep their place in the
+     * queue.
+     */
+    if((voice->State->Flags&VOICE_IS_CULLED) || IsVoiceSilent(voice, Context->Device->NumAuxSends))
+        return AdvanceVoice(voice, Context, BuffersDone, SamplesToDo);
+    voice->State->Flags &= ~VOICE_IS_VIRTUAL;
+
     /* Get source info */
     bool isplaying{true}; /* Will only be called while playing. */
-    bool isstatic{(voice->Flags&VOICE_IS_STATIC) != 0};
+    bool isstatic{(voice->State->Flags&VOICE_IS_STATIC) != 0};
     ALsizei DataPosInt{(ALsizei)voice->position.load(std::memory_order_acquire)};
     ALsizei DataPosFrac{voice->position_fraction.load(std::memory_order_relaxed)};
     ALbufferlistitem *BufferListItem{voice->current_buffer.load(std::memory_order_relaxed)};
     ALbufferlistitem *BufferLoopItem{voice->loop_buffer.load(std::memory_order_relaxed)};
     ALsizei NumChannels{voice->NumChannels};
     ALsizei SampleSize{voice->SampleSize};
-    ALint increment{voice->Step};
+    ALint increment{voice->State->Step};
 
     ASSUME(DataPosInt >= 0);
     ASSUME(DataPosFrac >= 0);
@@ -308,17 +785,21 @@ ALboolean MixSource(ALvoice *voice, ALuint SourceID, ALCcontext *Context, ALsize
 
     ALCdevice *Device{Context->Device};
     ALsizei IrSize{Device->HrtfHandle ? Device->HrtfHandle->irSize : 0};
+    /* Long HRIRs only have their first partition convolved directly. */
+    if(IrSize > HRIR_LENGTH) IrSize = HRTF_PART_SIZE;
 
     ResamplerFunc Resample{(increment == FRACTIONONE && DataPosFrac == 0) ?
                            Resample_copy_C : voice->Resampler};
 
-    ALsizei Counter{(voice->Flags&VOICE_IS_FADING) ? SamplesToDo : 0};
+    ALsizei Counter{(voice->State->Flags&VOICE_IS_FADING) ? SamplesToDo : 0};
     ALsizei buffers_done{0};
     ALsizei OutPos{0};
 
     do {
-        /* Figure out how many buffer samples will be needed */
-        ALsizei DstBufferSize{SamplesToDo - OutPos};
+        /* Figure out how many buffer samples will be needed, limited by the
+         * scratch space for the output.
+         */
+        ALsizei DstBufferSize{mini(SamplesToDo - OutPos, Scratch->OutputSize)};
 
         /* Calculate the last written dst sample pos. */
         ALint64 DataSize64{DstBufferSize - 1};
@@ -346,245 +827,356 @@ ALboolean MixSource(ALvoice *voice, ALuint SourceID, ALCcontext *Context, ALsize
                 DstBufferSize &= ~3;
         }
 
+        const ALsizei PrevSamplesPos{(increment*DstBufferSize + DataPosFrac)>>FRACTIONBITS};
+        const ALsizei SrcClearSize{mini(BUFFERSIZE,
+            maxi(SrcBufferSize, PrevSamplesPos+MAX_RESAMPLE_PADDING))};
+
         /* It's impossible to have a buffer list item with no entries. */
         assert(BufferListItem->num_buffers > 0);
 
+        const ALfloat *ResampledData[MAX_INPUT_CHANNELS];
+
+        /* Load the previous samples into the source data first, and clear the
+         * rest that will be used (including the next update's previous
+         * samples).
+         */
+        ALfloat (*SrcData)[BUFFERSIZE]{Scratch->SourceData};
         for(ALsizei chan{0};chan < NumChannels;chan++)
         {
-            ALfloat (&SrcData)[BUFFERSIZE] = Device->TempBuffer[SOURCE_DATA_BUF];
-
-            /* Load the previous samples into the source data first, and clear the rest. */
             auto srciter = std::copy(std::begin(voice->PrevSamples[chan]),
-                std::end(voice->PrevSamples[chan]), std::begin(SrcData));
-            std::fill(srciter, std::end(SrcData), 0.0f);
+                std::end(voice->PrevSamples[chan]), std::begin(SrcData[chan]));
+            std::fill(srciter, std::begin(SrcData[chan])+SrcClearSize, 0.0f);
+        }
 
-            auto FilledAmt = static_cast<ALsizei>(voice->PrevSamples[chan].size());
-            if(isstatic)
+        /* Deinterleave the buffer data for all channels at once, so each
+         * buffer only gets one pass over it.
+         */
+        auto FilledAmt = static_cast<ALsizei>(voice->PrevSamples[0].size());
+        if(isstatic)
+        {
+            /* TODO: For static sources, loop points are taken from the
+             * first buffer (should be adjusted by any buffer offset, to
+             * possibly be added later).
+             */
+            const ALbuffer *Buffer0{BufferListItem->buffers[0]};
+            const ALsizei LoopStart{Buffer0->LoopStart};
+            const ALsizei LoopEnd{Buffer0->LoopEnd};
+            ASSUME(LoopStart >= 0);
+            ASSUME(LoopEnd > LoopStart);
+
+            /* If current pos is beyond the loop range, do not loop */
+            if(!BufferLoopItem || DataPosInt >= LoopEnd)
             {
-                /* TODO: For static sources, loop points are taken from the
-                 * first buffer (should be adjusted by any buffer offset, to
-                 * possibly be added later).
-                 */
-                const ALbuffer *Buffer0{BufferListItem->buffers[0]};
-                const ALsizei LoopStart{Buffer0->LoopStart};
-                const ALsizei LoopEnd{Buffer0->LoopEnd};
-                ASSUME(LoopStart >= 0);
-                ASSUME(LoopEnd > LoopStart);
-
-                /* If current pos is beyond the loop range, do not loop */
-                if(!BufferLoopItem || DataPosInt >= LoopEnd)
-                {
-                    ALsizei SizeToDo = SrcBufferSize - FilledAmt;
+                ALsizei SizeToDo = SrcBufferSize - FilledAmt;
 
-                    BufferLoopItem = nullptr;
+                BufferLoopItem = nullptr;
 
-                    ALsizei CompLen{0};
-                    auto load_buffer = [DataPosInt,&SrcData,NumChannels,SampleSize,chan,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
-                    {
-                        if(DataPosInt >= buffer->SampleLen)
-                            return;
-
-                        /* Load what's left to play from the buffer */
-                        ALsizei DataSize{mini(SizeToDo, buffer->SampleLen - DataPosInt)};
-                        CompLen = maxi(CompLen, DataSize);
+                ALsizei CompLen{0};
+                auto load_buffer = [DataPosInt,SrcData,NumChannels,SampleSize,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
+                {
+                    if(DataPosInt >= buffer->SampleLen)
+                        return;
+
+                    /* Load what's left to play from the buffer */
+                    ALsizei DataSize{mini(SizeToDo, buffer->SampleLen - DataPosInt)};
+                    CompLen = maxi(CompLen, DataSize);
+
+                    const ALbyte *Data{buffer->mData.data()};
+                    LoadSamplesMulti(SrcData, FilledAmt, &Data[DataPosInt*NumChannels*SampleSize],
+                        NumChannels, buffer->FmtType, DataSize
+                    );
+                };
+                auto buffers_end = BufferListItem->buffers + BufferListItem->num_buffers;
+                std::for_each(BufferListItem->buffers, buffers_end, load_buffer);
+                FilledAmt += CompLen;
+            }
+            else
+            {
+                const ALsizei SizeToDo{mini(SrcBufferSize - FilledAmt, LoopEnd - DataPosInt)};
 
-                        const ALbyte *Data{buffer->mData.data()};
-                        LoadSamples(&SrcData[FilledAmt],
-                            &Data[(DataPosInt*NumChannels + chan)*SampleSize],
-                            NumChannels, buffer->FmtType, DataSize
-                        );
-                    };
-                    auto buffers_end = BufferListItem->buffers + BufferListItem->num_buffers;
-                    std::for_each(BufferListItem->buffers, buffers_end, load_buffer);
-                    FilledAmt += CompLen;
-                }
-                else
+                ALsizei CompLen{0};
+                auto load_buffer = [DataPosInt,SrcData,NumChannels,SampleSize,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
                 {
-                    const ALsizei SizeToDo{mini(SrcBufferSize - FilledAmt, LoopEnd - DataPosInt)};
+                    if(DataPosInt >= buffer->SampleLen)
+                        return;
+
+                    /* Load what's left of this loop iteration */
+                    ALsizei DataSize{mini(SizeToDo, buffer->SampleLen - DataPosInt)};
+                    CompLen = maxi(CompLen, DataSize);
+
+                    const ALbyte *Data{buffer->mData.data()};
+                    LoadSamplesMulti(SrcData, FilledAmt, &Data[DataPosInt*NumChannels*SampleSize],
+                        NumChannels, buffer->FmtType, DataSize
+                    );
+                };
+                auto buffers_end = BufferListItem->buffers + BufferListItem->num_buffers;
+                std::for_each(BufferListItem->buffers, buffers_end, load_buffer);
+                FilledAmt += CompLen;
+
+                const ALsizei LoopSize{LoopEnd - LoopStart};
+                while(SrcBufferSize > FilledAmt)
+                {
+                    const ALsizei SizeToDo{mini(SrcBufferSize - FilledAmt, LoopSize)};
 
-                    ALsizei CompLen{0};
-                    auto load_buffer = [DataPosInt,&SrcData,NumChannels,SampleSize,chan,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
+                    CompLen = 0;
+                    auto load_buffer_loop = [LoopStart,SrcData,NumChannels,SampleSize,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
                     {
-                        if(DataPosInt >= buffer->SampleLen)
+                        const ALbyte *Data = buffer->mData.data();
+                        ALsizei DataSize;
+
+                        if(LoopStart >= buffer->SampleLen)
                             return;
 
-                        /* Load what's left of this loop iteration */
-                        ALsizei DataSize{mini(SizeToDo, buffer->SampleLen - DataPosInt)};
+                        DataSize = mini(SizeToDo, buffer->SampleLen - LoopStart);
                         CompLen = maxi(CompLen, DataSize);
 
-                        const ALbyte *Data{buffer->mData.data()};
-                        LoadSamples(&SrcData[FilledAmt],
-                            &Data[(DataPosInt*NumChannels + chan)*SampleSize],
-                            NumChannels, buffer->FmtType, DataSize
+                        LoadSamplesMulti(SrcData, FilledAmt,
+                            &Data[LoopStart*NumChannels*SampleSize], NumChannels,
+                            buffer->FmtType, DataSize
                         );
                     };
-                    auto buffers_end = BufferListItem->buffers + BufferListItem->num_buffers;
-                    std::for_each(BufferListItem->buffers, buffers_end, load_buffer);
+                    std::for_each(BufferListItem->buffers, buffers_end, load_buffer_loop);
                     FilledAmt += CompLen;
-
-                    const ALsizei LoopSize{LoopEnd - LoopStart};
-                    while(SrcBufferSize > FilledAmt)
-                    {
-                        const ALsizei SizeToDo{mini(SrcBufferSize - FilledAmt, LoopSize)};
-
-                        CompLen = 0;
-                        auto load_buffer_loop = [LoopStart,&SrcData,NumChannels,SampleSize,chan,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
-                        {
-                            const ALbyte *Data = buffer->mData.data();
-                            ALsizei DataSize;
-
-                            if(LoopStart >= buffer->SampleLen)
-                                return;
-
-                            DataSize = mini(SizeToDo, buffer->SampleLen - LoopStart);
-                            CompLen = maxi(CompLen, DataSize);
-
-                            LoadSamples(&SrcData[FilledAmt],
-                                &Data[(LoopStart*NumChannels + chan)*SampleSize],
-                                NumChannels, buffer->FmtType, DataSize
-                            );
-                        };
-                        std::for_each(BufferListItem->buffers, buffers_end, load_buffer_loop);
-                        FilledAmt += CompLen;
-                    }
                 }
             }
-            else
-            {
-                /* Crawl the buffer queue to fill in the temp buffer */
-                ALbufferlistitem *tmpiter{BufferListItem};
-                ALsizei pos{DataPosInt};
+        }
+        else
+        {
+            /* Crawl the buffer queue to fill in the temp buffer */
+            ALbufferlistitem *tmpiter{BufferListItem};
+            ALsizei pos{DataPosInt};
 
-                while(tmpiter && SrcBufferSize > FilledAmt)
+            while(tmpiter && SrcBufferSize > FilledAmt)
+            {
+                if(pos >= tmpiter->max_samples)
                 {
-                    if(pos >= tmpiter->max_samples)
-                    {
-                        pos -= tmpiter->max_samples;
-                        tmpiter = tmpiter->next.load(std::memory_order_acquire);
-                        if(!tmpiter) tmpiter = BufferLoopItem;
-                        continue;
-                    }
+                    pos -= tmpiter->max_samples;
+                    tmpiter = tmpiter->next.load(std::memory_order_acquire);
+                    if(!tmpiter) tmpiter = BufferLoopItem;
+                    continue;
+                }
 
-                    const ALsizei SizeToDo{SrcBufferSize - FilledAmt};
-                    ALsizei CompLen{0};
-                    auto load_buffer = [pos,&SrcData,NumChannels,SampleSize,chan,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
-                    {
-                        if(!buffer) return;
-                        ALsizei DataSize{buffer->SampleLen};
-                        if(pos >= DataSize) return;
+                const ALsizei SizeToDo{SrcBufferSize - FilledAmt};
+                ALsizei CompLen{0};
+                auto load_buffer = [pos,SrcData,NumChannels,SampleSize,FilledAmt,SizeToDo,&CompLen](const ALbuffer *buffer) -> void
+                {
+                    if(!buffer) return;
+                    ALsizei DataSize{buffer->SampleLen};
+                    if(pos >= DataSize) return;
 
-                        DataSize = mini(SizeToDo, DataSize - pos);
-                        CompLen = maxi(CompLen, DataSize);
+                    DataSize = mini(SizeToDo, DataSize - pos);
+                    CompLen = maxi(CompLen, DataSize);
 
-                        const ALbyte *Data{buffer->mData.data()};
-                        Data += (pos*NumChannels + chan)*SampleSize;
+                    const ALbyte *Data{buffer->mData.data()};
+                    Data += pos*NumChannels*SampleSize;
 
-                        LoadSamples(&SrcData[FilledAmt], Data, NumChannels,
-                                    buffer->FmtType, DataSize);
-                    };
-                    auto buffers_end = tmpiter->buffers + tmpiter->num_buffers;
-                    std::for_each(tmpiter->buffers, buffers_end, load_buffer);
-                    FilledAmt += CompLen;
+                    LoadSamplesMulti(SrcData, FilledAmt, Data, NumChannels, buffer->FmtType,
+                                     DataSize);
+                };
+                auto buffers_end = tmpiter->buffers + tmpiter->num_buffers;
+                std::for_each(tmpiter->buffers, buffers_end, load_buffer);
+                FilledAmt += CompLen;
 
-                    if(SrcBufferSize <= FilledAmt)
-                        break;
-                    pos = 0;
-                    tmpiter = tmpiter->next.load(std::memory_order_acquire);
-                    if(!tmpiter) tmpiter = BufferLoopItem;
-                }
+                if(SrcBufferSize <= FilledAmt)
+                    break;
+                pos = 0;
+                tmpiter = tmpiter->next.load(std::memory_order_acquire);
+                if(!tmpiter) tmpiter = BufferLoopItem;
             }
+        }
+
 
+        for(ALsizei chan{0};chan < NumChannels;chan++)
+        {
             /* Store the last source samples used for next time. */
-            std::copy_n(&SrcData[(increment*DstBufferSize + DataPosFrac)>>FRACTIONBITS],
-                        voice->PrevSamples[chan].size(), std::begin(voice->PrevSamples[chan]));
+            std::copy_n(&SrcData[chan][PrevSamplesPos], voice->PrevSamples[chan].size(),
+                        std::begin(voice->PrevSamples[chan]));
+
+            /* Now resample into this channel's output-rate buffer. */
+            ResampledData[chan] = Resample(&voice->ResampleState,
+                &SrcData[chan][MAX_RESAMPLE_PADDING], DataPosFrac, increment,
+                Scratch->ResampledData[chan], DstBufferSize
+            );
+        }
 
-            /* Now resample, then filter and mix to the appropriate outputs. */
-            const ALfloat *ResampledData{Resample(&voice->ResampleState,
-                &SrcData[MAX_RESAMPLE_PADDING], DataPosFrac, increment,
-                Device->TempBuffer[RESAMPLED_BUF], DstBufferSize
-            )};
+        /* Filter and mix to the appropriate outputs. Unless the direct path
+         * needs per-channel processing (HRTF or NFC), all of the voice's
+         * channels are mixed to each output together.
+         */
+        if(!(voice->State->Flags&(VOICE_HAS_HRTF|VOICE_HAS_NFC)))
+        {
+            const ALfloat *samples[MAX_INPUT_CHANNELS];
+            ALfloat *current[MAX_INPUT_CHANNELS];
+            const ALfloat *target[MAX_INPUT_CHANNELS];
+            for(ALsizei chan{0};chan < NumChannels;chan++)
             {
                 DirectParams *parms{&voice->Direct.Params[chan]};
-                const ALfloat *samples{DoFilters(&parms->LowPass, &parms->HighPass,
-                    Device->TempBuffer[FILTERED_BUF], ResampledData, DstBufferSize,
-                    voice->Direct.FilterType
-                )};
+                samples[chan] = DoFilters(&parms->LowPass, &parms->HighPass,
+                    Scratch->FilteredData[chan], Scratch->FilterTemp, ResampledData[chan],
+                    DstBufferSize, voice->Direct.FilterType
+                );
+                if(!Counter)
+                    std::copy(std::begin(parms->Gains.Target), std::end(parms->Gains.Target),
+                              std::begin(parms->Gains.Current));
+                current[chan] = parms->Gains.Current;
+                target[chan] = parms->Gains.Target;
+            }
+            MixMultiSamples(samples, NumChannels, voice->Direct.Channels, voice->Direct.Buffer,
+                current, target, Counter, OutPos, DstBufferSize
+            );
+        }
+        else for(ALsizei chan{0};chan < NumChannels;chan++)
+        {
+            DirectParams *parms{&voice->Direct.Params[chan]};
+            const ALfloat *samples{DoFilters(&parms->LowPass, &parms->HighPass,
+                Scratch->FilteredData[chan], Scratch->FilterTemp, ResampledData[chan],
+                DstBufferSize, voice->Direct.FilterType
+            )};
 
-                if(!(voice->Flags&VOICE_HAS_HRTF))
-                {
-                    if(!Counter)
-                        std::copy(std::begin(parms->Gains.Target), std::end(parms->Gains.Target),
-                                  std::begin(parms->Gains.Current));
-
-                    if(!(voice->Flags&VOICE_HAS_NFC))
-                        MixSamples(samples, voice->Direct.Channels, voice->Direct.Buffer,
-                            parms->Gains.Current, parms->Gains.Target, Counter, OutPos,
-                            DstBufferSize
-                        );
-                    else
-                    {
-                        MixSamples(samples,
-                            voice->Direct.ChannelsPerOrder[0], voice->Direct.Buffer,
-                            parms->Gains.Current, parms->Gains.Target, Counter, OutPos,
-                            DstBufferSize
-                        );
+            if(!(voice->State->Flags&VOICE_HAS_HRTF))
+            {
+                if(!Counter)
+                    std::copy(std::begin(parms->Gains.Target), std::end(parms->Gains.Target),
+                              std::begin(parms->Gains.Current));
 
-                        ALfloat *nfcsamples{Device->TempBuffer[NFC_DATA_BUF]};
-                        ALsizei chanoffset{voice->Direct.ChannelsPerOrder[0]};
-                        using FilterProc = void (NfcFilter::*)(float*,const float*,int);
-                        auto apply_nfc = [voice,parms,samples,DstBufferSize,Counter,OutPos,&chanoffset,nfcsamples](FilterProc process, ALsizei order) -> void
-                        {
-                            if(voice->Direct.ChannelsPerOrder[order] < 1)
-                                return;
-                            (parms->NFCtrlFilter.*process)(nfcsamples, samples, DstBufferSize);
-                            MixSamples(nfcsamples, voice->Direct.ChannelsPerOrder[order],
-                                voice->Direct.Buffer+chanoffset, parms->Gains.Current+chanoffset,
-                                parms->Gains.Target+chanoffset, Counter, OutPos, DstBufferSize
-                            );
-                            chanoffset += voice->Direct.ChannelsPerOrder[order];
-                        };
-                        apply_nfc(&NfcFilter::process1, 1);
-                        apply_nfc(&NfcFilter::process2, 2);
-                        apply_nfc(&NfcFilter::process3, 3);
-                    }
-                }
-                else
+                /* Only NFC voices get here without HRTF. */
+                MixSamples(samples,
+                    voice->Direct.ChannelsPerOrder[0], voice->Direct.Buffer,
+                    parms->Gains.Current, parms->Gains.Target, Counter, OutPos,
+                    DstBufferSize
+                );
+
+                ALfloat *nfcsamples{Scratch->NfcData};
+                ALsizei chanoffset{voice->Direct.ChannelsPerOrder[0]};
+                using FilterProc = void (NfcFilter::*)(float*,const float*,int);
+                auto apply_nfc = [voice,parms,samples,DstBufferSize,Counter,OutPos,&chanoffset,nfcsamples](FilterProc process, ALsizei order) -> void
                 {
-                    MixHrtfParams hrtfparams;
-                    ALsizei fademix = 0;
-                    int lidx, ridx;
+                    if(voice->Direct.ChannelsPerOrder[order] < 1)
+                        return;
+                    (parms->NFCtrlFilter.*process)(nfcsamples, samples, DstBufferSize);
+                    MixSamples(nfcsamples, voice->Direct.ChannelsPerOrder[order],
+                        voice->Direct.Buffer+chanoffset, parms->Gains.Current+chanoffset,
+                        parms->Gains.Target+chanoffset, Counter, OutPos, DstBufferSize
+                    );
+                    chanoffset += voice->Direct.ChannelsPerOrder[order];
+                };
+                apply_nfc(&NfcFilter::process1, 1);
+                apply_nfc(&NfcFilter::process2, 2);
+                apply_nfc(&NfcFilter::process3, 3);
+            }
+            else
+            {
+                MixHrtfParams hrtfparams;
+                ALsizei fademix = 0;
+                int lidx, ridx;
 
-                    lidx = GetChannelIdxByName(&Device->RealOut, FrontLeft);
-                    ridx = GetChannelIdxByName(&Device->RealOut, FrontRight);
-                    assert(lidx != -1 && ridx != -1);
+                lidx = GetChannelIdxByName(&Device->RealOut, FrontLeft);
+                ridx = GetChannelIdxByName(&Device->RealOut, FrontRight);
+                assert(lidx != -1 && ridx != -1);
 
-                    if(!Counter)
+                HrtfTailState *tail{(static_cast<size_t>(chan) < voice->HrtfTail.size()) ?
+                    &voice->HrtfTail[chan] : nullptr};
+                bool tailfade{false};
+
+                if(parms->Hrtf.Bus >= 0 && Device->mHrtfBuses)
+                {
+                    /* The channel shares a bus's filter, so its input just
+                     * gets added to the bus line. It keeps its own history
+                     * for when it leaves the bus. The bus lines follow the
+                     * real output, so this works with mixer threads' copies
+                     * too.
+                     */
+                    HrtfBusState *buses{Device->mHrtfBuses.get()};
+                    ALfloat *RESTRICT busline{voice->Direct.Buffer[parms->Hrtf.Bus +
+                        (buses->Buffer - Device->RealOut.Buffer)] + OutPos};
+                    const ALfloat gain{parms->Hrtf.Old.Gain};
+                    for(ALsizei i{0};i < DstBufferSize;i++)
                     {
-                        /* No fading, just overwrite the old HRTF params. */
-                        parms->Hrtf.Old = parms->Hrtf.Target;
+                        parms->Hrtf.State.History[(voice->Offset+i)&HRTF_HISTORY_MASK] =
+                            samples[i];
+                        busline[i] += samples[i] * gain;
                     }
-                    else if(!(parms->Hrtf.Old.Gain > GAIN_SILENCE_THRESHOLD))
+                    if(tail)
                     {
-                        /* The old HRTF params are silent, so overwrite the old
-                         * coefficients with the new, and reset the old gain to
-                         * 0. The future mix will then fade from silence.
-                         */
-                        parms->Hrtf.Old = parms->Hrtf.Target;
-                        parms->Hrtf.Old.Gain = 0.0f;
+                        if(tail->Pending)
+                        {
+                            tail->Current ^= 1;
+                            tail->Pending = false;
+                        }
+                        MixHrtfTail(voice->Direct.Buffer[lidx], voice->Direct.Buffer[ridx],
+                            samples, OutPos, gain, 0.0f, tail, DstBufferSize
+                        );
                     }
-                    else if(OutPos == 0)
+                    continue;
+                }
+
+                if(!Counter)
+                {
+                    /* No fading, just overwrite the old HRTF params. */
+                    parms->Hrtf.Old = parms->Hrtf.Target;
+                }
+                else if(!(parms->Hrtf.Old.Gain > GAIN_SILENCE_THRESHOLD))
+                {
+                    /* The old HRTF params are silent, so overwrite the old
+                     * coefficients with the new, and reset the old gain to
+                     * 0. The future mix will then fade from silence.
+                     */
+                    parms->Hrtf.Old = parms->Hrtf.Target;
+                    parms->Hrtf.Old.Gain = 0.0f;
+                }
+                else if(OutPos == 0)
+                {
+                    /* First mixing pass, fade between the coefficients. */
+                    fademix = mini(DstBufferSize, 128);
+                    tailfade = true;
+
+                    /* The new coefficients need to fade in completely
+                     * since they're replacing the old ones. To keep the
+                     * gain fading consistent, interpolate between the old
+                     * and new target gains given how much of the fade time
+                     * this mix handles.
+                     */
+                    ALfloat gain{lerp(parms->Hrtf.Old.Gain, parms->Hrtf.Target.Gain,
+                                      minf(1.0f, (ALfloat)fademix/Counter))};
+                    if(Device->HrtfInterp)
                     {
-                        /* First mixing pass, fade between the coefficients. */
-                        fademix = mini(DstBufferSize, 128);
-
-                        /* The new coefficients need to fade in completely
-                         * since they're replacing the old ones. To keep the
-                         * gain fading consistent, interpolate between the old
-                         * and new target gains given how much of the fade time
-                         * this mix handles.
+                        /* Move the old coefficients and delays to the new
+                         * ones, stepping the coefficients in place and
+                         * reading the delays fractionally, so there's only
+                         * one convolution and no comb filtering from mixing
+                         * two delays.
                          */
-                        ALfloat gain{lerp(parms->Hrtf.Old.Gain, parms->Hrtf.Target.Gain,
-                                          minf(1.0f, (ALfloat)fademix/Counter))};
+                        alignas(16) ALfloat coeffstep[HRIR_LENGTH][2];
+                        const ALfloat scale{(ALfloat)HRTF_INTERP_STEP / (ALfloat)fademix};
+                        for(ALsizei i{0};i < IrSize;i++)
+                        {
+                            coeffstep[i][0] = (parms->Hrtf.Target.Coeffs[i][0] -
+                                parms->Hrtf.Old.Coeffs[i][0]) * scale;
+                            coeffstep[i][1] = (parms->Hrtf.Target.Coeffs[i][1] -
+                                parms->Hrtf.Old.Coeffs[i][1]) * scale;
+                        }
+
+                        MixHrtfInterpParams interpparams;
+                        interpparams.Coeffs = parms->Hrtf.Old.Coeffs;
+                        interpparams.CoeffStep = coeffstep;
+                        for(ALsizei i{0};i < 2;i++)
+                        {
+                            interpparams.Delay[i] = (ALfloat)parms->Hrtf.Old.Delay[i];
+                            interpparams.DelayStep[i] = (ALfloat)(parms->Hrtf.Target.Delay[i] -
+                                parms->Hrtf.Old.Delay[i]) / (ALfloat)fademix;
+                        }
+                        interpparams.Gain = parms->Hrtf.Old.Gain;
+                        interpparams.GainStep = (gain - parms->Hrtf.Old.Gain) / (ALfloat)fademix;
+
+                        MixHrtfInterpSamples(
+                            voice->Direct.Buffer[lidx], voice->Direct.Buffer[ridx],
+                            samples, voice->Offset, OutPos, IrSize, &interpparams,
+                            &parms->Hrtf.State, fademix
+                        );
+                        hrtfparams.Gain = interpparams.Gain;
+                    }
+                    else
+                    {
                         hrtfparams.Coeffs = parms->Hrtf.Target.Coeffs;
                         hrtfparams.Delay[0] = parms->Hrtf.Target.Delay[0];
                         hrtfparams.Delay[1] = parms->Hrtf.Target.Delay[1];
@@ -596,65 +1188,120 @@ ALboolean MixSource(ALvoice *voice, ALuint SourceID, ALCcontext *Context, ALsize
                             samples, voice->Offset, OutPos, IrSize, &parms->Hrtf.Old,
                             &hrtfparams, &parms->Hrtf.State, fademix
                         );
-                        /* Update the old parameters with the result. */
-                        parms->Hrtf.Old = parms->Hrtf.Target;
-                        if(fademix < Counter)
-                            parms->Hrtf.Old.Gain = hrtfparams.Gain;
                     }
-
-                    if(fademix < DstBufferSize)
+                    if(tail)
                     {
-                        ALsizei todo = DstBufferSize - fademix;
-                        ALfloat gain = parms->Hrtf.Target.Gain;
-
-                        /* Interpolate the target gain if the gain fading lasts
-                         * longer than this mix.
+                        /* The tail fades between filters in the frequency
+                         * domain, so its input just moves to the new gain.
                          */
-                        if(Counter > DstBufferSize)
-                            gain = lerp(parms->Hrtf.Old.Gain, gain,
-                                        (ALfloat)todo/(Counter-fademix));
+                        if(tail->Pending)
+                        {
+                            tail->Current ^= 1;
+                            tail->Pending = false;
+                            tail->Fade = HRTF_TAIL_FADE_BLOCKS;
+                        }
+                        MixHrtfTail(voice->Direct.Buffer[lidx], voice->Direct.Buffer[ridx],
+                            samples, OutPos, parms->Hrtf.Old.Gain,
+                            (gain - parms->Hrtf.Old.Gain) / (ALfloat)fademix, tail, fademix
+                        );
+                    }
+                    /* Update the old parameters with the result. */
+                    parms->Hrtf.Old = parms->Hrtf.Target;
+                    if(fademix < Counter)
+                        parms->Hrtf.Old.Gain = hrtfparams.Gain;
+                }
 
-                        hrtfparams.Coeffs = parms->Hrtf.Target.Coeffs;
-                        hrtfparams.Delay[0] = parms->Hrtf.Target.Delay[0];
-                        hrtfparams.Delay[1] = parms->Hrtf.Target.Delay[1];
-                        hrtfparams.Gain = parms->Hrtf.Old.Gain;
-                        hrtfparams.GainStep = (gain - parms->Hrtf.Old.Gain) / (ALfloat)todo;
-                        MixHrtfSamples(
-                            voice->Direct.Buffer[lidx], voice->Direct.Buffer[ridx],
-                            samples+fademix, voice->Offset+fademix, OutPos+fademix, IrSize,
-                            &hrtfparams, &parms->Hrtf.State, todo
+                if(fademix < DstBufferSize)
+                {
+                    ALsizei todo = DstBufferSize - fademix;
+                    ALfloat gain = parms->Hrtf.Target.Gain;
+
+                    /* Interpolate the target gain if the gain fading lasts
+                     * longer than this mix.
+                     */
+                    if(Counter > DstBufferSize)
+                        gain = lerp(parms->Hrtf.Old.Gain, gain,
+                                    (ALfloat)todo/(Counter-fademix));
+
+                    hrtfparams.Coeffs = parms->Hrtf.Target.Coeffs;
+                    hrtfparams.Delay[0] = parms->Hrtf.Target.Delay[0];
+                    hrtfparams.Delay[1] = parms->Hrtf.Target.Delay[1];
+                    hrtfparams.Gain = parms->Hrtf.Old.Gain;
+                    hrtfparams.GainStep = (gain - parms->Hrtf.Old.Gain) / (ALfloat)todo;
+                    const ALfloat oldgain{hrtfparams.Gain};
+                    MixHrtfSamples(
+                        voice->Direct.Buffer[lidx], voice->Direct.Buffer[ridx],
+                        samples+fademix, voice->Offset+fademix, OutPos+fademix, IrSize,
+                        &hrtfparams, &parms->Hrtf.State, todo
+                    );
+                    if(tail)
+                    {
+                        if(tail->Pending && !tailfade)
+                        {
+                            tail->Current ^= 1;
+                            tail->Pending = false;
+                        }
+                        MixHrtfTail(voice->Direct.Buffer[lidx], voice->Direct.Buffer[ridx],
+                            samples+fademix, OutPos+fademix, oldgain, hrtfparams.GainStep,
+                            tail, todo
                         );
-                        /* Store the interpolated gain or the final target gain
-                         * depending if the fade is done.
-                         */
-                        if(DstBufferSize < Counter)
-                            parms->Hrtf.Old.Gain = gain;
-                        else
-                            parms->Hrtf.Old.Gain = parms->Hrtf.Target.Gain;
                     }
+                    /* Store the interpolated gain or the final target gain
+                     * depending if the fade is done.
+                     */
+                    if(DstBufferSize < Counter)
+                        parms->Hrtf.Old.Gain = gain;
+                    else
+                        parms->Hrtf.Old.Gain = parms->Hrtf.Target.Gain;
                 }
             }
+        }
 
-            ALfloat (&FilterBuf)[BUFFERSIZE] = Device->TempBuffer[FILTERED_BUF];
-            auto mix_send = [Counter,OutPos,DstBufferSize,chan,ResampledData,&FilterBuf](ALvoice::SendData &send) -> void
-            {
-                if(!send.Buffer)
-                    return;
+        auto mix_send = [Counter,OutPos,DstBufferSize,NumChannels,&ResampledData,Scratch](ALvoice::SendData &send) -> void
+        {
+            if(!send.Buffer)
+                return;
 
-                SendParams *parms = &send.Params[chan];
-                const ALfloat *samples{DoFilters(&parms->LowPass, &parms->HighPass,
-                    FilterBuf, ResampledData, DstBufferSize, send.FilterType
-                )};
+            /* Don't bother filtering and mixing a send that's silent. Its
+             * filter history is reset so nothing stale comes out if it
+             * becomes audible again, and not marking the slot as fed lets
+             * the effect go idle once its tail has played out.
+             */
+            if(IsSendSilent(send, NumChannels, Counter > 0))
+            {
+                for(ALsizei chan{0};chan < NumChannels;chan++)
+                {
+                    SendParams *parms{&send.Params[chan]};
+                    parms->LowPass.clear();
+                    parms->HighPass.clear();
+                    std::copy(std::begin(parms->Gains.Target), std::end(parms->Gains.Target),
+                              std::begin(parms->Gains.Current));
+                }
+                return;
+            }
+            send.Slot->WetFed.store(true, std::memory_order_relaxed);
 
+            const ALfloat *samples[MAX_INPUT_CHANNELS];
+            ALfloat *current[MAX_INPUT_CHANNELS];
+            const ALfloat *target[MAX_INPUT_CHANNELS];
+            for(ALsizei chan{0};chan < NumChannels;chan++)
+            {
+                SendParams *parms{&send.Params[chan]};
+                samples[chan] = DoFilters(&parms->LowPass, &parms->HighPass,
+                    Scratch->FilteredData[chan], Scratch->FilterTemp, ResampledData[chan],
+                    DstBufferSize, send.FilterType
+                );
                 if(!Counter)
                     std::copy(std::begin(parms->Gains.Target), std::end(parms->Gains.Target),
                               std::begin(parms->Gains.Current));
-                MixSamples(samples, send.Channels, send.Buffer,
-                    parms->Gains.Current, parms->Gains.Target, Counter, OutPos, DstBufferSize
-                );
-            };
-            std::for_each(voice->Send, voice->Send+Device->NumAuxSends, mix_send);
-        }
+                current[chan] = parms->Gains.Current;
+                target[chan] = parms->Gains.Target;
+            }
+            MixMultiSamples(samples, NumChannels, send.Channels, send.Buffer, current, target,
+                Counter, OutPos, DstBufferSize
+            );
+        };
+        std::for_each(voice->Send, voice->Send+Device->NumAuxSends, mix_send);
         /* Update positions */
         DataPosFrac += increment*DstBufferSize;
         DataPosInt  += DataPosFrac>>FRACTIONBITS;
@@ -711,23 +1358,170 @@ ALboolean MixSource(ALvoice *voice, ALuint SourceID, ALCcontext *Context, ALsize
         }
     } while(isplaying && OutPos < SamplesToDo);
 
-    voice->Flags |= VOICE_IS_FADING;
+    voice->State->Flags |= VOICE_IS_FADING;
 
     /* Update source info */
     voice->position.store(DataPosInt, std::memory_order_relaxed);
     voice->position_fraction.store(DataPosFrac, std::memory_order_relaxed);
     voice->current_buffer.store(BufferListItem, std::memory_order_release);
 
-    /* Send any events now, after the position/buffer info was updated. */
-    ALbitfieldSOFT enabledevt{Context->EnabledEvts.load(std::memory_order_acquire)};
-    if(buffers_done > 0 && (enabledevt&EventType_BufferCompleted))
+    /* Report the completed buffers. The caller sends any events, after the
+     * position/buffer info was updated.
+     */
+    *BuffersDone = buffers_done;
+
+    return isplaying;
+}
+
+
+void UpdateHrtfBuses(ALCcontext *Context)
+{
+    ALCdevice *device{Context->Device};
+    HrtfBusState *buses{device->mHrtfBuses.get()};
+    ALsizei irSize{device->HrtfHandle->irSize};
+    if(irSize > HRIR_LENGTH) irSize = HRTF_PART_SIZE;
+
+    /* Check the channels already on buses, taking off any that stopped
+     * playing or whose filter is changing. Buses are reset with the device,
+     * so channels left on an unused bus are just taken off.
+     */
+    const ALsizei voicecount{Context->VoiceCount.load(std::memory_order_acquire)};
+    std::for_each(Context->Voices, Context->Voices+voicecount,
+        [buses,irSize](ALvoice *voice) -> void
+        {
+            const ALvoiceState &state = *voice->State;
+            const bool playing{state.Playing.load(std::memory_order_acquire) &&
+                state.SourceID.load(std::memory_order_relaxed) != 0u && state.Step > 0};
+            const bool mixing{playing && (state.Flags&VOICE_HAS_HRTF) &&
+                !(state.Flags&VOICE_IS_CULLED)};
+            for(ALsizei chan{0};chan < voice->NumChannels;chan++)
+            {
+                DirectParams &parms = voice->Direct.Params[chan];
+                if(parms.Hrtf.Bus < 0)
+                    continue;
+                HrtfBus &bus = buses->Bus[parms.Hrtf.Bus];
+                if(!bus.InUse || !mixing || !IsHrtfShareable(parms, irSize))
+                    LeaveHrtfBus(buses, voice, parms, mixing);
+                else
+                    bus.NumMembers++;
+            }
+        }
+    );
+
+    /* Find the mixing channels that could share a bus. */
+    auto &unmatched = buses->Unmatched;
+    unmatched.clear();
+    for(const ALsizei idx : Context->ActiveVoices)
     {
-        AsyncEvent evt{EventType_BufferCompleted};
-        evt.u.bufcomp.id = SourceID;
-        evt.u.bufcomp.count = buffers_done;
-        if(ll_ringbuffer_write(Context->AsyncEvents, &evt, 1) == 1)
-            Context->EventSem.post();
+        ALvoice *voice{Context->Voices[idx]};
+        if(!(voice->State->Flags&VOICE_HAS_HRTF) || (voice->State->Flags&VOICE_IS_CULLED))
+            continue;
+        for(ALsizei chan{0};chan < voice->NumChannels;chan++)
+        {
+            DirectParams &parms = voice->Direct.Params[chan];
+            if(parms.Hrtf.Bus >= 0)
+                continue;
+            if(IsHrtfShareable(parms, irSize))
+                unmatched.emplace_back(voice, chan);
+            else
+                parms.Hrtf.Checked = false;
+        }
     }
 
-    return isplaying;
+    /* Put the channels on a bus with a matching filter. Channels that haven't
+     * been checked yet can also start a new bus with another unmatched
+     * channel.
+     */
+    HrtfBus *buses_end{buses->Bus + MAX_HRTF_BUSES};
+    for(auto iter = unmatched.begin();iter != unmatched.end();++iter)
+    {
+        DirectParams &parms = iter->first->Direct.Params[iter->second];
+        if(parms.Hrtf.Bus >= 0)
+            continue;
+
+        HrtfBus *bus{std::find_if(buses->Bus, buses_end,
+            [&parms,irSize](const HrtfBus &bus) noexcept -> bool
+            { return bus.InUse && HrtfFiltersMatch(bus.Params, parms.Hrtf.Target, irSize); }
+        )};
+        if(bus != buses_end)
+        {
+            JoinHrtfBus(buses, static_cast<ALsizei>(bus - buses->Bus), iter->first, parms,
+                        irSize);
+            continue;
+        }
+        if(parms.Hrtf.Checked)
+            continue;
+
+        bus = std::find_if(buses->Bus, buses_end,
+            [](const HrtfBus &bus) noexcept -> bool { return !bus.InUse; });
+        if(bus == buses_end)
+            continue;
+        parms.Hrtf.Checked = true;
+
+        auto other = std::find_if(unmatched.begin(), unmatched.end(),
+            [&parms,irSize](const std::pair<ALvoice*,ALsizei> &entry) noexcept -> bool
+            {
+                const DirectParams &other = entry.first->Direct.Params[entry.second];
+                return &other != &parms && other.Hrtf.Bus < 0 &&
+                    HrtfFiltersMatch(other.Hrtf.Target, parms.Hrtf.Target, irSize);
+            }
+        );
+        if(other == unmatched.end())
+            continue;
+
+        bus->Params = parms.Hrtf.Target;
+        bus->Params.Gain = 1.0f;
+        std::fill(std::begin(bus->State.History), std::end(bus->State.History), 0.0f);
+        std::fill_n(&bus->State.Values[0][0], HRIR_LENGTH*2, 0.0f);
+        bus->Offset = 0u;
+        bus->NumMembers = 0;
+        bus->InUse = true;
+
+        const auto busidx = static_cast<ALsizei>(bus - buses->Bus);
+        JoinHrtfBus(buses, busidx, iter->first, parms, irSize);
+        JoinHrtfBus(buses, busidx, other->first, other->first->Direct.Params[other->second],
+                    irSize);
+    }
+}
+
+void MixHrtfBuses(ALCdevice *device, ALsizei SamplesToDo)
+{
+    HrtfBusState *buses{device->mHrtfBuses.get()};
+    ALsizei irSize{device->HrtfHandle->irSize};
+    if(irSize > HRIR_LENGTH) irSize = HRTF_PART_SIZE;
+
+    const int lidx{GetChannelIdxByName(&device->RealOut, FrontLeft)};
+    const int ridx{GetChannelIdxByName(&device->RealOut, FrontRight)};
+    assert(lidx != -1 && ridx != -1);
+
+    for(ALsizei i{0};i < MAX_HRTF_BUSES;i++)
+    {
+        HrtfBus &bus = buses->Bus[i];
+        if(!bus.InUse)
+            continue;
+
+        MixHrtfParams hrtfparams;
+        hrtfparams.Coeffs = bus.Params.Coeffs;
+        hrtfparams.Delay[0] = bus.Params.Delay[0];
+        hrtfparams.Delay[1] = bus.Params.Delay[1];
+        hrtfparams.Gain = 1.0f;
+        hrtfparams.GainStep = 0.0f;
+        MixHrtfSamples(device->RealOut.Buffer[lidx], device->RealOut.Buffer[ridx],
+            buses->Buffer[i], bus.Offset, 0, irSize, &hrtfparams, &bus.State, SamplesToDo
+        );
+        bus.Offset += SamplesToDo;
+
+        /* A bus with no members is freed once its delayed input and pending
+         * output have played.
+         */
+        if(bus.NumMembers > 0)
+            bus.RingOut = HRTF_HISTORY_LENGTH + HRIR_LENGTH;
+        else
+        {
+            bus.RingOut -= SamplesToDo;
+            if(bus.RingOut <= 0)
+                bus.InUse = false;
+        }
+        bus.NumMembers = 0;
+    }
 }
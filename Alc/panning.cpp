@@ -617,7 +617,18 @@ void InitHQPanning(ALCdevice *device, const AmbDecConf *conf, const ALsizei (&sp
     InitDistanceComp(device, conf, speakermap);
 }
 
-void InitHrtfPanning(ALCdevice *device)
+/* The ambisonic buffer HRTF rendering mixes to. Full HRTF rendering only
+ * needs first-order for B-Format and effect output, while the other modes mix
+ * all sources into it and decode it with one HRIR convolution per channel.
+ */
+enum class HrtfBusOrder {
+    First,
+    Mixed,
+    Second,
+    Third
+};
+
+void InitHrtfPanning(ALCdevice *device, HrtfBusOrder busorder)
 {
     /* NOTE: azimuth goes clockwise. */
     static constexpr AngularPoint AmbiPoints[] = {
@@ -684,33 +695,192 @@ void InitHrtfPanning(ALCdevice *device)
     }, AmbiOrderHFGainHOA[MAX_AMBI_ORDER+1] = {
         2.40192231e+00f, 1.86052102e+00f, 9.60768923e-01f
     };
+
+    /* The full second- and third-order buses use the vertices of a
+     * dodecahedron, and of a dodecahedron and icosahedron combined,
+     * respectively.
+     */
+    static constexpr AngularPoint AmbiPoints2O[] = {
+        { DEG2RAD( 69.0948426f), DEG2RAD( -90.0000000f) },
+        { DEG2RAD( 69.0948426f), DEG2RAD(  90.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD(-135.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD( -45.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD(  45.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD( 135.0000000f) },
+        { DEG2RAD( 20.9051574f), DEG2RAD(   0.0000000f) },
+        { DEG2RAD( 20.9051574f), DEG2RAD( 180.0000000f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD(-110.9051574f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD( -69.0948426f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD(  69.0948426f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD( 110.9051574f) },
+        { DEG2RAD(-20.9051574f), DEG2RAD(   0.0000000f) },
+        { DEG2RAD(-20.9051574f), DEG2RAD( 180.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD(-135.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD( -45.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD(  45.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD( 135.0000000f) },
+        { DEG2RAD(-69.0948426f), DEG2RAD( -90.0000000f) },
+        { DEG2RAD(-69.0948426f), DEG2RAD(  90.0000000f) },
+    };
+    static constexpr ALfloat AmbiMatrix2O[][MAX_AMBI_COEFFS] = {
+        { 5.00000000e-02f,  3.09016994e-02f,  8.09016994e-02f,  0.00000000e+00f,  0.00000000e+00f,  6.45497224e-02f,  9.04508496e-02f,  0.00000000e+00f, -1.23278999e-02f },
+        { 5.00000000e-02f, -3.09016994e-02f,  8.09016994e-02f,  0.00000000e+00f,  0.00000000e+00f, -6.45497224e-02f,  9.04508496e-02f,  0.00000000e+00f, -1.23278999e-02f },
+        { 5.00000000e-02f,  5.00000000e-02f,  5.00000000e-02f, -5.00000000e-02f, -6.45497225e-02f,  6.45497225e-02f,  0.00000000e+00f, -6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f,  5.00000000e-02f,  5.00000000e-02f,  5.00000000e-02f,  6.45497225e-02f,  6.45497225e-02f,  0.00000000e+00f,  6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f, -5.00000000e-02f,  5.00000000e-02f,  5.00000000e-02f, -6.45497225e-02f, -6.45497225e-02f,  0.00000000e+00f,  6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f, -5.00000000e-02f,  5.00000000e-02f, -5.00000000e-02f,  6.45497225e-02f, -6.45497225e-02f,  0.00000000e+00f, -6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f,  0.00000000e+00f,  3.09016994e-02f,  8.09016995e-02f,  0.00000000e+00f,  0.00000000e+00f, -3.45491503e-02f,  6.45497224e-02f,  8.44966836e-02f },
+        { 5.00000000e-02f,  0.00000000e+00f,  3.09016994e-02f, -8.09016995e-02f,  0.00000000e+00f,  0.00000000e+00f, -3.45491503e-02f, -6.45497224e-02f,  8.44966836e-02f },
+        { 5.00000000e-02f,  8.09016995e-02f,  0.00000000e+00f, -3.09016994e-02f, -6.45497224e-02f,  0.00000000e+00f, -5.59016993e-02f,  0.00000000e+00f, -7.21687836e-02f },
+        { 5.00000000e-02f,  8.09016995e-02f,  0.00000000e+00f,  3.09016994e-02f,  6.45497224e-02f,  0.00000000e+00f, -5.59016993e-02f,  0.00000000e+00f, -7.21687836e-02f },
+        { 5.00000000e-02f, -8.09016995e-02f,  0.00000000e+00f,  3.09016994e-02f, -6.45497224e-02f,  0.00000000e+00f, -5.59016993e-02f,  0.00000000e+00f, -7.21687836e-02f },
+        { 5.00000000e-02f, -8.09016995e-02f,  0.00000000e+00f, -3.09016994e-02f,  6.45497224e-02f,  0.00000000e+00f, -5.59016993e-02f,  0.00000000e+00f, -7.21687836e-02f },
+        { 5.00000000e-02f,  0.00000000e+00f, -3.09016994e-02f,  8.09016995e-02f,  0.00000000e+00f,  0.00000000e+00f, -3.45491503e-02f, -6.45497224e-02f,  8.44966836e-02f },
+        { 5.00000000e-02f,  0.00000000e+00f, -3.09016994e-02f, -8.09016995e-02f,  0.00000000e+00f,  0.00000000e+00f, -3.45491503e-02f,  6.45497224e-02f,  8.44966836e-02f },
+        { 5.00000000e-02f,  5.00000000e-02f, -5.00000000e-02f, -5.00000000e-02f, -6.45497225e-02f, -6.45497225e-02f,  0.00000000e+00f,  6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f,  5.00000000e-02f, -5.00000000e-02f,  5.00000000e-02f,  6.45497225e-02f, -6.45497225e-02f,  0.00000000e+00f, -6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f, -5.00000000e-02f, -5.00000000e-02f,  5.00000000e-02f, -6.45497225e-02f,  6.45497225e-02f,  0.00000000e+00f, -6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f, -5.00000000e-02f, -5.00000000e-02f, -5.00000000e-02f,  6.45497225e-02f,  6.45497225e-02f,  0.00000000e+00f,  6.45497225e-02f,  0.00000000e+00f },
+        { 5.00000000e-02f,  3.09016994e-02f, -8.09016994e-02f,  0.00000000e+00f,  0.00000000e+00f, -6.45497224e-02f,  9.04508496e-02f,  0.00000000e+00f, -1.23278999e-02f },
+        { 5.00000000e-02f, -3.09016994e-02f, -8.09016994e-02f,  0.00000000e+00f,  0.00000000e+00f,  6.45497224e-02f,  9.04508496e-02f,  0.00000000e+00f, -1.23278999e-02f },
+    };
+    static constexpr ALfloat AmbiOrderHFGain2O[MAX_AMBI_ORDER+1] = {
+        2.35702260e+00f, 1.82574186e+00f, 9.42809042e-01f
+    };
+    static constexpr AngularPoint AmbiPoints3O[] = {
+        { DEG2RAD( 69.0948426f), DEG2RAD( -90.0000000f) },
+        { DEG2RAD( 69.0948426f), DEG2RAD(  90.0000000f) },
+        { DEG2RAD( 58.2825256f), DEG2RAD( -90.0000000f) },
+        { DEG2RAD( 58.2825256f), DEG2RAD(  90.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD(-135.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD( -45.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD(  45.0000000f) },
+        { DEG2RAD( 35.2643897f), DEG2RAD( 135.0000000f) },
+        { DEG2RAD( 31.7174744f), DEG2RAD(   0.0000000f) },
+        { DEG2RAD( 31.7174744f), DEG2RAD( 180.0000000f) },
+        { DEG2RAD( 20.9051574f), DEG2RAD(   0.0000000f) },
+        { DEG2RAD( 20.9051574f), DEG2RAD( 180.0000000f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD(-121.7174744f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD(-110.9051574f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD( -69.0948426f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD( -58.2825256f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD(  58.2825256f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD(  69.0948426f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD( 110.9051574f) },
+        { DEG2RAD(  0.0000000f), DEG2RAD( 121.7174744f) },
+        { DEG2RAD(-20.9051574f), DEG2RAD(   0.0000000f) },
+        { DEG2RAD(-20.9051574f), DEG2RAD( 180.0000000f) },
+        { DEG2RAD(-31.7174744f), DEG2RAD(   0.0000000f) },
+        { DEG2RAD(-31.7174744f), DEG2RAD( 180.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD(-135.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD( -45.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD(  45.0000000f) },
+        { DEG2RAD(-35.2643897f), DEG2RAD( 135.0000000f) },
+        { DEG2RAD(-58.2825256f), DEG2RAD( -90.0000000f) },
+        { DEG2RAD(-58.2825256f), DEG2RAD(  90.0000000f) },
+        { DEG2RAD(-69.0948426f), DEG2RAD( -90.0000000f) },
+        { DEG2RAD(-69.0948426f), DEG2RAD(  90.0000000f) },
+    };
+    static constexpr ALfloat AmbiMatrix3O[][MAX_AMBI_COEFFS] = {
+        { 3.12500000e-02f,  1.93135621e-02f,  5.05635620e-02f,  0.00000000e+00f,  0.00000000e+00f,  4.03435765e-02f,  5.65317810e-02f,  0.00000000e+00f, -7.70493746e-03f, -3.19486909e-02f,  0.00000000e+00f,  3.85319787e-02f,  8.36287040e-02f,  0.00000000e+00f,  4.11242326e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f, -1.93135621e-02f,  5.05635620e-02f,  0.00000000e+00f,  0.00000000e+00f, -4.03435765e-02f,  5.65317810e-02f,  0.00000000e+00f, -7.70493746e-03f,  3.19486909e-02f,  0.00000000e+00f, -3.85319787e-02f,  8.36287040e-02f,  0.00000000e+00f,  4.11242326e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f,  2.84560311e-02f,  4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f,  5.41265878e-02f,  4.09067810e-02f,  0.00000000e+00f, -1.67260354e-02f, -5.85683283e-02f,  0.00000000e+00f,  4.63223515e-02f, -1.10849328e-02f,  0.00000000e+00f, -4.47992223e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f, -2.84560311e-02f,  4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f, -5.41265878e-02f,  4.09067810e-02f,  0.00000000e+00f, -1.67260354e-02f,  5.85683283e-02f,  0.00000000e+00f, -4.63223515e-02f, -1.10849328e-02f,  0.00000000e+00f, -4.47992223e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f,  3.12500001e-02f,  3.12500001e-02f, -3.12500001e-02f, -4.03435766e-02f,  4.03435766e-02f,  0.00000000e+00f, -4.03435766e-02f,  0.00000000e+00f,  8.37340323e-02f, -6.33865691e-02f,  3.22186688e-03f, -6.81705474e-02f, -8.02696614e-02f, -4.87293039e-02f,  2.40530672e-02f },
+        { 3.12500000e-02f,  3.12500001e-02f,  3.12500001e-02f,  3.12500001e-02f,  4.03435766e-02f,  4.03435766e-02f,  0.00000000e+00f,  4.03435766e-02f,  0.00000000e+00f,  8.37340323e-02f,  6.33865691e-02f,  3.22186688e-03f, -6.81705474e-02f,  8.02696614e-02f, -4.87293039e-02f, -2.40530672e-02f },
+        { 3.12500000e-02f, -3.12500001e-02f,  3.12500001e-02f,  3.12500001e-02f, -4.03435766e-02f, -4.03435766e-02f,  0.00000000e+00f,  4.03435766e-02f,  0.00000000e+00f, -8.37340323e-02f, -6.33865691e-02f, -3.22186688e-03f, -6.81705474e-02f,  8.02696614e-02f, -4.87293039e-02f, -2.40530672e-02f },
+        { 3.12500000e-02f, -3.12500001e-02f,  3.12500001e-02f, -3.12500001e-02f,  4.03435766e-02f, -4.03435766e-02f,  0.00000000e+00f, -4.03435766e-02f,  0.00000000e+00f, -8.37340323e-02f,  6.33865691e-02f, -3.22186688e-03f, -6.81705474e-02f, -8.02696614e-02f, -4.87293039e-02f,  2.40530672e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f,  2.84560311e-02f,  4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f, -5.96821894e-03f,  5.41265878e-02f,  4.37893293e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f,  1.79357978e-02f,  4.22050021e-02f,  7.24866642e-02f,  1.86704001e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f,  2.84560311e-02f, -4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f, -5.96821894e-03f, -5.41265878e-02f,  4.37893293e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f,  1.79357978e-02f, -4.22050021e-02f,  7.24866642e-02f, -1.86704001e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f,  1.93135621e-02f,  5.05635621e-02f,  0.00000000e+00f,  0.00000000e+00f, -2.15932190e-02f,  4.03435765e-02f,  5.28104272e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f,  1.66173614e-03f, -8.37234735e-02f,  5.00267015e-02f,  4.09309491e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f,  1.93135621e-02f, -5.05635621e-02f,  0.00000000e+00f,  0.00000000e+00f, -2.15932190e-02f, -4.03435765e-02f,  5.28104272e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f,  1.66173614e-03f,  8.37234735e-02f,  5.00267015e-02f, -4.09309491e-02f },
+        { 3.12500000e-02f,  4.60428257e-02f,  0.00000000e+00f, -2.84560312e-02f, -5.41265878e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -2.70632939e-02f,  3.61972177e-02f,  0.00000000e+00f, -2.86287877e-02f,  0.00000000e+00f,  6.82891278e-02f,  0.00000000e+00f,  3.02093420e-02f },
+        { 3.12500000e-02f,  5.05635620e-02f,  0.00000000e+00f, -1.93135621e-02f, -4.03435765e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -4.51054898e-02f, -9.12976421e-02f,  0.00000000e+00f, -1.87003526e-02f,  0.00000000e+00f,  4.05671815e-02f,  0.00000000e+00f,  2.93212553e-02f },
+        { 3.12500000e-02f,  5.05635620e-02f,  0.00000000e+00f,  1.93135621e-02f,  4.03435765e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -4.51054898e-02f, -9.12976421e-02f,  0.00000000e+00f, -1.87003526e-02f,  0.00000000e+00f, -4.05671815e-02f,  0.00000000e+00f, -2.93212553e-02f },
+        { 3.12500000e-02f,  4.60428257e-02f,  0.00000000e+00f,  2.84560312e-02f,  5.41265878e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -2.70632939e-02f,  3.61972177e-02f,  0.00000000e+00f, -2.86287877e-02f,  0.00000000e+00f, -6.82891278e-02f,  0.00000000e+00f, -3.02093420e-02f },
+        { 3.12500000e-02f, -4.60428257e-02f,  0.00000000e+00f,  2.84560312e-02f, -5.41265878e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -2.70632939e-02f, -3.61972177e-02f,  0.00000000e+00f,  2.86287877e-02f,  0.00000000e+00f, -6.82891278e-02f,  0.00000000e+00f, -3.02093420e-02f },
+        { 3.12500000e-02f, -5.05635620e-02f,  0.00000000e+00f,  1.93135621e-02f, -4.03435765e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -4.51054898e-02f,  9.12976421e-02f,  0.00000000e+00f,  1.87003526e-02f,  0.00000000e+00f, -4.05671815e-02f,  0.00000000e+00f, -2.93212553e-02f },
+        { 3.12500000e-02f, -5.05635620e-02f,  0.00000000e+00f, -1.93135621e-02f,  4.03435765e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -4.51054898e-02f,  9.12976421e-02f,  0.00000000e+00f,  1.87003526e-02f,  0.00000000e+00f,  4.05671815e-02f,  0.00000000e+00f,  2.93212553e-02f },
+        { 3.12500000e-02f, -4.60428257e-02f,  0.00000000e+00f, -2.84560312e-02f,  5.41265878e-02f,  0.00000000e+00f, -3.49385621e-02f,  0.00000000e+00f, -2.70632939e-02f, -3.61972177e-02f,  0.00000000e+00f,  2.86287877e-02f,  0.00000000e+00f,  6.82891278e-02f,  0.00000000e+00f,  3.02093420e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f, -1.93135621e-02f,  5.05635621e-02f,  0.00000000e+00f,  0.00000000e+00f, -2.15932190e-02f, -4.03435765e-02f,  5.28104272e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f, -1.66173614e-03f, -8.37234735e-02f, -5.00267015e-02f,  4.09309491e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f, -1.93135621e-02f, -5.05635621e-02f,  0.00000000e+00f,  0.00000000e+00f, -2.15932190e-02f,  4.03435765e-02f,  5.28104272e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f, -1.66173614e-03f,  8.37234735e-02f, -5.00267015e-02f, -4.09309491e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f, -2.84560311e-02f,  4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f, -5.96821894e-03f, -5.41265878e-02f,  4.37893293e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f, -1.79357978e-02f,  4.22050021e-02f, -7.24866642e-02f,  1.86704001e-02f },
+        { 3.12500000e-02f,  0.00000000e+00f, -2.84560311e-02f, -4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f, -5.96821894e-03f,  5.41265878e-02f,  4.37893293e-02f,  0.00000000e+00f,  0.00000000e+00f,  0.00000000e+00f, -1.79357978e-02f, -4.22050021e-02f, -7.24866642e-02f, -1.86704001e-02f },
+        { 3.12500000e-02f,  3.12500001e-02f, -3.12500001e-02f, -3.12500001e-02f, -4.03435766e-02f, -4.03435766e-02f,  0.00000000e+00f,  4.03435766e-02f,  0.00000000e+00f,  8.37340323e-02f,  6.33865691e-02f,  3.22186688e-03f,  6.81705474e-02f, -8.02696614e-02f,  4.87293039e-02f,  2.40530672e-02f },
+        { 3.12500000e-02f,  3.12500001e-02f, -3.12500001e-02f,  3.12500001e-02f,  4.03435766e-02f, -4.03435766e-02f,  0.00000000e+00f, -4.03435766e-02f,  0.00000000e+00f,  8.37340323e-02f, -6.33865691e-02f,  3.22186688e-03f,  6.81705474e-02f,  8.02696614e-02f,  4.87293039e-02f, -2.40530672e-02f },
+        { 3.12500000e-02f, -3.12500001e-02f, -3.12500001e-02f,  3.12500001e-02f, -4.03435766e-02f,  4.03435766e-02f,  0.00000000e+00f, -4.03435766e-02f,  0.00000000e+00f, -8.37340323e-02f,  6.33865691e-02f, -3.22186688e-03f,  6.81705474e-02f,  8.02696614e-02f,  4.87293039e-02f, -2.40530672e-02f },
+        { 3.12500000e-02f, -3.12500001e-02f, -3.12500001e-02f, -3.12500001e-02f,  4.03435766e-02f,  4.03435766e-02f,  0.00000000e+00f,  4.03435766e-02f,  0.00000000e+00f, -8.37340323e-02f, -6.33865691e-02f, -3.22186688e-03f,  6.81705474e-02f, -8.02696614e-02f,  4.87293039e-02f,  2.40530672e-02f },
+        { 3.12500000e-02f,  2.84560311e-02f, -4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f, -5.41265878e-02f,  4.09067810e-02f,  0.00000000e+00f, -1.67260354e-02f, -5.85683283e-02f,  0.00000000e+00f,  4.63223515e-02f,  1.10849328e-02f,  0.00000000e+00f,  4.47992223e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f, -2.84560311e-02f, -4.60428256e-02f,  0.00000000e+00f,  0.00000000e+00f,  5.41265878e-02f,  4.09067810e-02f,  0.00000000e+00f, -1.67260354e-02f,  5.85683283e-02f,  0.00000000e+00f, -4.63223515e-02f,  1.10849328e-02f,  0.00000000e+00f,  4.47992223e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f,  1.93135621e-02f, -5.05635620e-02f,  0.00000000e+00f,  0.00000000e+00f, -4.03435765e-02f,  5.65317810e-02f,  0.00000000e+00f, -7.70493746e-03f, -3.19486909e-02f,  0.00000000e+00f,  3.85319787e-02f, -8.36287040e-02f,  0.00000000e+00f, -4.11242326e-02f,  0.00000000e+00f },
+        { 3.12500000e-02f, -1.93135621e-02f, -5.05635620e-02f,  0.00000000e+00f,  0.00000000e+00f,  4.03435765e-02f,  5.65317810e-02f,  0.00000000e+00f, -7.70493746e-03f,  3.19486909e-02f,  0.00000000e+00f, -3.85319787e-02f, -8.36287040e-02f,  0.00000000e+00f, -4.11242326e-02f,  0.00000000e+00f },
+    };
+    static constexpr ALfloat AmbiOrderHFGain3O[MAX_AMBI_ORDER+1] = {
+        2.35916882e+00f, 2.03156594e+00f, 1.44459839e+00f, 7.18949585e-01f
+    };
     static constexpr ALsizei IndexMap[6] = { 0, 1, 2, 3, 4, 8 };
     static constexpr ALsizei ChansPerOrder[MAX_AMBI_ORDER+1] = { 1, 3, 2, 0 };
+    static constexpr ALsizei ChansPerOrderFull[MAX_AMBI_ORDER+1] = { 1, 3, 5, 7 };
+    const AngularPoint *RESTRICT Points = AmbiPoints;
+    ALsizei NumPoints{static_cast<ALsizei>(COUNTOF(AmbiPoints))};
     const ALfloat (*RESTRICT AmbiMatrix)[MAX_AMBI_COEFFS] = AmbiMatrixFOA;
     const ALfloat *RESTRICT AmbiOrderHFGain = AmbiOrderHFGainFOA;
+    const ALsizei *RESTRICT NfcChansPerOrder = ChansPerOrder;
     ALsizei count{4};
+    ALsizei order{1};
 
     static_assert(COUNTOF(AmbiPoints) == COUNTOF(AmbiMatrixFOA), "FOA Ambisonic HRTF mismatch");
     static_assert(COUNTOF(AmbiPoints) == COUNTOF(AmbiMatrixHOA), "HOA Ambisonic HRTF mismatch");
+    static_assert(COUNTOF(AmbiPoints2O) == COUNTOF(AmbiMatrix2O), "2O Ambisonic HRTF mismatch");
+    static_assert(COUNTOF(AmbiPoints3O) == COUNTOF(AmbiMatrix3O), "3O Ambisonic HRTF mismatch");
 
     /* Don't bother with HOA when using full HRTF rendering. Nothing needs it,
      * and it eases the CPU/memory load.
      */
-    if(device->Render_Mode != HrtfRender)
+    switch(busorder)
     {
-        device->AmbiUp.reset(new AmbiUpsampler{});
-
+    case HrtfBusOrder::First:
+        break;
+    case HrtfBusOrder::Mixed:
         AmbiMatrix = AmbiMatrixHOA;
         AmbiOrderHFGain = AmbiOrderHFGainHOA;
         count = static_cast<ALsizei>(COUNTOF(IndexMap));
+        order = 2;
+        break;
+    case HrtfBusOrder::Second:
+        Points = AmbiPoints2O;
+        NumPoints = static_cast<ALsizei>(COUNTOF(AmbiPoints2O));
+        AmbiMatrix = AmbiMatrix2O;
+        AmbiOrderHFGain = AmbiOrderHFGain2O;
+        NfcChansPerOrder = ChansPerOrderFull;
+        count = 9;
+        order = 2;
+        break;
+    case HrtfBusOrder::Third:
+        Points = AmbiPoints3O;
+        NumPoints = static_cast<ALsizei>(COUNTOF(AmbiPoints3O));
+        AmbiMatrix = AmbiMatrix3O;
+        AmbiOrderHFGain = AmbiOrderHFGain3O;
+        NfcChansPerOrder = ChansPerOrderFull;
+        count = 16;
+        order = 3;
+        break;
     }
+    if(busorder != HrtfBusOrder::First)
+        device->AmbiUp.reset(new AmbiUpsampler{});
 
     device->mHrtfState.reset(
         new (al_calloc(16, FAM_SIZE(DirectHrtfState, Chan, count))) DirectHrtfState{});
 
-    std::transform(std::begin(IndexMap), std::begin(IndexMap)+count, std::begin(device->Dry.Ambi.Map),
-        [](const ALsizei &index) noexcept { return BFChannelConfig{1.0f, index}; }
-    );
+    /* The mixed-order bus skips some second-order channels, while the full
+     * buses use all channels in ACN order.
+     */
+    auto make_config = [](const ALsizei &index) noexcept { return BFChannelConfig{1.0f, index}; };
+    if(busorder == HrtfBusOrder::First || busorder == HrtfBusOrder::Mixed)
+        std::transform(std::begin(IndexMap), std::begin(IndexMap)+count,
+            std::begin(device->Dry.Ambi.Map), make_config);
+    else for(ALsizei i{0};i < count;i++)
+        device->Dry.Ambi.Map[i] = make_config(i);
     device->Dry.CoeffCount = 0;
     device->Dry.NumChannels = count;
 
@@ -735,12 +905,11 @@ void InitHrtfPanning(ALCdevice *device)
     device->RealOut.NumChannels = ChannelsFromDevFmt(device->FmtChans, device->mAmbiOrder);
 
     BuildBFormatHrtf(device->HrtfHandle,
-        device->mHrtfState.get(), device->Dry.NumChannels, AmbiPoints, AmbiMatrix,
-        static_cast<ALsizei>(COUNTOF(AmbiPoints)), AmbiOrderHFGain
+        device->mHrtfState.get(), device->Dry.NumChannels, Points, AmbiMatrix, NumPoints,
+        AmbiOrderHFGain
     );
 
-    InitNearFieldCtrl(device, device->HrtfHandle->distance, device->AmbiUp ? 2 : 1,
-                      ChansPerOrder);
+    InitNearFieldCtrl(device, device->HrtfHandle->distance, order, NfcChansPerOrder);
 }
 
 void InitUhjPanning(ALCdevice *device)
@@ -801,60 +970,72 @@ void CalcAmbiCoeffs(const ALfloat y, const ALfloat z, const ALfloat x, const ALf
 
     if(spread > 0.0f)
     {
-        /* Implement the spread by using a spherical source that subtends the
-         * angle spread. See:
-         * http://www.ppsloan.org/publications/StupidSH36.pdf - Appendix A3
-         *
-         * When adjusted for N3D normalization instead of SN3D, these
-         * calculations are:
-         *
-         * ZH0 = -sqrt(pi) * (-1+ca);
-         * ZH1 =  0.5*sqrt(pi) * sa*sa;
-         * ZH2 = -0.5*sqrt(pi) * ca*(-1+ca)*(ca+1);
-         * ZH3 = -0.125*sqrt(pi) * (-1+ca)*(ca+1)*(5*ca*ca - 1);
-         * ZH4 = -0.125*sqrt(pi) * ca*(-1+ca)*(ca+1)*(7*ca*ca - 3);
-         * ZH5 = -0.0625*sqrt(pi) * (-1+ca)*(ca+1)*(21*ca*ca*ca*ca - 14*ca*ca + 1);
-         *
-         * The gain of the source is compensated for size, so that the
-         * loudness doesn't depend on the spread. Thus:
-         *
-         * ZH0 = 1.0f;
-         * ZH1 = 0.5f * (ca+1.0f);
-         * ZH2 = 0.5f * (ca+1.0f)*ca;
-         * ZH3 = 0.125f * (ca+1.0f)*(5.0f*ca*ca - 1.0f);
-         * ZH4 = 0.125f * (ca+1.0f)*(7.0f*ca*ca - 3.0f)*ca;
-         * ZH5 = 0.0625f * (ca+1.0f)*(21.0f*ca*ca*ca*ca - 14.0f*ca*ca + 1.0f);
-         */
-        ALfloat ca = std::cos(spread * 0.5f);
-        /* Increase the source volume by up to +3dB for a full spread. */
-        ALfloat scale = std::sqrt(1.0f + spread/F_TAU);
-
-        ALfloat ZH0_norm = scale;
-        ALfloat ZH1_norm = 0.5f * (ca+1.f) * scale;
-        ALfloat ZH2_norm = 0.5f * (ca+1.f)*ca * scale;
-        ALfloat ZH3_norm = 0.125f * (ca+1.f)*(5.f*ca*ca-1.f) * scale;
+        ALfloat norms[4];
+        CalcAmbiSpreadNorms(spread, norms);
 
         /* Zeroth-order */
-        coeffs[0]  *= ZH0_norm;
+        coeffs[0]  *= norms[0];
         /* First-order */
-        coeffs[1]  *= ZH1_norm;
-        coeffs[2]  *= ZH1_norm;
-        coeffs[3]  *= ZH1_norm;
+        coeffs[1]  *= norms[1];
+        coeffs[2]  *= norms[1];
+        coeffs[3]  *= norms[1];
         /* Second-order */
-        coeffs[4]  *= ZH2_norm;
-        coeffs[5]  *= ZH2_norm;
-        coeffs[6]  *= ZH2_norm;
-        coeffs[7]  *= ZH2_norm;
-        coeffs[8]  *= ZH2_norm;
+        coeffs[4]  *= norms[2];
+        coeffs[5]  *= norms[2];
+        coeffs[6]  *= norms[2];
+        coeffs[7]  *= norms[2];
+        coeffs[8]  *= norms[2];
         /* Third-order */
-        coeffs[9]  *= ZH3_norm;
-        coeffs[10] *= ZH3_norm;
-        coeffs[11] *= ZH3_norm;
-        coeffs[12] *= ZH3_norm;
-        coeffs[13] *= ZH3_norm;
-        coeffs[14] *= ZH3_norm;
-        coeffs[15] *= ZH3_norm;
+        coeffs[9]  *= norms[3];
+        coeffs[10] *= norms[3];
+        coeffs[11] *= norms[3];
+        coeffs[12] *= norms[3];
+        coeffs[13] *= norms[3];
+        coeffs[14] *= norms[3];
+        coeffs[15] *= norms[3];
+    }
+}
+
+void CalcAmbiSpreadNorms(const ALfloat spread, ALfloat (&norms)[4])
+{
+    if(!(spread > 0.0f))
+    {
+        std::fill(std::begin(norms), std::end(norms), 1.0f);
+        return;
     }
+
+    /* Implement the spread by using a spherical source that subtends the
+     * angle spread. See:
+     * http://www.ppsloan.org/publications/StupidSH36.pdf - Appendix A3
+     *
+     * When adjusted for N3D normalization instead of SN3D, these
+     * calculations are:
+     *
+     * ZH0 = -sqrt(pi) * (-1+ca);
+     * ZH1 =  0.5*sqrt(pi) * sa*sa;
+     * ZH2 = -0.5*sqrt(pi) * ca*(-1+ca)*(ca+1);
+     * ZH3 = -0.125*sqrt(pi) * (-1+ca)*(ca+1)*(5*ca*ca - 1);
+     * ZH4 = -0.125*sqrt(pi) * ca*(-1+ca)*(ca+1)*(7*ca*ca - 3);
+     * ZH5 = -0.0625*sqrt(pi) * (-1+ca)*(ca+1)*(21*ca*ca*ca*ca - 14*ca*ca + 1);
+     *
+     * The gain of the source is compensated for size, so that the
+     * loudness doesn't depend on the spread. Thus:
+     *
+     * ZH0 = 1.0f;
+     * ZH1 = 0.5f * (ca+1.0f);
+     * ZH2 = 0.5f * (ca+1.0f)*ca;
+     * ZH3 = 0.125f * (ca+1.0f)*(5.0f*ca*ca - 1.0f);
+     * ZH4 = 0.125f * (ca+1.0f)*(7.0f*ca*ca - 3.0f)*ca;
+     * ZH5 = 0.0625f * (ca+1.0f)*(21.0f*ca*ca*ca*ca - 14.0f*ca*ca + 1.0f);
+     */
+    ALfloat ca = std::cos(spread * 0.5f);
+    /* Increase the source volume by up to +3dB for a full spread. */
+    ALfloat scale = std::sqrt(1.0f + spread/F_TAU);
+
+    norms[0] = scale;
+    norms[1] = 0.5f * (ca+1.f) * scale;
+    norms[2] = 0.5f * (ca+1.f)*ca * scale;
+    norms[3] = 0.125f * (ca+1.f)*(5.f*ca*ca-1.f) * scale;
 }
 
 
@@ -887,13 +1068,68 @@ void ComputePanningGainsBF(const BFChannelConfig *chanmap, ALsizei numchans, con
 }
 
 
+Hrtf *LoadDeviceHrtf(const al::vector<EnumeratedHrtf> &list, ALint hrtf_id, ALuint frequency,
+                     std::string *name)
+{
+    if(hrtf_id >= 0 && (size_t)hrtf_id < list.size())
+    {
+        const EnumeratedHrtf &entry = list[hrtf_id];
+        Hrtf *hrtf{GetLoadedHrtf(entry.hrtf)};
+        if(hrtf && hrtf->sampleRate == frequency)
+        {
+            *name = entry.name;
+            return hrtf;
+        }
+        if(hrtf)
+            Hrtf_DecRef(hrtf);
+    }
+
+    Hrtf *ret{nullptr};
+    auto find_hrtf = [frequency,name,&ret](const EnumeratedHrtf &entry) -> bool
+    {
+        Hrtf *hrtf{GetLoadedHrtf(entry.hrtf)};
+        if(!hrtf) return false;
+        if(hrtf->sampleRate != frequency)
+        {
+            Hrtf_DecRef(hrtf);
+            return false;
+        }
+        ret = hrtf;
+        *name = entry.name;
+        return true;
+    };
+    std::find_if(list.cbegin(), list.cend(), find_hrtf);
+    if(ret || !GetConfigValueBool(nullptr, nullptr, "hrtf-resample", 1))
+        return ret;
+
+    /* No data set matches the device rate, so resample one. */
+    auto resample_hrtf = [frequency,name,&ret](const EnumeratedHrtf &entry) -> bool
+    {
+        ret = GetResampledHrtf(entry.hrtf, frequency);
+        if(!ret) return false;
+        *name = entry.name;
+        return true;
+    };
+    if(hrtf_id >= 0 && (size_t)hrtf_id < list.size())
+        resample_hrtf(list[hrtf_id]);
+    if(!ret)
+        std::find_if(list.cbegin(), list.cend(), resample_hrtf);
+    return ret;
+}
+
 void aluInitRenderer(ALCdevice *device, ALint hrtf_id, HrtfRequestMode hrtf_appreq, HrtfRequestMode hrtf_userreq)
 {
     /* Hold the HRTF the device last used, in case it's used again. */
     Hrtf *old_hrtf{device->HrtfHandle};
 
+    /* Any background HRTF load is for a previous configuration. */
+    device->HrtfLoadId++;
+    device->HrtfLoadRequest = false;
+
     device->mHrtfState = nullptr;
     device->HrtfHandle = nullptr;
+    device->HrtfInterp = false;
+    device->mHrtfBuses = nullptr;
     device->HrtfName.clear();
     device->Render_Mode = NormalRender;
 
@@ -1039,38 +1275,38 @@ void aluInitRenderer(ALCdevice *device, ALint hrtf_id, HrtfRequestMode hrtf_appr
         device->HrtfStatus = ALC_HRTF_REQUIRED_SOFT;
     }
 
-    if(device->HrtfList.empty())
-        device->HrtfList = EnumerateHrtf(device->DeviceName.c_str());
-
-    if(hrtf_id >= 0 && (size_t)hrtf_id < device->HrtfList.size())
+    if(device->HrtfLoaded)
     {
-        const EnumeratedHrtf &entry = device->HrtfList[hrtf_id];
-        Hrtf *hrtf{GetLoadedHrtf(entry.hrtf)};
-        if(hrtf && hrtf->sampleRate == device->Frequency)
-        {
-            device->HrtfHandle = hrtf;
-            device->HrtfName = entry.name;
-        }
-        else if(hrtf)
-            Hrtf_DecRef(hrtf);
+        /* Use the HRTF that finished loading in the background. */
+        device->HrtfHandle = device->HrtfLoaded;
+        device->HrtfName = std::move(device->HrtfLoadedName);
+        device->HrtfLoaded = nullptr;
     }
-
-    if(!device->HrtfHandle)
+    else
     {
-        auto find_hrtf = [device](const EnumeratedHrtf &entry) -> bool
+        /* With asynchronous loading, start without HRTF if it isn't already
+         * loaded, and switch to it once it is. Enumerating and loading HRTFs
+         * can take a while.
+         */
+        auto is_loaded = [device,hrtf_id,old_hrtf]() -> bool
         {
-            Hrtf *hrtf{GetLoadedHrtf(entry.hrtf)};
-            if(!hrtf) return false;
-            if(hrtf->sampleRate != device->Frequency)
-            {
-                Hrtf_DecRef(hrtf);
+            if(device->HrtfList.empty())
                 return false;
-            }
-            device->HrtfHandle = hrtf;
-            device->HrtfName = entry.name;
-            return true;
+            if(hrtf_id >= 0 && (size_t)hrtf_id < device->HrtfList.size())
+                return IsHrtfLoaded(device->HrtfList[hrtf_id].hrtf, device->Frequency);
+            return old_hrtf != nullptr;
         };
-        std::find_if(device->HrtfList.cbegin(), device->HrtfList.cend(), find_hrtf);
+        if(!is_loaded() && GetConfigValueBool(device->DeviceName.c_str(), nullptr, "hrtf-async", 0))
+        {
+            TRACE("Loading HRTF in the background\n");
+            device->HrtfLoadRequest = true;
+            goto no_hrtf;
+        }
+
+        if(device->HrtfList.empty())
+            device->HrtfList = EnumerateHrtf(device->DeviceName.c_str());
+        device->HrtfHandle = LoadDeviceHrtf(device->HrtfList, hrtf_id, device->Frequency,
+                                            &device->HrtfName);
     }
 
     if(device->HrtfHandle)
@@ -1080,21 +1316,50 @@ void aluInitRenderer(ALCdevice *device, ALint hrtf_id, HrtfRequestMode hrtf_appr
         old_hrtf = nullptr;
 
         device->Render_Mode = HrtfRender;
+        HrtfBusOrder busorder{HrtfBusOrder::First};
+        const char *modename{"Full"};
         const char *mode;
         if(ConfigValueStr(device->DeviceName.c_str(), nullptr, "hrtf-mode", &mode))
         {
             if(strcasecmp(mode, "full") == 0)
                 device->Render_Mode = HrtfRender;
             else if(strcasecmp(mode, "basic") == 0)
+            {
                 device->Render_Mode = NormalRender;
+                busorder = HrtfBusOrder::Mixed;
+                modename = "Basic";
+            }
+            else if(strcasecmp(mode, "ambi2") == 0)
+            {
+                device->Render_Mode = NormalRender;
+                busorder = HrtfBusOrder::Second;
+                modename = "Second-order ambisonic";
+            }
+            else if(strcasecmp(mode, "ambi3") == 0)
+            {
+                device->Render_Mode = NormalRender;
+                busorder = HrtfBusOrder::Third;
+                modename = "Third-order ambisonic";
+            }
             else
                 ERR("Unexpected hrtf-mode: %s\n", mode);
         }
 
-        TRACE("%s HRTF rendering enabled, using \"%s\"\n",
-            ((device->Render_Mode == HrtfRender) ? "Full" : "Basic"), device->HrtfName.c_str()
-        );
-        InitHrtfPanning(device);
+        if(device->Render_Mode == HrtfRender)
+        {
+            device->HrtfInterp = GetConfigValueBool(device->DeviceName.c_str(), nullptr,
+                                                    "hrtf-interp", 0);
+            if(GetConfigValueBool(device->DeviceName.c_str(), nullptr, "hrtf-share", 0))
+            {
+                device->mHrtfBuses.reset(new HrtfBusState{});
+                device->mHrtfBuses->Unmatched.reserve(64);
+            }
+        }
+
+        TRACE("%s HRTF rendering enabled, using \"%s\"%s%s\n", modename,
+            device->HrtfName.c_str(), device->HrtfInterp ? " (interpolated)" : "",
+            device->mHrtfBuses ? " (shared)" : "");
+        InitHrtfPanning(device, busorder);
         return;
     }
     device->HrtfStatus = ALC_HRTF_UNSUPPORTED_FORMAT_SOFT;
@@ -1,6 +1,9 @@
 #ifndef _AL_AUXEFFECTSLOT_H_
 #define _AL_AUXEFFECTSLOT_H_
 
+#include <cmath>
+#include <limits>
+
 #include "alMain.h"
 #include "alEffect.h"
 
@@ -9,7 +12,22 @@
 
 
 struct ALeffectslot;
+struct ALbuffer;
+
+
+/* The level an effect's output needs to decay to, relative to its input, for
+ * its tail to be done. This is well below the silence threshold, to allow for
+ * effects that boost the signal.
+ */
+#define EFFECT_TAIL_LEVEL (1.0e-7f) /* -140dB */
 
+/* Converts a tail length in samples to the int range, rounding up. */
+inline ALsizei EffectTailLength(ALfloat samples) noexcept
+{
+    if(!(samples < 2147483520.0f)) /* largest float below INT_MAX */
+        return std::numeric_limits<ALsizei>::max();
+    return samples > 0.0f ? static_cast<ALsizei>(std::ceil(samples)) : 0;
+}
 
 struct EffectState {
     RefCount mRef{1u};
@@ -17,12 +35,30 @@ struct EffectState {
     ALfloat (*mOutBuffer)[BUFFERSIZE]{nullptr};
     ALsizei mOutChannels{0};
 
+    /* How many samples the effect keeps producing output for after its input
+     * goes silent, as set by update(), or -1 if it never stops. Once nothing
+     * was fed to it for that long, the mixer skips processing it until it's
+     * fed again. TailLeft counts down the rest of the current tail.
+     */
+    ALsizei mTailLength{-1};
+    ALsizei mTailLeft{0};
+
 
     virtual ~EffectState() = default;
 
     virtual ALboolean deviceUpdate(ALCdevice *device) = 0;
     virtual void update(const ALCcontext *context, const ALeffectslot *slot, const ALeffectProps *props) = 0;
     virtual void process(ALsizei samplesToDo, const ALfloat (*RESTRICT samplesIn)[BUFFERSIZE], ALfloat (*RESTRICT samplesOut)[BUFFERSIZE], ALsizei numChannels) = 0;
+    /* Called in place of process() while the effect is idle, for effects
+     * with oscillators that should keep running in time.
+     */
+    virtual void skip(ALsizei UNUSED(samplesToDo)) { }
+    /* Gives the effect the slot's buffer, for effects that take sample data
+     * (e.g. an impulse response). Called before deviceUpdate() on a new state,
+     * without the backend lock, so it can do any lengthy preparation.
+     */
+    virtual ALboolean setBuffer(ALCdevice *UNUSED(device), const ALbuffer *UNUSED(buffer))
+    { return AL_TRUE; }
 
     void IncRef() noexcept;
     void DecRef() noexcept;
@@ -69,6 +105,9 @@ struct ALeffectslot {
         EffectState *State{nullptr};
     } Effect;
 
+    /* Buffer given to the effect state, holding a reference to it. */
+    ALbuffer *Buffer{nullptr};
+
     std::atomic_flag PropsClean{true};
 
     RefCount ref{0u};
@@ -107,6 +146,12 @@ struct ALeffectslot {
      * output (FOAOut).
      */
     alignas(16) ALfloat WetBuffer[MAX_EFFECT_CHANNELS][BUFFERSIZE];
+    /* Set when voices mix to the wet buffer during an update, and the number
+     * of samples at the start of it that need clearing for the next update.
+     * Slots nothing is fed to keep a silent wet buffer without clearing it.
+     */
+    std::atomic<bool> WetFed{false};
+    ALsizei WetSamples{BUFFERSIZE};
 
     ALeffectslot() = default;
     ALeffectslot(const ALeffectslot&) = delete;
@@ -135,6 +180,7 @@ EffectStateFactory *ModulatorStateFactory_getFactory(void);
 EffectStateFactory *PshifterStateFactory_getFactory(void);
 
 EffectStateFactory *DedicatedStateFactory_getFactory(void);
+EffectStateFactory *ConvolutionStateFactory_getFactory(void);
 
 
 ALenum InitializeEffect(ALCcontext *Context, ALeffectslot *EffectSlot, ALeffect *effect);
@@ -20,6 +20,7 @@ enum {
     MODULATOR_EFFECT,
     PSHIFTER_EFFECT,
     DEDICATED_EFFECT,
+    CONVOLUTION_EFFECT,
 
     MAX_EFFECTS
 };
@@ -32,7 +33,7 @@ struct EffectList {
     int type;
     ALenum val;
 };
-#define EFFECTLIST_SIZE 14
+#define EFFECTLIST_SIZE 15
 extern const EffectList EffectList[EFFECTLIST_SIZE];
 
 
@@ -70,6 +71,7 @@ extern const ALeffectVtable ALmodulator_vtable;
 extern const ALeffectVtable ALnull_vtable;
 extern const ALeffectVtable ALpshifter_vtable;
 extern const ALeffectVtable ALdedicated_vtable;
+extern const ALeffectVtable ALconvolution_vtable;
 
 
 typedef union ALeffectProps {
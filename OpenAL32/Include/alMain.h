@@ -239,7 +239,11 @@ static const union {
 struct Hrtf;
 struct HrtfEntry;
 struct DirectHrtfState;
+struct HrtfBusState;
 struct FrontStablizer;
+struct MixerScratch;
+struct MixThreadState;
+class MixerPool;
 struct Compressor;
 struct ALCbackend;
 struct ALbuffer;
@@ -675,6 +679,9 @@ typedef struct RealMixParams {
 
 typedef void (*POSTPROCESS)(ALCdevice *device, ALsizei SamplesToDo);
 
+/* Maximum number of threads used to mix a device's voices. */
+#define MAX_MIXER_THREADS 64
+
 struct ALCdevice_struct {
     RefCount ref{1u};
 
@@ -705,6 +712,17 @@ struct ALCdevice_struct {
     al::vector<EnumeratedHrtf> HrtfList;
     ALCenum HrtfStatus{ALC_FALSE};
 
+    /* Background HRTF loading (the hrtf-async option). The renderer sets
+     * HrtfLoadRequest when it started without an HRTF that still needs to be
+     * loaded, and the loader hands back the selected HRTF and its name.
+     * HrtfLoadId changes with each renderer update, so a load started for an
+     * older update is ignored.
+     */
+    ALuint HrtfLoadId{0u};
+    bool HrtfLoadRequest{false};
+    Hrtf *HrtfLoaded{nullptr};
+    std::string HrtfLoadedName;
+
     std::atomic<ALCenum> LastError{ALC_NO_ERROR};
 
     // Maximum number of sources that can be created
@@ -740,12 +758,23 @@ struct ALCdevice_struct {
     std::chrono::nanoseconds ClockBase{0};
     std::chrono::nanoseconds FixedLatency{0};
 
-    /* Temp storage used for mixer processing. */
-    alignas(16) ALfloat TempBuffer[4][BUFFERSIZE];
+    /* Temp storage used for output post-processing. */
+    alignas(16) ALfloat TempBuffer[BUFFERSIZE];
+
+    /* Temp storage used by the mixer thread for mixing voices. */
+    std::unique_ptr<MixerScratch> MixScratch;
 
     /* Mixing buffer used by the Dry mix, FOAOut, and Real out. */
     al::vector<std::array<ALfloat,BUFFERSIZE>, 16> MixBuffer;
 
+    /* Optional helper threads for mixing voices concurrently, and the mixing
+     * state for each helper (the mixer thread itself uses the above buffers).
+     */
+    std::unique_ptr<MixerPool> MixThreads;
+    al::vector<std::unique_ptr<MixThreadState>> MixThreadStates;
+    /* Process effect slots across the mixer pool too. */
+    bool ThreadedEffects{false};
+
     /* The "dry" path corresponds to the main output. */
     MixParams Dry;
     ALsizei NumChannelsPerOrder[MAX_AMBI_ORDER+1]{};
@@ -761,6 +790,14 @@ struct ALCdevice_struct {
     /* HRTF state and info */
     std::unique_ptr<DirectHrtfState> mHrtfState;
     Hrtf *HrtfHandle{nullptr};
+    /* Voices move their HRTF coefficients and delays to new ones, instead of
+     * crossfading between the old and new.
+     */
+    bool HrtfInterp{false};
+    /* Shared convolutions for voice channels with matching HRTF filters, if
+     * enabled.
+     */
+    std::unique_ptr<HrtfBusState> mHrtfBuses;
 
     /* UHJ encoder state */
     std::unique_ptr<Uhj2Encoder> Uhj_Encoder;
@@ -835,6 +872,8 @@ struct ALCdevice_struct {
 
 #define RECORD_THREAD_NAME "alsoft-record"
 
+#define HRTF_LOADER_THREAD_NAME "alsoft-hrtf"
+
 
 enum {
     /* End event thread processing. */
@@ -847,6 +886,7 @@ enum {
     EventType_Performance       = 1<<3,
     EventType_Deprecated        = 1<<4,
     EventType_Disconnected      = 1<<5,
+    EventType_HrtfChanged       = 1<<6,
 
     /* Internal events. */
     EventType_ReleaseEffectState = 65536,
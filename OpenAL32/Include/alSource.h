@@ -47,6 +47,8 @@ typedef struct ALsource {
     enum Resampler Resampler;
     ALboolean DirectChannels;
     enum SpatializeMode Spatialize;
+    /* Higher priority sources are the last to be culled by the mixer. */
+    ALint Priority;
 
     ALboolean DryGainHFAuto;
     ALboolean WetGainAuto;
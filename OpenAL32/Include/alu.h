@@ -113,6 +113,19 @@ typedef struct MixHrtfParams {
     ALfloat GainStep;
 } MixHrtfParams;
 
+/* Parameters for mixing with the HRTF coefficients and delays moving toward a
+ * target. The coefficients are stepped in place every HRTF_INTERP_STEP
+ * samples.
+ */
+typedef struct MixHrtfInterpParams {
+    ALfloat (*Coeffs)[2];
+    const ALfloat (*CoeffStep)[2];
+    ALfloat Delay[2];
+    ALfloat DelayStep[2];
+    ALfloat Gain;
+    ALfloat GainStep;
+} MixHrtfInterpParams;
+
 
 typedef struct DirectParams {
     BiquadFilter LowPass;
@@ -124,6 +137,12 @@ typedef struct DirectParams {
         HrtfParams Old;
         HrtfParams Target;
         HrtfState State;
+        /* The device HRTF bus this channel is mixed with, or -1 if it's
+         * convolved on its own. Checked is set once it's been compared with
+         * the other unmatched channels, until its filter changes.
+         */
+        ALsizei Bus{-1};
+        bool Checked{false};
     } Hrtf;
 
     struct {
@@ -163,6 +182,7 @@ struct ALvoicePropsBase {
     enum Resampler Resampler;
     ALboolean DirectChannels;
     enum SpatializeMode SpatializeMode;
+    ALint Priority;
 
     ALboolean DryGainHFAuto;
     ALboolean WetGainAuto;
@@ -205,12 +225,35 @@ struct ALvoiceProps : public ALvoicePropsBase {
 #define VOICE_IS_FADING (1<<1) /* Fading sources use gain stepping for smooth transitions. */
 #define VOICE_HAS_HRTF  (1<<2)
 #define VOICE_HAS_NFC   (1<<3)
+#define VOICE_IS_VIRTUAL (1<<4) /* Virtual voices advance without mixing. */
+#define VOICE_IS_CULLED  (1<<5) /* Culled by the voice scheduler for this update. */
+
+/* The small bits of a voice's state that the mixer looks at every update to
+ * decide whether, and how, to mix it. These are kept packed together in the
+ * context's VoiceStates array, separate from the voices' much larger filter
+ * and HRTF state, so scanning and ranking many voices stays cache-friendly.
+ */
+struct ALvoiceState {
+    std::atomic<ALuint> SourceID{0u};
+    std::atomic<bool> Playing{false};
+
+    /** Current target parameters used for mixing. */
+    ALint Step{0};
+
+    ALuint Flags{0u};
+
+    /* The source's priority, and estimated loudness of the voice, used to
+     * rank it for mixing.
+     */
+    ALint Priority{0};
+    ALfloat Audibility{0.0f};
+};
 
 struct ALvoice {
     std::atomic<ALvoiceProps*> Update{nullptr};
 
-    std::atomic<ALuint> SourceID{0u};
-    std::atomic<bool> Playing{false};
+    /* This voice's entry in the context's VoiceStates array. */
+    ALvoiceState *State{nullptr};
 
     ALvoicePropsBase Props;
 
@@ -237,13 +280,8 @@ struct ALvoice {
     ALsizei NumChannels;
     ALsizei SampleSize;
 
-    /** Current target parameters used for mixing. */
-    ALint Step;
-
     ResamplerFunc Resampler;
 
-    ALuint Flags;
-
     ALuint Offset; /* Number of output samples mixed since starting. */
 
     alignas(16) std::array<std::array<ALfloat,MAX_RESAMPLE_PADDING>,MAX_INPUT_CHANNELS> PrevSamples;
@@ -259,16 +297,86 @@ struct ALvoice {
         ALsizei ChannelsPerOrder[MAX_AMBI_ORDER+1];
     } Direct;
 
+    /* Per-channel tail convolution state, when the device's HRTF has HRIRs
+     * longer than HRIR_LENGTH.
+     */
+    al::vector<HrtfTailState,16> HrtfTail;
+
     struct SendData {
         int FilterType;
         SendParams Params[MAX_INPUT_CHANNELS];
 
+        /* The effect slot being sent to, and its wet buffer. */
+        struct ALeffectslot *Slot;
         ALfloat (*Buffer)[BUFFERSIZE];
         ALsizei Channels;
     } Send[];
 };
 
 void DeinitVoice(ALvoice *voice) noexcept;
+void InitVoiceHrtfTail(ALvoice *voice, const ALCdevice *device);
+
+
+/* Temporary storage MixSource uses for a voice's samples as they're loaded,
+ * resampled, and filtered. Each thread that mixes voices needs its own.
+ */
+struct MixerScratch {
+    /* The source samples need room for the resampler padding and enough input
+     * to resample at the maximum pitch, regardless of the output size. Each
+     * input channel is deinterleaved into its own line.
+     */
+    alignas(16) ALfloat SourceData[MAX_INPUT_CHANNELS][BUFFERSIZE];
+
+    /* The output-rate samples only need to hold one update's worth, and alias
+     * into storage sized for the device's update size. Each input channel has
+     * its own resampled and filtered samples, so all of a voice's channels can
+     * be mixed to an output together.
+     */
+    std::array<ALfloat*,MAX_INPUT_CHANNELS> ResampledData{};
+    std::array<ALfloat*,MAX_INPUT_CHANNELS> FilteredData{};
+    ALfloat *FilterTemp{nullptr};
+    ALfloat *NfcData{nullptr};
+    ALsizei OutputSize{0};
+
+    al::vector<ALfloat,16> OutputStorage;
+
+    /* Sizes the output-rate buffers for the given update size, which may be 0
+     * if unknown (using BUFFERSIZE).
+     */
+    void resize(ALuint update_size);
+
+    DEF_NEWDEL(MixerScratch)
+};
+
+/* Mixing state for a helper thread of the device's mixer pool. Voices mixed on
+ * a helper thread write into private copies of the device's mixing buffers
+ * and the effect slots' wet buffers, which are summed back into the real ones
+ * once all voices are mixed.
+ */
+struct MixThreadState {
+    MixerScratch Scratch;
+
+    al::vector<std::array<ALfloat,BUFFERSIZE>, 16> MixBuffer;
+    al::vector<std::array<ALfloat,BUFFERSIZE>, 16> WetBuffer;
+
+    /* Voice events raised on this thread, sent after mixing is done. */
+    struct VoiceEvent {
+        ALuint SourceID;
+        ALsizei BuffersDone;
+        bool Stopped;
+    };
+    al::vector<VoiceEvent> Events;
+
+    /* Set when anything was mixed into the private buffers. */
+    bool Mixed{false};
+
+    /* The range of private mixing buffer channels effects were processed
+     * into, when effects are threaded.
+     */
+    ALsizei EffectChans[2]{0, 0};
+
+    DEF_NEWDEL(MixThreadState)
+};
 
 
 typedef void (*MixerFunc)(const ALfloat *data, ALsizei OutChans,
@@ -278,6 +386,12 @@ typedef void (*MixerFunc)(const ALfloat *data, ALsizei OutChans,
 typedef void (*RowMixerFunc)(ALfloat *OutBuffer, const ALfloat *gains,
                              const ALfloat (*RESTRICT data)[BUFFERSIZE], ALsizei InChans,
                              ALsizei InPos, ALsizei BufferSize);
+typedef void (*MultiMixerFunc)(const ALfloat *const *data, ALsizei InChans, ALsizei OutChans,
+                               ALfloat (*RESTRICT OutBuffer)[BUFFERSIZE],
+                               ALfloat *const *CurrentGains, const ALfloat *const *TargetGains,
+                               ALsizei Counter, ALsizei OutPos, ALsizei BufferSize);
+typedef void (*SampleLoaderFunc)(ALfloat (*RESTRICT dst)[BUFFERSIZE], ALsizei dstpos,
+                                 const ALvoid *src, ALsizei numchans, ALsizei samples);
 typedef void (*HrtfMixerFunc)(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                               const ALfloat *data, ALsizei Offset, ALsizei OutPos,
                               const ALsizei IrSize, MixHrtfParams *hrtfparams,
@@ -287,11 +401,36 @@ typedef void (*HrtfMixerBlendFunc)(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT
                                    const ALsizei IrSize, const HrtfParams *oldparams,
                                    MixHrtfParams *newparams, HrtfState *hrtfstate,
                                    ALsizei BufferSize);
+typedef void (*HrtfMixerInterpFunc)(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
+                                    const ALfloat *data, ALsizei Offset, ALsizei OutPos,
+                                    const ALsizei IrSize, MixHrtfInterpParams *hrtfparams,
+                                    HrtfState *hrtfstate, ALsizei BufferSize);
 typedef void (*HrtfDirectMixerFunc)(ALfloat *RESTRICT LeftOut, ALfloat *RESTRICT RightOut,
                                     const ALfloat *data, ALsizei Offset, const ALsizei IrSize,
                                     const ALfloat (*RESTRICT Coeffs)[2],
                                     ALfloat (*RESTRICT Values)[2], ALsizei BufferSize);
 
+/* A set of output gains to compute from a row of ambisonic coefficients. */
+typedef struct PanGainTarget {
+    const ALfloat *Coeffs;
+    ALfloat InGain;
+    ALfloat (*Gains)[MAX_OUTPUT_CHANNELS];
+} PanGainTarget;
+
+typedef void (*AmbiCoeffsRowFunc)(const ALfloat *RESTRICT y, const ALfloat *RESTRICT z,
+                                  const ALfloat *RESTRICT x, const ALfloat (*RESTRICT norms)[4],
+                                  ALfloat (*RESTRICT coeffs)[MAX_AMBI_COEFFS], ALsizei count);
+typedef void (*PanGainsMCFunc)(const ChannelConfig *chancoeffs, ALsizei numchans,
+                               ALsizei numcoeffs, const PanGainTarget *targets, ALsizei count);
+
+typedef void (*PhaseVocAnalysisFunc)(const ALfloat (*RESTRICT bins)[2],
+                                     ALfloat *RESTRICT lastphase, ALfloat *RESTRICT mags,
+                                     ALfloat *RESTRICT freqs, ALfloat phasestep, ALsizei count);
+typedef void (*PhaseVocSynthesisFunc)(const ALfloat *RESTRICT mags,
+                                      const ALfloat *RESTRICT freqs, ALfloat *RESTRICT sumphase,
+                                      ALfloat (*RESTRICT bins)[2], ALfloat phasestep,
+                                      ALsizei count);
+
 
 #define GAIN_MIX_MAX  (1000.0f) /* +60dB */
 
@@ -392,10 +531,28 @@ ResamplerFunc SelectResampler(enum Resampler resampler);
  */
 void aluInitRenderer(ALCdevice *device, ALint hrtf_id, enum HrtfRequestMode hrtf_appreq, enum HrtfRequestMode hrtf_userreq);
 
+/* LoadDeviceHrtf
+ *
+ * Loads the HRTF from the list to use with the given output rate, preferring
+ * the one at hrtf_id. If none match the rate, one is resampled (unless
+ * disabled). Returns a new reference to it and sets its name, or returns null
+ * if none can be used.
+ */
+struct Hrtf *LoadDeviceHrtf(const al::vector<EnumeratedHrtf> &list, ALint hrtf_id,
+                            ALuint frequency, std::string *name);
+
 void aluInitEffectPanning(struct ALeffectslot *slot);
 
 void aluSelectPostProcess(ALCdevice *device);
 
+/**
+ * CalcAmbiSpreadNorms
+ *
+ * Calculates the per-order scales (zeroth through third) that widen a set of
+ * ambisonic coefficients to the given spread (0...tau).
+ */
+void CalcAmbiSpreadNorms(const ALfloat spread, ALfloat (&norms)[4]);
+
 /**
  * Calculates ambisonic encoder coefficients using the X, Y, and Z direction
  * components, which must represent a normalized (unit length) vector, and the
@@ -478,7 +635,22 @@ inline void ComputePanGains(const MixParams *dry, const ALfloat*RESTRICT coeffs,
 }
 
 
-ALboolean MixSource(struct ALvoice *voice, ALuint SourceID, ALCcontext *Context, ALsizei SamplesToDo);
+/* Mixes the voice using the given scratch storage, returning false if it
+ * stopped playing. BuffersDone is set to the number of buffers that completed.
+ */
+ALboolean AdvanceVoice(struct ALvoice *voice, ALCcontext *Context, ALsizei *BuffersDone,
+                       ALsizei SamplesToDo);
+ALboolean MixSource(struct ALvoice *voice, ALCcontext *Context, MixerScratch *Scratch,
+                    ALsizei *BuffersDone, ALsizei SamplesToDo);
+
+/* Moves the context's voice channels on and off the device's shared HRTF
+ * buses, before its voices are mixed.
+ */
+void UpdateHrtfBuses(ALCcontext *Context);
+/* Convolves the device's shared HRTF buses to the output, after all contexts
+ * are mixed.
+ */
+void MixHrtfBuses(ALCdevice *device, ALsizei SamplesToDo);
 
 void aluMixData(ALCdevice *device, ALvoid *OutBuffer, ALsizei NumSamples);
 /* Caller must lock the device, and the mixer must not be running. */
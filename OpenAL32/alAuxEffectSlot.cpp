@@ -32,6 +32,7 @@
 #include "alMain.h"
 #include "alcontext.h"
 #include "alAuxEffectSlot.h"
+#include "alBuffer.h"
 #include "alError.h"
 #include "alListener.h"
 #include "alSource.h"
@@ -63,6 +64,19 @@ inline ALeffect *LookupEffect(ALCdevice *device, ALuint id) noexcept
     return sublist.Effects + slidx;
 }
 
+inline ALbuffer *LookupBuffer(ALCdevice *device, ALuint id) noexcept
+{
+    ALuint lidx = (id-1) >> 6;
+    ALsizei slidx = (id-1) & 0x3f;
+
+    if(UNLIKELY(lidx >= device->BufferList.size()))
+        return nullptr;
+    BufferSubList &sublist = device->BufferList[lidx];
+    if(UNLIKELY(sublist.FreeMask & (U64(1)<<slidx)))
+        return nullptr;
+    return sublist.Buffers + slidx;
+}
+
 
 void AddActiveEffectSlots(const ALuint *slotids, ALsizei count, ALCcontext *context)
 {
@@ -159,7 +173,8 @@ constexpr struct FactoryItem {
     { AL_EFFECT_RING_MODULATOR, ModulatorStateFactory_getFactory },
     { AL_EFFECT_PITCH_SHIFTER, PshifterStateFactory_getFactory},
     { AL_EFFECT_DEDICATED_DIALOGUE, DedicatedStateFactory_getFactory },
-    { AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT, DedicatedStateFactory_getFactory }
+    { AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT, DedicatedStateFactory_getFactory },
+    { AL_EFFECT_CONVOLUTION_REVERB_SOFT, ConvolutionStateFactory_getFactory }
 };
 
 inline EffectStateFactory *getFactoryByType(ALenum type)
@@ -171,6 +186,61 @@ inline EffectStateFactory *getFactoryByType(ALenum type)
     return (iter != std::end(FactoryList)) ? iter->GetFactory() : nullptr;
 }
 
+/* Creates and prepares a new effect state of the given type for the context's
+ * device, giving it the buffer if there is one. The buffer must be held by a
+ * reference so its data can't change.
+ */
+ALenum CreateEffectState(ALCcontext *Context, ALenum type, const ALbuffer *buffer,
+                         EffectState **state)
+{
+    EffectStateFactory *factory{getFactoryByType(type)};
+    if(!factory)
+    {
+        ERR("Failed to find factory for effect type 0x%04x\n", type);
+        return AL_INVALID_ENUM;
+    }
+    EffectState *State{factory->create()};
+    if(!State) return AL_OUT_OF_MEMORY;
+
+    FPUCtl mixer_mode{};
+    ALCdevice *Device{Context->Device};
+    /* The buffer can take a while to prepare, so don't hold up the mixer for
+     * it.
+     */
+    if(buffer && State->setBuffer(Device, buffer) == AL_FALSE)
+    {
+        mixer_mode.leave();
+        State->DecRef();
+        return AL_OUT_OF_MEMORY;
+    }
+
+    std::unique_lock<std::mutex> backlock{Device->BackendLock};
+    State->mOutBuffer = Device->Dry.Buffer;
+    State->mOutChannels = Device->Dry.NumChannels;
+    if(State->deviceUpdate(Device) == AL_FALSE)
+    {
+        backlock.unlock();
+        mixer_mode.leave();
+        State->DecRef();
+        return AL_OUT_OF_MEMORY;
+    }
+    *state = State;
+    return AL_NO_ERROR;
+}
+
+/* Removes state references from old effect slot property updates. */
+void RemoveStaleStates(ALCcontext *Context)
+{
+    ALeffectslotProps *props{Context->FreeEffectslotProps.load()};
+    while(props)
+    {
+        if(props->State)
+            props->State->DecRef();
+        props->State = nullptr;
+        props = props->next.load(std::memory_order_relaxed);
+    }
+}
+
 
 #define DO_UPDATEPROPS() do {                                                 \
     if(!context->DeferUpdates.load(std::memory_order_acquire))                \
@@ -321,6 +391,45 @@ AL_API ALvoid AL_APIENTRY alAuxiliaryEffectSloti(ALuint effectslot, ALenum param
         slot->AuxSendAuto = value;
         break;
 
+    case AL_BUFFER:
+        device = context->Device;
+
+        { std::unique_lock<std::mutex> buflock{device->BufferLock};
+            ALbuffer *buffer{value ? LookupBuffer(device, value) : nullptr};
+            if(!(value == 0 || buffer != nullptr))
+                SETERR_RETURN(context.get(), AL_INVALID_VALUE,, "Invalid buffer ID %u", value);
+            if(buffer == slot->Buffer)
+                return;
+            /* Buffers can't be changed or deleted while referenced, so the
+             * lock isn't needed after this.
+             */
+            if(buffer) IncrementRef(&buffer->ref);
+            buflock.unlock();
+
+            /* Only effects that use the buffer need a new state for it, so the
+             * mixer never sees one that's being changed. Others get it when
+             * the slot's effect changes.
+             */
+            if(slot->Effect.Type == AL_EFFECT_CONVOLUTION_REVERB_SOFT)
+            {
+                EffectState *State{};
+                err = CreateEffectState(context.get(), slot->Effect.Type, buffer, &State);
+                if(err != AL_NO_ERROR)
+                {
+                    if(buffer) DecrementRef(&buffer->ref);
+                    alSetError(context.get(), err, "Effect slot buffer setup failed");
+                    return;
+                }
+                slot->Effect.State->DecRef();
+                slot->Effect.State = State;
+                RemoveStaleStates(context.get());
+            }
+
+            if(slot->Buffer) DecrementRef(&slot->Buffer->ref);
+            slot->Buffer = buffer;
+        }
+        break;
+
     default:
         SETERR_RETURN(context.get(), AL_INVALID_ENUM,,
                       "Invalid effect slot integer property 0x%04x", param);
@@ -334,6 +443,7 @@ AL_API ALvoid AL_APIENTRY alAuxiliaryEffectSlotiv(ALuint effectslot, ALenum para
     {
     case AL_EFFECTSLOT_EFFECT:
     case AL_EFFECTSLOT_AUXILIARY_SEND_AUTO:
+    case AL_BUFFER:
         alAuxiliaryEffectSloti(effectslot, param, values[0]);
         return;
     }
@@ -421,6 +531,10 @@ AL_API ALvoid AL_APIENTRY alGetAuxiliaryEffectSloti(ALuint effectslot, ALenum pa
         *value = slot->AuxSendAuto;
         break;
 
+    case AL_BUFFER:
+        *value = slot->Buffer ? slot->Buffer->id : 0;
+        break;
+
     default:
         SETERR_RETURN(context.get(), AL_INVALID_ENUM,,
                       "Invalid effect slot integer property 0x%04x", param);
@@ -433,6 +547,7 @@ AL_API ALvoid AL_APIENTRY alGetAuxiliaryEffectSlotiv(ALuint effectslot, ALenum p
     {
     case AL_EFFECTSLOT_EFFECT:
     case AL_EFFECTSLOT_AUXILIARY_SEND_AUTO:
+    case AL_BUFFER:
         alGetAuxiliaryEffectSloti(effectslot, param, values);
         return;
     }
@@ -506,28 +621,9 @@ ALenum InitializeEffect(ALCcontext *Context, ALeffectslot *EffectSlot, ALeffect
     ALenum newtype{effect ? effect->type : AL_EFFECT_NULL};
     if(newtype != EffectSlot->Effect.Type)
     {
-        EffectStateFactory *factory{getFactoryByType(newtype)};
-        if(!factory)
-        {
-            ERR("Failed to find factory for effect type 0x%04x\n", newtype);
-            return AL_INVALID_ENUM;
-        }
-        EffectState *State{factory->create()};
-        if(!State) return AL_OUT_OF_MEMORY;
-
-        FPUCtl mixer_mode{};
-        ALCdevice *Device{Context->Device};
-        std::unique_lock<std::mutex> backlock{Device->BackendLock};
-        State->mOutBuffer = Device->Dry.Buffer;
-        State->mOutChannels = Device->Dry.NumChannels;
-        if(State->deviceUpdate(Device) == AL_FALSE)
-        {
-            backlock.unlock();
-            mixer_mode.leave();
-            State->DecRef();
-            return AL_OUT_OF_MEMORY;
-        }
-        mixer_mode.leave();
+        EffectState *State{};
+        ALenum err{CreateEffectState(Context, newtype, EffectSlot->Buffer, &State)};
+        if(err != AL_NO_ERROR) return err;
 
         if(!effect)
         {
@@ -546,15 +642,7 @@ ALenum InitializeEffect(ALCcontext *Context, ALeffectslot *EffectSlot, ALeffect
     else if(effect)
         EffectSlot->Effect.Props = effect->Props;
 
-    /* Remove state references from old effect slot property updates. */
-    ALeffectslotProps *props{Context->FreeEffectslotProps.load()};
-    while(props)
-    {
-        if(props->State)
-            props->State->DecRef();
-        props->State = nullptr;
-        props = props->next.load(std::memory_order_relaxed);
-    }
+    RemoveStaleStates(Context);
 
     return AL_NO_ERROR;
 }
@@ -596,6 +684,8 @@ ALeffectslot::~ALeffectslot()
         al_free(props);
     }
 
+    if(Buffer)
+        DecrementRef(&Buffer->ref);
     if(Effect.State)
         Effect.State->DecRef();
     if(Params.mEffectState)
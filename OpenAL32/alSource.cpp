@@ -56,7 +56,7 @@ inline ALvoice *GetSourceVoice(ALsource *source, ALCcontext *context)
     {
         ALuint sid{source->id};
         ALvoice *voice{context->Voices[idx]};
-        if(voice->SourceID.load(std::memory_order_acquire) == sid)
+        if(voice->State->SourceID.load(std::memory_order_acquire) == sid)
             return voice;
     }
     source->VoiceIdx = -1;
@@ -99,6 +99,7 @@ void UpdateSourceProps(ALsource *source, ALvoice *voice, ALCcontext *context)
     props->Resampler = source->Resampler;
     props->DirectChannels = source->DirectChannels;
     props->SpatializeMode = source->Spatialize;
+    props->Priority = source->Priority;
 
     props->DryGainHFAuto = source->DryGainHFAuto;
     props->WetGainAuto = source->WetGainAuto;
@@ -524,8 +525,8 @@ void FreeSource(ALCcontext *context, ALsource *source)
     ALvoice *voice{GetSourceVoice(source, context)};
     if(voice)
     {
-        voice->SourceID.store(0u, std::memory_order_relaxed);
-        voice->Playing.store(false, std::memory_order_release);
+        voice->State->SourceID.store(0u, std::memory_order_relaxed);
+        voice->State->Playing.store(false, std::memory_order_release);
     }
     ALCdevice_Unlock(device);
 
@@ -647,6 +648,9 @@ enum SourceProp : ALenum {
     /* AL_SOFT_source_spatialize */
     srcSpatialize = AL_SOURCE_SPATIALIZE_SOFT,
 
+    /* AL_SOFT_source_priority */
+    srcPriority = AL_SOURCE_PRIORITY_SOFT,
+
     /* ALC_SOFT_device_clock */
     srcSampleOffsetClockSOFT = AL_SAMPLE_OFFSET_CLOCK_SOFT,
     srcSecOffsetClockSOFT = AL_SEC_OFFSET_CLOCK_SOFT,
@@ -735,6 +739,7 @@ ALint FloatValsByProp(ALenum prop)
         case AL_SOURCE_RADIUS:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             return 1;
 
         case AL_STEREO_ANGLES:
@@ -797,6 +802,7 @@ ALint DoubleValsByProp(ALenum prop)
         case AL_SOURCE_RADIUS:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             return 1;
 
         case AL_SEC_OFFSET_LATENCY_SOFT:
@@ -860,6 +866,7 @@ ALint IntValsByProp(ALenum prop)
         case AL_SOURCE_RADIUS:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             return 1;
 
         case AL_POSITION:
@@ -919,6 +926,7 @@ ALint Int64ValsByProp(ALenum prop)
         case AL_SOURCE_RADIUS:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             return 1;
 
         case AL_SAMPLE_OFFSET_LATENCY_SOFT:
@@ -1172,6 +1180,7 @@ ALboolean SetSourcefv(ALsource *Source, ALCcontext *Context, SourceProp prop, co
         case AL_DIRECT_CHANNELS_SOFT:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             ival = (ALint)values[0];
             return SetSourceiv(Source, Context, prop, &ival);
 
@@ -1409,6 +1418,11 @@ ALboolean SetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, co
             DO_UPDATEPROPS();
             return AL_TRUE;
 
+        case AL_SOURCE_PRIORITY_SOFT:
+            Source->Priority = *values;
+            DO_UPDATEPROPS();
+            return AL_TRUE;
+
 
         case AL_AUXILIARY_SEND_FILTER:
             slotlock = std::unique_lock<std::mutex>{Context->EffectSlotLock};
@@ -1550,6 +1564,7 @@ ALboolean SetSourcei64v(ALsource *Source, ALCcontext *Context, SourceProp prop,
         case AL_DISTANCE_MODEL:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             CHECKVAL(*values <= INT_MAX && *values >= INT_MIN);
 
             ivals[0] = (ALint)*values;
@@ -1779,6 +1794,7 @@ ALboolean GetSourcedv(ALsource *Source, ALCcontext *Context, SourceProp prop, AL
         case AL_DISTANCE_MODEL:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             if((err=GetSourceiv(Source, Context, prop, ivals)) != AL_FALSE)
                 *values = (ALdouble)ivals[0];
             return err;
@@ -1896,6 +1912,10 @@ ALboolean GetSourceiv(ALsource *Source, ALCcontext *Context, SourceProp prop, AL
             *values = Source->Spatialize;
             return AL_TRUE;
 
+        case AL_SOURCE_PRIORITY_SOFT:
+            *values = Source->Priority;
+            return AL_TRUE;
+
         /* 1x float/double */
         case AL_CONE_INNER_ANGLE:
         case AL_CONE_OUTER_ANGLE:
@@ -2062,6 +2082,7 @@ ALboolean GetSourcei64v(ALsource *Source, ALCcontext *Context, SourceProp prop,
         case AL_DISTANCE_MODEL:
         case AL_SOURCE_RESAMPLER_SOFT:
         case AL_SOURCE_SPATIALIZE_SOFT:
+        case AL_SOURCE_PRIORITY_SOFT:
             if((err=GetSourceiv(Source, Context, prop, ivals)) != AL_FALSE)
                 *values = ivals[0];
             return err;
@@ -2767,7 +2788,7 @@ AL_API ALvoid AL_APIENTRY alSourcePlayv(ALsizei n, const ALuint *sources)
         case AL_PAUSED:
             assert(voice != nullptr);
             /* A source that's paused simply resumes. */
-            voice->Playing.store(true, std::memory_order_release);
+            voice->State->Playing.store(true, std::memory_order_release);
             source->state = AL_PLAYING;
             SendStateChangeEvent(context.get(), source->id, AL_PLAYING);
             return;
@@ -2778,15 +2799,16 @@ AL_API ALvoid AL_APIENTRY alSourcePlayv(ALsizei n, const ALuint *sources)
         }
 
         /* Look for an unused voice to play this source with. */
-        auto voices_end = context->Voices + context->VoiceCount.load(std::memory_order_relaxed);
-        auto voice_iter = std::find_if(context->Voices, voices_end,
-            [](const ALvoice *voice) noexcept -> bool
-            { return voice->SourceID.load(std::memory_order_relaxed) == 0u; }
+        auto states_end = context->VoiceStates +
+            context->VoiceCount.load(std::memory_order_relaxed);
+        auto state_iter = std::find_if(context->VoiceStates, states_end,
+            [](const ALvoiceState &state) noexcept -> bool
+            { return state.SourceID.load(std::memory_order_relaxed) == 0u; }
         );
-        auto vidx = static_cast<ALint>(std::distance(context->Voices, voice_iter));
-        voice = *voice_iter;
-        voice->Playing.store(false, std::memory_order_release);
-        if(voice_iter == voices_end) context->VoiceCount.fetch_add(1, std::memory_order_acq_rel);
+        auto vidx = static_cast<ALint>(std::distance(context->VoiceStates, state_iter));
+        voice = context->Voices[vidx];
+        voice->State->Playing.store(false, std::memory_order_release);
+        if(state_iter == states_end) context->VoiceCount.fetch_add(1, std::memory_order_acq_rel);
 
         source->PropsClean.test_and_set(std::memory_order_acquire);
         UpdateSourceProps(source, voice, context.get());
@@ -2825,12 +2847,13 @@ AL_API ALvoid AL_APIENTRY alSourcePlayv(ALsizei n, const ALuint *sources)
         /* Clear the stepping value so the mixer knows not to mix this until
          * the update gets applied.
          */
-        voice->Step = 0;
+        voice->State->Step = 0;
 
-        voice->Flags = start_fading ? VOICE_IS_FADING : 0;
-        if(source->SourceType == AL_STATIC) voice->Flags |= VOICE_IS_STATIC;
+        voice->State->Flags = start_fading ? VOICE_IS_FADING : 0;
+        if(source->SourceType == AL_STATIC) voice->State->Flags |= VOICE_IS_STATIC;
 
         std::fill_n(std::begin(voice->Direct.Params), voice->NumChannels, DirectParams{});
+        InitVoiceHrtfTail(voice, device);
         std::for_each(voice->Send+0, voice->Send+source->Send.size(),
             [voice](ALvoice::SendData &send) -> void
             { std::fill_n(std::begin(send.Params), voice->NumChannels, SendParams{}); }
@@ -2846,8 +2869,8 @@ AL_API ALvoid AL_APIENTRY alSourcePlayv(ALsizei n, const ALuint *sources)
             );
         }
 
-        voice->SourceID.store(source->id, std::memory_order_relaxed);
-        voice->Playing.store(true, std::memory_order_release);
+        voice->State->SourceID.store(source->id, std::memory_order_relaxed);
+        voice->State->Playing.store(true, std::memory_order_release);
         source->state = AL_PLAYING;
         source->VoiceIdx = vidx;
 
@@ -2883,7 +2906,7 @@ AL_API ALvoid AL_APIENTRY alSourcePausev(ALsizei n, const ALuint *sources)
     {
         ALsource *source{LookupSource(context.get(), sources[i])};
         ALvoice *voice{GetSourceVoice(source, context.get())};
-        if(voice) voice->Playing.store(false, std::memory_order_release);
+        if(voice) voice->State->Playing.store(false, std::memory_order_release);
         if(GetSourceState(source, voice) == AL_PLAYING)
         {
             source->state = AL_PAUSED;
@@ -2921,8 +2944,8 @@ AL_API ALvoid AL_APIENTRY alSourceStopv(ALsizei n, const ALuint *sources)
         ALvoice *voice{GetSourceVoice(source, context.get())};
         if(voice != nullptr)
         {
-            voice->SourceID.store(0u, std::memory_order_relaxed);
-            voice->Playing.store(false, std::memory_order_release);
+            voice->State->SourceID.store(0u, std::memory_order_relaxed);
+            voice->State->Playing.store(false, std::memory_order_release);
             voice = nullptr;
         }
         ALenum oldstate{GetSourceState(source, voice)};
@@ -2965,8 +2988,8 @@ AL_API ALvoid AL_APIENTRY alSourceRewindv(ALsizei n, const ALuint *sources)
         ALvoice *voice{GetSourceVoice(source, context.get())};
         if(voice != nullptr)
         {
-            voice->SourceID.store(0u, std::memory_order_relaxed);
-            voice->Playing.store(false, std::memory_order_release);
+            voice->State->SourceID.store(0u, std::memory_order_relaxed);
+            voice->State->Playing.store(false, std::memory_order_release);
             voice = nullptr;
         }
         if(GetSourceState(source, voice) != AL_INITIAL)
@@ -3334,6 +3357,7 @@ ALsource::ALsource(ALsizei num_sends)
     Resampler = ResamplerDefault;
     DirectChannels = AL_FALSE;
     Spatialize = SpatializeAuto;
+    Priority = 0;
 
     StereoPan[0] = DEG2RAD( 30.0f);
     StereoPan[1] = DEG2RAD(-30.0f);
@@ -3398,7 +3422,7 @@ void UpdateAllSourceProps(ALCcontext *context)
     std::for_each(context->Voices, voices_end,
         [context](ALvoice *voice) -> void
         {
-            ALuint sid{voice->SourceID.load(std::memory_order_acquire)};
+            ALuint sid{voice->State->SourceID.load(std::memory_order_acquire)};
             ALsource *source = sid ? LookupSource(context, sid) : nullptr;
             if(source && !source->PropsClean.test_and_set(std::memory_order_acq_rel))
                 UpdateSourceProps(source, voice, context);
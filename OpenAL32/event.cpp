@@ -127,6 +127,8 @@ AL_API void AL_APIENTRY alEventControlSOFT(ALsizei count, const ALenum *types, A
                 flags |= EventType_Deprecated;
             else if(type == AL_EVENT_TYPE_DISCONNECTED_SOFT)
                 flags |= EventType_Disconnected;
+            else if(type == AL_EVENT_TYPE_HRTF_CHANGED_SOFT)
+                flags |= EventType_HrtfChanged;
             else
                 return false;
             return true;
@@ -4,26 +4,81 @@
 #include "alcomplex.h"
 
 #include <cmath>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FFT_USE_SSE
+#endif
 
 namespace {
 
 constexpr double Pi{3.141592653589793238462643383279502884};
 
+using complex_f = std::complex<float>;
+
+/* The complex multiplies are written out, as std::complex's operator* has to
+ * check for infinities and NaNs, which is much slower.
+ */
+template<bool Conj>
+inline complex_f cmul(const complex_f &a, const complex_f &w) noexcept
+{
+    if(Conj)
+        return complex_f{a.real()*w.real() + a.imag()*w.imag(),
+                         a.imag()*w.real() - a.real()*w.imag()};
+    return complex_f{a.real()*w.real() - a.imag()*w.imag(),
+                     a.imag()*w.real() + a.real()*w.imag()};
+}
+
+/* Multiplies by -i for forward transforms, or i for inverse transforms. */
+template<bool Inverse>
+inline complex_f rotate(const complex_f &a) noexcept
+{
+    if(Inverse)
+        return complex_f{-a.imag(), a.real()};
+    return complex_f{a.imag(), -a.real()};
+}
+
+#ifdef FFT_USE_SSE
+
+/* Complex multiply of two interleaved complex pairs. Conj multiplies by the
+ * twiddles' conjugates.
+ */
+template<bool Conj>
+inline __m128 cmul4(const __m128 a, const __m128 w) noexcept
+{
+    const __m128 sign{Conj ? _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f) :
+                             _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f)};
+    const __m128 wre{_mm_shuffle_ps(w, w, _MM_SHUFFLE(2,2,0,0))};
+    const __m128 wim{_mm_shuffle_ps(w, w, _MM_SHUFFLE(3,3,1,1))};
+    const __m128 aswap{_mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1))};
+    return _mm_add_ps(_mm_mul_ps(a, wre), _mm_xor_ps(_mm_mul_ps(aswap, wim), sign));
+}
+
+template<bool Inverse>
+inline __m128 rotate4(const __m128 a) noexcept
+{
+    const __m128 sign{Inverse ? _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f) :
+                                _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)};
+    return _mm_xor_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1)), sign);
+}
+
+#endif
+
 } // namespace
 
 void complex_fft(std::complex<double> *FFTBuffer, int FFTSize, double Sign)
 {
-    /* Bit-reversal permutation applied to a sequence of FFTSize items */
-    for(int i{1};i < FFTSize-1;i++)
+    /* Bit-reversal permutation applied to a sequence of FFTSize items. The
+     * reversed index is incremented along with i by carrying from the top bit
+     * down.
+     */
+    for(int i{1}, j{0};i < FFTSize-1;i++)
     {
-        int j{0};
-        for(int mask{1};mask < FFTSize;mask <<= 1)
-        {
-            if((i&mask) != 0)
-                j++;
-            j <<= 1;
-        }
-        j >>= 1;
+        int bit{FFTSize >> 1};
+        for(;(j&bit) != 0;bit >>= 1)
+            j ^= bit;
+        j ^= bit;
 
         if(i < j)
             std::swap(FFTBuffer[i], FFTBuffer[j]);
@@ -36,18 +91,25 @@ void complex_fft(std::complex<double> *FFTBuffer, int FFTSize, double Sign)
         int step2{step >> 1};
         double arg{Pi / step2};
 
+        /* The complex multiplies are written out, as std::complex's
+         * operator* has to check for infinities and NaNs, which is much
+         * slower.
+         */
         std::complex<double> w{std::cos(arg), std::sin(arg)*Sign};
         std::complex<double> u{1.0, 0.0};
         for(int j{0};j < step2;j++)
         {
             for(int k{j};k < FFTSize;k+=step)
             {
-                std::complex<double> temp{FFTBuffer[k+step2] * u};
+                const std::complex<double> val{FFTBuffer[k+step2]};
+                const std::complex<double> temp{val.real()*u.real() - val.imag()*u.imag(),
+                                                val.real()*u.imag() + val.imag()*u.real()};
                 FFTBuffer[k+step2] = FFTBuffer[k] - temp;
                 FFTBuffer[k] += temp;
             }
 
-            u *= w;
+            u = std::complex<double>{u.real()*w.real() - u.imag()*w.imag(),
+                                     u.real()*w.imag() + u.imag()*w.real()};
         }
     }
 }
@@ -74,3 +136,211 @@ void complex_hilbert(std::complex<double> *Buffer, int size)
 
     complex_fft(Buffer, size, -1.0);
 }
+
+
+FftPlan::FftPlan(int size) : mSize{size}
+{
+    while((1<<mLog2Size) < size)
+        ++mLog2Size;
+
+    /* Bit-reversal permutation applied to a sequence of size items, stored as
+     * the swaps it takes. The reversed index is incremented along with i by
+     * carrying from the top bit down.
+     */
+    for(int i{1}, j{0};i < size-1;i++)
+    {
+        int bit{size >> 1};
+        for(;(j&bit) != 0;bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if(i < j)
+            mSwaps.push_back(BitSwap{i, j});
+    }
+
+    /* A lone radix-2 pass starts off odd sizes, and the first pass of other
+     * sizes has no twiddles, so only the later stages need them.
+     */
+    int half{(mLog2Size&1) ? 2 : 1};
+    if(half == 1) half <<= 2;
+    for(;half < size;half <<= 2)
+    {
+        for(int j{0};j < half;j++)
+        {
+            const double arg{-Pi * j / half};
+            mTwiddles.emplace_back(static_cast<float>(std::cos(arg)),
+                                   static_cast<float>(std::sin(arg)));
+        }
+        for(int j{0};j < half;j++)
+        {
+            const double arg{-Pi * j / (half*2)};
+            mTwiddles.emplace_back(static_cast<float>(std::cos(arg)),
+                                   static_cast<float>(std::sin(arg)));
+        }
+    }
+}
+
+template<bool Inverse>
+void FftPlan::transform(complex_f *buffer) const noexcept
+{
+    for(const BitSwap &swap : mSwaps)
+        std::swap(buffer[swap.a], buffer[swap.b]);
+
+    int half{1};
+    if((mLog2Size&1))
+    {
+        for(int k{0};k < mSize;k += 2)
+        {
+            const complex_f a0{buffer[k]}, a1{buffer[k+1]};
+            buffer[k]   = a0 + a1;
+            buffer[k+1] = a0 - a1;
+        }
+        half = 2;
+    }
+    else if(mSize >= 4)
+    {
+        /* The first stage's twiddles are all 1. */
+        for(int k{0};k < mSize;k += 4)
+        {
+            const complex_f b0{buffer[k]   + buffer[k+1]}, b1{buffer[k]   - buffer[k+1]};
+            const complex_f b2{buffer[k+2] + buffer[k+3]}, b3{rotate<Inverse>(buffer[k+2] - buffer[k+3])};
+            buffer[k]   = b0 + b2;
+            buffer[k+1] = b1 + b3;
+            buffer[k+2] = b0 - b2;
+            buffer[k+3] = b1 - b3;
+        }
+        half = 4;
+    }
+
+    /* Each stage does two radix-2 passes at once, combining four sequences
+     * of half items into one. The first pass uses the twiddles w1 for
+     * combining sequences of half items, and the second uses w2 for
+     * combining the resulting pairs. Half is always even here.
+     */
+    const complex_f *twiddles{mTwiddles.data()};
+    for(;half < mSize;half <<= 2)
+    {
+        const complex_f *RESTRICT w1{twiddles};
+        const complex_f *RESTRICT w2{twiddles + half};
+        for(int k{0};k < mSize;k += half*4)
+        {
+            complex_f *RESTRICT x0{buffer + k};
+            complex_f *RESTRICT x1{x0 + half};
+            complex_f *RESTRICT x2{x1 + half};
+            complex_f *RESTRICT x3{x2 + half};
+#ifdef FFT_USE_SSE
+            for(int j{0};j < half;j += 2)
+            {
+                float *f0{reinterpret_cast<float*>(x0 + j)};
+                float *f1{reinterpret_cast<float*>(x1 + j)};
+                float *f2{reinterpret_cast<float*>(x2 + j)};
+                float *f3{reinterpret_cast<float*>(x3 + j)};
+                const __m128 tw1{_mm_load_ps(reinterpret_cast<const float*>(w1 + j))};
+                const __m128 tw2{_mm_load_ps(reinterpret_cast<const float*>(w2 + j))};
+
+                const __m128 a0{_mm_loadu_ps(f0)};
+                const __m128 t1{cmul4<Inverse>(_mm_loadu_ps(f1), tw1)};
+                const __m128 a2{_mm_loadu_ps(f2)};
+                const __m128 t3{cmul4<Inverse>(_mm_loadu_ps(f3), tw1)};
+
+                const __m128 b0{_mm_add_ps(a0, t1)}, b1{_mm_sub_ps(a0, t1)};
+                const __m128 b2{cmul4<Inverse>(_mm_add_ps(a2, t3), tw2)};
+                const __m128 b3{rotate4<Inverse>(cmul4<Inverse>(_mm_sub_ps(a2, t3), tw2))};
+
+                _mm_storeu_ps(f0, _mm_add_ps(b0, b2));
+                _mm_storeu_ps(f1, _mm_add_ps(b1, b3));
+                _mm_storeu_ps(f2, _mm_sub_ps(b0, b2));
+                _mm_storeu_ps(f3, _mm_sub_ps(b1, b3));
+            }
+#else
+            for(int j{0};j < half;j++)
+            {
+                const complex_f a0{x0[j]}, t1{cmul<Inverse>(x1[j], w1[j])};
+                const complex_f a2{x2[j]}, t3{cmul<Inverse>(x3[j], w1[j])};
+
+                const complex_f b0{a0 + t1}, b1{a0 - t1};
+                const complex_f b2{cmul<Inverse>(a2 + t3, w2[j])};
+                const complex_f b3{rotate<Inverse>(cmul<Inverse>(a2 - t3, w2[j]))};
+
+                x0[j] = b0 + b2;
+                x1[j] = b1 + b3;
+                x2[j] = b0 - b2;
+                x3[j] = b1 - b3;
+            }
+#endif
+        }
+        twiddles += half*2;
+    }
+}
+
+void FftPlan::forward(std::complex<float> *buffer) const noexcept
+{ transform<false>(buffer); }
+
+void FftPlan::inverse(std::complex<float> *buffer) const noexcept
+{ transform<true>(buffer); }
+
+
+RealFftPlan::RealFftPlan(int size) : mSize{size}, mHalf{size/2}
+{
+    /* The size/2 point transform of the even and odd samples packed together
+     * gives the even and odd halves of the spectrum, which get recombined
+     * with these twiddles.
+     */
+    for(int k{0};k <= size/4;k++)
+    {
+        const double arg{-2.0*Pi * k / size};
+        mTwiddles.emplace_back(static_cast<float>(std::cos(arg)),
+                               static_cast<float>(std::sin(arg)));
+    }
+}
+
+void RealFftPlan::forward(const float *input, std::complex<float> *output) const noexcept
+{
+    const int half{mSize / 2};
+
+    std::copy_n(input, mSize, reinterpret_cast<float*>(output));
+    mHalf.forward(output);
+
+    /* Separate the even (E) and odd (O) sample spectra from each bin and its
+     * mirror, and combine them as E[k] + W^k*O[k]. The mirrored bin is the
+     * conjugate of E[k] - W^k*O[k].
+     */
+    const complex_f z0{output[0]};
+    output[0] = complex_f{z0.real() + z0.imag(), 0.0f};
+    output[half] = complex_f{z0.real() - z0.imag(), 0.0f};
+    for(int k{1};k < half-k;k++)
+    {
+        const complex_f zk{output[k]}, zm{std::conj(output[half-k])};
+        const complex_f even{(zk + zm) * 0.5f};
+        const complex_f odd{rotate<false>((zk - zm) * 0.5f)};
+        const complex_f wodd{cmul<false>(odd, mTwiddles[k])};
+        output[k] = even + wodd;
+        output[half-k] = std::conj(even - wodd);
+    }
+    if(half >= 2)
+        output[half/2] = std::conj(output[half/2]);
+}
+
+void RealFftPlan::inverse(const std::complex<float> *input, float *output) const noexcept
+{
+    const int half{mSize / 2};
+    complex_f *RESTRICT packed{reinterpret_cast<complex_f*>(output)};
+
+    /* Rebuild the packed spectrum from the even and odd halves. This is
+     * scaled by 2, to get an overall scale of size rather than half.
+     */
+    const float x0{input[0].real()}, xm{input[half].real()};
+    packed[0] = complex_f{x0 + xm, x0 - xm};
+    for(int k{1};k < half-k;k++)
+    {
+        const complex_f xk{input[k]}, xmk{std::conj(input[half-k])};
+        const complex_f even{xk + xmk};
+        const complex_f odd{cmul<true>(xk - xmk, mTwiddles[k])};
+        packed[k] = even + rotate<true>(odd);
+        packed[half-k] = std::conj(even) + complex_f{odd.imag(), odd.real()};
+    }
+    if(half >= 2)
+        packed[half/2] = std::conj(input[half/2]) * 2.0f;
+
+    mHalf.inverse(packed);
+}
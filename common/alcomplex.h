@@ -2,6 +2,9 @@
 #define ALCOMPLEX_H
 
 #include <complex>
+#include <vector>
+
+#include "almalloc.h"
 
 /**
  * Iterative implementation of 2-radix FFT (In-place algorithm). Sign = -1 is
@@ -21,4 +24,68 @@ void complex_fft(std::complex<double> *FFTBuffer, int FFTSize, double Sign);
  */
 void complex_hilbert(std::complex<double> *Buffer, int size);
 
+
+/**
+ * Single-precision complex FFT of a fixed power-of-two size. The bit-reversal
+ * swaps and twiddle factors are computed once when the plan is made, so
+ * transforms only do the butterflies, two radix-2 stages at a time. A plan
+ * holds no state between transforms and may be shared between threads.
+ *
+ * Transforms are in-place. As with complex_fft, forward() uses the negative
+ * exponent and neither direction is normalized, so an inverse after a forward
+ * transform scales the signal by size().
+ */
+class FftPlan {
+    using complex_f = std::complex<float>;
+
+    struct BitSwap { int a, b; };
+
+    int mSize{0};
+    int mLog2Size{0};
+    std::vector<BitSwap> mSwaps;
+    /* For each stage after the first, the twiddles of its two radix-2
+     * passes, one set after the other.
+     */
+    std::vector<complex_f,al::allocator<complex_f,16>> mTwiddles;
+
+    template<bool Inverse>
+    void transform(complex_f *buffer) const noexcept;
+
+public:
+    explicit FftPlan(int size);
+
+    int size() const noexcept { return mSize; }
+
+    void forward(std::complex<float> *buffer) const noexcept;
+    void inverse(std::complex<float> *buffer) const noexcept;
+};
+
+/**
+ * Single-precision FFT of real signals, of a fixed power-of-two size (at least
+ * 2). It packs the signal into a complex one of half the size, so it costs
+ * about half of a complex transform of the same size.
+ *
+ * forward() takes size() samples and gives the size()/2+1 non-negative
+ * frequency bins, which are all a real signal's spectrum needs. inverse()
+ * takes those bins and gives back size() samples, scaled by size() like
+ * FftPlan::inverse(), assuming the imaginary parts of the DC and Nyquist bins
+ * are 0. The input and output must not overlap.
+ */
+class RealFftPlan {
+    using complex_f = std::complex<float>;
+
+    int mSize{0};
+    FftPlan mHalf;
+    /* The twiddles for the first quarter of the spectrum. */
+    std::vector<complex_f,al::allocator<complex_f,16>> mTwiddles;
+
+public:
+    explicit RealFftPlan(int size);
+
+    int size() const noexcept { return mSize; }
+
+    void forward(const float *input, std::complex<float> *output) const noexcept;
+    void inverse(const std::complex<float> *input, float *output) const noexcept;
+};
+
 #endif /* ALCOMPLEX_H */
@@ -0,0 +1,575 @@
+/*
+ * OpenAL Mixer Benchmark
+ *
+ * Copyright (c) 2018 by authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This utility measures how fast the library mixes sources. It renders from
+ * a loopback device as fast as possible, with no real-time pacing, and
+ * reports the time taken per source per sample frame. The mixer-threads and
+ * other config options can be set through ALSOFT_CONF as usual.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "AL/alc.h"
+#include "AL/al.h"
+#include "AL/alext.h"
+#include "AL/efx.h"
+
+#ifndef ALC_SOFT_loopback2
+#define ALC_SOFT_loopback2 1
+#define ALC_AMBISONIC_LAYOUT_SOFT                0xfff0
+#define ALC_AMBISONIC_SCALING_SOFT               0xfff1
+#define ALC_AMBISONIC_ORDER_SOFT                 0xfff2
+#define ALC_BFORMAT3D_SOFT                       0x1508
+#define ALC_ACN_SOFT                             0xfff4
+#define ALC_SN3D_SOFT                            0xfff6
+#endif
+
+#ifndef M_PI
+#define M_PI    (3.14159265358979323846)
+#endif
+
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+static double GetWallTime(void)
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    if(!freq.QuadPart)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+}
+
+static double GetCPUTime(void)
+{
+    FILETIME creation, exit, kernel, user;
+    ULARGE_INTEGER k, u;
+    if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0.0;
+    k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime; u.HighPart = user.dwHighDateTime;
+    return (double)(k.QuadPart + u.QuadPart) / 10000000.0;
+}
+
+#else
+
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+static double GetWallTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec/1000000000.0;
+}
+
+static double GetCPUTime(void)
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0.0;
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)/1000000.0;
+}
+#endif
+
+
+static LPALCLOOPBACKOPENDEVICESOFT alcLoopbackOpenDeviceSOFT;
+static LPALCRENDERSAMPLESSOFT alcRenderSamplesSOFT;
+static LPALGETSTRINGISOFT alGetStringiSOFT;
+
+static LPALGENEFFECTS alGenEffects;
+static LPALDELETEEFFECTS alDeleteEffects;
+static LPALEFFECTI alEffecti;
+static LPALGENAUXILIARYEFFECTSLOTS alGenAuxiliaryEffectSlots;
+static LPALDELETEAUXILIARYEFFECTSLOTS alDeleteAuxiliaryEffectSlots;
+static LPALAUXILIARYEFFECTSLOTI alAuxiliaryEffectSloti;
+
+
+enum OutputMode {
+    ModeStereo,
+    ModeHrtf,
+    ModeSurround,
+    ModeAmbisonic
+};
+
+static const struct {
+    const char name[12];
+    ALenum format;
+} SourceFormats[] = {
+    { "mono8",    AL_FORMAT_MONO8 },
+    { "mono16",   AL_FORMAT_MONO16 },
+    { "monof",    AL_FORMAT_MONO_FLOAT32 },
+    { "stereo16", AL_FORMAT_STEREO16 },
+    { "stereof",  AL_FORMAT_STEREO_FLOAT32 },
+};
+
+static const char *ModeName(enum OutputMode mode)
+{
+    switch(mode)
+    {
+    case ModeStereo: return "stereo";
+    case ModeHrtf: return "hrtf";
+    case ModeSurround: return "5.1";
+    case ModeAmbisonic: return "ambisonic";
+    }
+    return "unknown";
+}
+
+
+/* Creates a one-second looping noise buffer, which keeps the mixer from
+ * seeing silence or trivially predictable input.
+ */
+static ALuint CreateBuffer(ALenum format, ALsizei srate)
+{
+    ALsizei channels = (format == AL_FORMAT_STEREO16 || format == AL_FORMAT_STEREO_FLOAT32) ? 2 : 1;
+    ALsizei count = srate * channels;
+    unsigned int seed = 22222;
+    ALuint buffer = 0;
+    ALsizei size = 0;
+    void *data;
+    ALsizei i;
+
+    if(format == AL_FORMAT_MONO8)
+        size = count;
+    else if(format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16)
+        size = count * 2;
+    else
+        size = count * 4;
+
+    data = malloc(size);
+    for(i = 0;i < count;i++)
+    {
+        float val;
+        seed = seed*96314165u + 907633515u;
+        val = ((float)(seed>>8) / 16777216.0f - 0.5f) * 0.5f;
+
+        if(format == AL_FORMAT_MONO8)
+            ((unsigned char*)data)[i] = (unsigned char)(val*255.0f + 128.0f);
+        else if(format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16)
+            ((short*)data)[i] = (short)(val*32767.0f);
+        else
+            ((float*)data)[i] = val;
+    }
+
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, format, data, size, srate);
+    free(data);
+
+    if(alGetError() != AL_NO_ERROR)
+    {
+        if(alIsBuffer(buffer))
+            alDeleteBuffers(1, &buffer);
+        return 0;
+    }
+    return buffer;
+}
+
+/* Finds the resampler index using the same names as the resampler config
+ * option, which are listed in the library's resampler order.
+ */
+static ALint FindResampler(const char *name)
+{
+    static const char ResamplerNames[][8] = {
+        "point", "linear", "cubic", "bsinc12", "bsinc24"
+    };
+    ALint num_resamplers, i;
+
+    if(!alIsExtensionPresent("AL_SOFT_source_resampler"))
+        return -1;
+    alGetStringiSOFT = alGetProcAddress("alGetStringiSOFT");
+
+    num_resamplers = alGetInteger(AL_NUM_RESAMPLERS_SOFT);
+    if(num_resamplers > (ALint)(sizeof(ResamplerNames)/sizeof(ResamplerNames[0])))
+        num_resamplers = (ALint)(sizeof(ResamplerNames)/sizeof(ResamplerNames[0]));
+    for(i = 0;i < num_resamplers;i++)
+    {
+        if(strcmp(ResamplerNames[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+static void PrintUsage(const char *argv0)
+{
+    fprintf(stderr,
+"Usage: %s [options]\n"
+"\n"
+"Options:\n"
+"  --sources <num>      Number of playing sources (default 64)\n"
+"  --format <name>      Source buffer format: mono8, mono16, monof, stereo16, or\n"
+"                       stereof (default mono16)\n"
+"  --resampler <name>   Source resampler: point, linear, cubic, bsinc12, or\n"
+"                       bsinc24 (default is the library's default)\n"
+"  --mode <name>        Output mode: stereo, hrtf, 5.1, or ambisonic (default\n"
+"                       stereo)\n"
+"  --order <num>        Ambisonic order for ambisonic output (default 1)\n"
+"  --slots <num>        Number of reverb effect slots the sources send to\n"
+"                       (default 0)\n"
+"  --frequency <hz>     Output sample rate (default 48000)\n"
+"  --update <frames>    Sample frames rendered per call (default 1024)\n"
+"  --seconds <time>     Amount of audio to render, in seconds (default 10)\n"
+"  --json               Print the results as JSON\n",
+        argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int numsources = 64;
+    const char *fmtname = "mono16";
+    const char *resname = NULL;
+    enum OutputMode mode = ModeStereo;
+    int order = 1;
+    int numslots = 0;
+    int frequency = 48000;
+    int updatesize = 1024;
+    double seconds = 10.0;
+    int json = 0;
+
+    ALCint attrs[16];
+    ALCint *attr = attrs;
+    ALCdevice *device;
+    ALCcontext *context;
+    ALCint numsends = 0;
+    ALCint numchans;
+    ALenum format = AL_NONE;
+    ALint resampler = -1;
+    ALuint buffer;
+    ALuint *sources;
+    ALuint effect = 0;
+    ALuint slots[4] = { 0, 0, 0, 0 };
+    float *output;
+    long long total_frames, frames;
+    double wall_start, cpu_start, wall_time, cpu_time;
+    double ns_per_voice_sample, cpu_ns_per_voice_sample;
+    double realtime, voices_per_core;
+    size_t i;
+    int a;
+
+    for(a = 1;a < argc;a++)
+    {
+        const char *opt = argv[a];
+        const char *val = (a+1 < argc) ? argv[a+1] : NULL;
+
+        if(strcmp(opt, "--json") == 0)
+        {
+            json = 1;
+            continue;
+        }
+        if(strcmp(opt, "--help") == 0 || strcmp(opt, "-h") == 0)
+        {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+        if(!val)
+        {
+            fprintf(stderr, "Missing value for %s\n", opt);
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        a++;
+
+        if(strcmp(opt, "--sources") == 0)
+            numsources = atoi(val);
+        else if(strcmp(opt, "--format") == 0)
+            fmtname = val;
+        else if(strcmp(opt, "--resampler") == 0)
+            resname = val;
+        else if(strcmp(opt, "--mode") == 0)
+        {
+            if(strcmp(val, "stereo") == 0) mode = ModeStereo;
+            else if(strcmp(val, "hrtf") == 0) mode = ModeHrtf;
+            else if(strcmp(val, "5.1") == 0) mode = ModeSurround;
+            else if(strcmp(val, "ambisonic") == 0) mode = ModeAmbisonic;
+            else
+            {
+                fprintf(stderr, "Unknown output mode: %s\n", val);
+                return 1;
+            }
+        }
+        else if(strcmp(opt, "--order") == 0)
+            order = atoi(val);
+        else if(strcmp(opt, "--slots") == 0)
+            numslots = atoi(val);
+        else if(strcmp(opt, "--frequency") == 0)
+            frequency = atoi(val);
+        else if(strcmp(opt, "--update") == 0)
+            updatesize = atoi(val);
+        else if(strcmp(opt, "--seconds") == 0)
+            seconds = atof(val);
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", opt);
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    for(i = 0;i < sizeof(SourceFormats)/sizeof(SourceFormats[0]);i++)
+    {
+        if(strcmp(SourceFormats[i].name, fmtname) == 0)
+            format = SourceFormats[i].format;
+    }
+    if(format == AL_NONE)
+    {
+        fprintf(stderr, "Unknown source format: %s\n", fmtname);
+        return 1;
+    }
+    if(numsources < 1 || numslots < 0 || numslots > 4 || frequency < 8000 ||
+       updatesize < 1 || !(seconds > 0.0) || order < 1 || order > 3)
+    {
+        fprintf(stderr, "Invalid option value\n");
+        return 1;
+    }
+
+    if(!alcIsExtensionPresent(NULL, "ALC_SOFT_loopback"))
+    {
+        fprintf(stderr, "Error: ALC_SOFT_loopback not supported!\n");
+        return 1;
+    }
+    alcLoopbackOpenDeviceSOFT = alcGetProcAddress(NULL, "alcLoopbackOpenDeviceSOFT");
+    alcRenderSamplesSOFT = alcGetProcAddress(NULL, "alcRenderSamplesSOFT");
+
+    device = alcLoopbackOpenDeviceSOFT(NULL);
+    if(!device)
+    {
+        fprintf(stderr, "Failed to open loopback device!\n");
+        return 1;
+    }
+
+    *(attr++) = ALC_FREQUENCY;
+    *(attr++) = frequency;
+    *(attr++) = ALC_FORMAT_TYPE_SOFT;
+    *(attr++) = ALC_FLOAT_SOFT;
+    *(attr++) = ALC_FORMAT_CHANNELS_SOFT;
+    if(mode == ModeAmbisonic)
+    {
+        *(attr++) = ALC_BFORMAT3D_SOFT;
+        *(attr++) = ALC_AMBISONIC_LAYOUT_SOFT;
+        *(attr++) = ALC_ACN_SOFT;
+        *(attr++) = ALC_AMBISONIC_SCALING_SOFT;
+        *(attr++) = ALC_SN3D_SOFT;
+        *(attr++) = ALC_AMBISONIC_ORDER_SOFT;
+        *(attr++) = order;
+        numchans = (order+1) * (order+1);
+    }
+    else if(mode == ModeSurround)
+    {
+        *(attr++) = ALC_5POINT1_SOFT;
+        numchans = 6;
+    }
+    else
+    {
+        *(attr++) = ALC_STEREO_SOFT;
+        numchans = 2;
+    }
+    *(attr++) = ALC_HRTF_SOFT;
+    *(attr++) = (mode == ModeHrtf) ? ALC_TRUE : ALC_FALSE;
+    *(attr++) = ALC_MAX_AUXILIARY_SENDS;
+    *(attr++) = numslots;
+    *(attr++) = 0;
+
+    context = alcCreateContext(device, attrs);
+    if(!context || alcMakeContextCurrent(context) == ALC_FALSE)
+    {
+        fprintf(stderr, "Failed to set up context for %s output\n", ModeName(mode));
+        if(context)
+            alcDestroyContext(context);
+        alcCloseDevice(device);
+        return 1;
+    }
+    if(mode == ModeHrtf)
+    {
+        ALCint hrtf_state = ALC_FALSE;
+        alcGetIntegerv(device, ALC_HRTF_SOFT, 1, &hrtf_state);
+        if(!hrtf_state)
+            fprintf(stderr, "Warning: HRTF not enabled\n");
+    }
+
+    if(resname)
+    {
+        resampler = FindResampler(resname);
+        if(resampler < 0)
+            fprintf(stderr, "Warning: resampler \"%s\" not found, using the default\n",
+                    resname);
+    }
+
+    if(numslots > 0)
+    {
+        alcGetIntegerv(device, ALC_MAX_AUXILIARY_SENDS, 1, &numsends);
+        if(numsends < numslots)
+        {
+            fprintf(stderr, "Warning: only %d auxiliary sends available\n", numsends);
+            numslots = numsends;
+        }
+
+#define LOAD_PROC(x)  ((x) = alGetProcAddress(#x))
+        LOAD_PROC(alGenEffects);
+        LOAD_PROC(alDeleteEffects);
+        LOAD_PROC(alEffecti);
+        LOAD_PROC(alGenAuxiliaryEffectSlots);
+        LOAD_PROC(alDeleteAuxiliaryEffectSlots);
+        LOAD_PROC(alAuxiliaryEffectSloti);
+#undef LOAD_PROC
+
+        alGenEffects(1, &effect);
+        alEffecti(effect, AL_EFFECT_TYPE, AL_EFFECT_EAXREVERB);
+        if(alGetError() != AL_NO_ERROR)
+            alEffecti(effect, AL_EFFECT_TYPE, AL_EFFECT_REVERB);
+        alGenAuxiliaryEffectSlots(numslots, slots);
+        for(a = 0;a < numslots;a++)
+            alAuxiliaryEffectSloti(slots[a], AL_EFFECTSLOT_EFFECT, (ALint)effect);
+    }
+
+    /* Use a buffer rate that doesn't match the output, so sources need
+     * resampling even at unity pitch.
+     */
+    buffer = CreateBuffer(format, 44100);
+    if(!buffer)
+    {
+        fprintf(stderr, "Failed to create %s buffer\n", fmtname);
+        alcMakeContextCurrent(NULL);
+        alcDestroyContext(context);
+        alcCloseDevice(device);
+        return 1;
+    }
+
+    /* Spread the sources around the listener at varying distances and
+     * pitches, starting each at a different offset.
+     */
+    sources = calloc(numsources, sizeof(ALuint));
+    alGenSources(numsources, sources);
+    if(alGetError() != AL_NO_ERROR)
+    {
+        fprintf(stderr, "Failed to create %d sources\n", numsources);
+        free(sources);
+        alDeleteBuffers(1, &buffer);
+        alcMakeContextCurrent(NULL);
+        alcDestroyContext(context);
+        alcCloseDevice(device);
+        return 1;
+    }
+    for(a = 0;a < numsources;a++)
+    {
+        double angle = (double)a * 2.0 * M_PI * 0.618033988749895;
+        float dist = 1.0f + (float)(a%7);
+        ALint s;
+
+        alSourcei(sources[a], AL_BUFFER, (ALint)buffer);
+        alSourcei(sources[a], AL_LOOPING, AL_TRUE);
+        alSource3f(sources[a], AL_POSITION, (float)sin(angle)*dist, (float)((a%3)-1)*0.5f,
+                   -(float)cos(angle)*dist);
+        alSourcef(sources[a], AL_PITCH, 0.9f + (float)(a%11)*0.02f);
+        if(resampler >= 0)
+            alSourcei(sources[a], AL_SOURCE_RESAMPLER_SOFT, resampler);
+        for(s = 0;s < numslots;s++)
+            alSource3i(sources[a], AL_AUXILIARY_SEND_FILTER, (ALint)slots[s], s, AL_FILTER_NULL);
+        alSourcei(sources[a], AL_SAMPLE_OFFSET, (a*997) % 44100);
+    }
+    alSourcePlayv(numsources, sources);
+    if(alGetError() != AL_NO_ERROR)
+        fprintf(stderr, "Warning: failed to set up all sources\n");
+
+    output = calloc((size_t)updatesize * numchans, sizeof(float));
+
+    /* Warm up the caches and the mixer's state before timing. */
+    for(frames = 0;frames < frequency/2;frames += updatesize)
+        alcRenderSamplesSOFT(device, output, updatesize);
+
+    total_frames = (long long)(seconds * frequency);
+    wall_start = GetWallTime();
+    cpu_start = GetCPUTime();
+    for(frames = 0;frames < total_frames;frames += updatesize)
+        alcRenderSamplesSOFT(device, output, updatesize);
+    wall_time = GetWallTime() - wall_start;
+    cpu_time = GetCPUTime() - cpu_start;
+    total_frames = frames;
+
+    ns_per_voice_sample = wall_time * 1000000000.0 / ((double)total_frames * numsources);
+    cpu_ns_per_voice_sample = cpu_time * 1000000000.0 / ((double)total_frames * numsources);
+    realtime = ((double)total_frames / frequency) / wall_time;
+    /* How many sources one core could mix in real-time, going by the CPU time
+     * spent. Includes the fixed per-update costs spread across the sources.
+     */
+    voices_per_core = (cpu_ns_per_voice_sample > 0.0) ?
+        1000000000.0 / (cpu_ns_per_voice_sample * frequency) : 0.0;
+
+    if(json)
+    {
+        printf("{\n");
+        printf("  \"sources\": %d,\n", numsources);
+        printf("  \"format\": \"%s\",\n", fmtname);
+        printf("  \"resampler\": \"%s\",\n", (resampler >= 0) ?
+               alGetStringiSOFT(AL_RESAMPLER_NAME_SOFT, resampler) : "default");
+        printf("  \"mode\": \"%s\",\n", ModeName(mode));
+        printf("  \"ambisonic_order\": %d,\n", (mode == ModeAmbisonic) ? order : 0);
+        printf("  \"effect_slots\": %d,\n", numslots);
+        printf("  \"frequency\": %d,\n", frequency);
+        printf("  \"update_size\": %d,\n", updatesize);
+        printf("  \"frames\": %lld,\n", total_frames);
+        printf("  \"wall_seconds\": %.6f,\n", wall_time);
+        printf("  \"cpu_seconds\": %.6f,\n", cpu_time);
+        printf("  \"ns_per_voice_sample\": %.4f,\n", ns_per_voice_sample);
+        printf("  \"cpu_ns_per_voice_sample\": %.4f,\n", cpu_ns_per_voice_sample);
+        printf("  \"realtime_factor\": %.3f,\n", realtime);
+        printf("  \"voices_per_core\": %.1f\n", voices_per_core);
+        printf("}\n");
+    }
+    else
+    {
+        printf("Rendered %lld frames of %d %s sources to %s output", total_frames, numsources,
+               fmtname, ModeName(mode));
+        if(numslots > 0) printf(" with %d effect slot%s", numslots, (numslots==1)?"":"s");
+        printf("\n");
+        printf("  Wall time:        %.3f s (%.1fx real-time)\n", wall_time, realtime);
+        printf("  CPU time:         %.3f s\n", cpu_time);
+        printf("  Per voice-sample: %.2f ns (%.2f ns CPU)\n", ns_per_voice_sample,
+               cpu_ns_per_voice_sample);
+        printf("  Voices per core:  %.1f\n", voices_per_core);
+    }
+
+    free(output);
+    alDeleteSources(numsources, sources);
+    free(sources);
+    alDeleteBuffers(1, &buffer);
+    if(numslots > 0)
+    {
+        alDeleteAuxiliaryEffectSlots(numslots, slots);
+        alDeleteEffects(1, &effect);
+    }
+
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    return 0;
+}
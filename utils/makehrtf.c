@@ -218,6 +218,11 @@ typedef unsigned __int64 uint64_t;
 // response protocol 02.
 #define MHR_FORMAT                   ("MinPHR02")
 
+// The OpenAL Soft native HRTF format marker, for data sets stored in the
+// host's byte order and float layout so they can be memory-mapped.
+#define MHR_NATIVE_FORMAT            ("MinPHRN0")
+#define MHR_NATIVE_BYTE_ORDER        (0x01020304u)
+
 // Sample and channel type enum values.
 typedef enum SampleTypeT {
     ST_S16 = 0,
@@ -266,6 +271,7 @@ typedef unsigned int uint;
 
 // Serialization types.  The trailing digit indicates the number of bits.
 typedef unsigned char uint8;
+typedef unsigned short uint16;
 typedef int           int32;
 typedef unsigned int  uint32;
 typedef uint64_t      uint64;
@@ -2014,6 +2020,157 @@ static int StoreMhr(const HrirDataT *hData, const char *filename)
     return 1;
 }
 
+// Write zero padding to align the file offset to the given size.
+static int WritePadding(const uint align, uint *offset, FILE *fp, const char *filename)
+{
+    static const uint8 zeros[16] = { 0 };
+    uint count = (align - (*offset % align)) % align;
+
+    if(fwrite(zeros, 1, count, fp) != count)
+    {
+        fprintf(stderr, "Error: Bad write to file '%s'.\n", filename);
+        return 0;
+    }
+    *offset += count;
+    return 1;
+}
+
+// Store the OpenAL Soft HRTF data set in the native format, holding the final
+// float coefficients and delays as the library uses them.
+static int StoreMhrNative(const HrirDataT *hData, const char *filename)
+{
+    const HrirFdT *field = &hData->mFds[0];
+    uint n = hData->mIrPoints;
+    uint32 header[6];
+    float distance;
+    uint16 evOffset;
+    uint offset;
+    FILE *fp;
+    uint ei, ai, ti, i;
+
+    if(hData->mFdCount != 1)
+    {
+        fprintf(stderr, "Error: The native format only supports one field.\n");
+        return 0;
+    }
+    // The library uses the coefficients as stored without checking them, so
+    // make sure they're usable here.
+    for(ei = 0;ei < field->mEvCount;ei++)
+    {
+        const HrirEvT *evd = &field->mEvs[ei];
+        for(ai = 0;ai < evd->mAzCount;ai++)
+        {
+            for(ti = 0;ti < ((hData->mChannelType == CT_STEREO) ? 2u : 1u);ti++)
+            {
+                for(i = 0;i < n;i++)
+                {
+                    if(!isfinite((float)evd->mAzs[ai].mIrs[ti][i]))
+                    {
+                        fprintf(stderr, "Error: Non-finite coefficient at elevation %u, azimuth %u.\n",
+                                ei, ai);
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    if((fp=fopen(filename, "wb")) == NULL)
+    {
+        fprintf(stderr, "Error: Could not open MHR file '%s'.\n", filename);
+        return 0;
+    }
+
+    distance = (float)field->mDistance;
+    header[0] = MHR_NATIVE_BYTE_ORDER;
+    header[1] = hData->mIrRate;
+    header[2] = n;
+    header[3] = field->mEvCount;
+    header[4] = field->mIrCount;
+    memcpy(&header[5], &distance, sizeof(distance));
+    if(!WriteAscii(MHR_NATIVE_FORMAT, fp, filename))
+        return 0;
+    if(fwrite(header, sizeof(header), 1, fp) != 1)
+        goto error;
+    offset = 8 + sizeof(header);
+
+    for(ei = 0;ei < field->mEvCount;ei++)
+    {
+        uint8 azCount = (uint8)field->mEvs[ei].mAzCount;
+        if(fwrite(&azCount, 1, 1, fp) != 1)
+            goto error;
+        offset++;
+    }
+    if(!WritePadding(2, &offset, fp, filename))
+        goto error_closed;
+    evOffset = 0;
+    for(ei = 0;ei < field->mEvCount;ei++)
+    {
+        if(fwrite(&evOffset, sizeof(evOffset), 1, fp) != 1)
+            goto error;
+        evOffset += (uint16)field->mEvs[ei].mAzCount;
+        offset += sizeof(evOffset);
+    }
+    if(!WritePadding(16, &offset, fp, filename))
+        goto error_closed;
+
+    // Mono data sets use the mirrored left ear response for the right ear.
+    for(ei = 0;ei < field->mEvCount;ei++)
+    {
+        const HrirEvT *evd = &field->mEvs[ei];
+        for(ai = 0;ai < evd->mAzCount;ai++)
+        {
+            const HrirAzT *azd[2];
+            uint ch[2];
+
+            azd[0] = &evd->mAzs[ai];
+            ch[0] = 0;
+            if(hData->mChannelType == CT_STEREO)
+            {
+                azd[1] = azd[0];
+                ch[1] = 1;
+            }
+            else
+            {
+                azd[1] = &evd->mAzs[(evd->mAzCount-ai) % evd->mAzCount];
+                ch[1] = 0;
+            }
+            for(i = 0;i < n;i++)
+            {
+                float out[2];
+                for(ti = 0;ti < 2;ti++)
+                    out[ti] = (float)azd[ti]->mIrs[ch[ti]][i];
+                if(fwrite(out, sizeof(out), 1, fp) != 1)
+                    goto error;
+            }
+        }
+    }
+    for(ei = 0;ei < field->mEvCount;ei++)
+    {
+        const HrirEvT *evd = &field->mEvs[ei];
+        for(ai = 0;ai < evd->mAzCount;ai++)
+        {
+            const HrirAzT *azl = &evd->mAzs[ai];
+            const HrirAzT *azr = (hData->mChannelType == CT_STEREO) ? azl :
+                                 &evd->mAzs[(evd->mAzCount-ai) % evd->mAzCount];
+            uint8 out[2];
+
+            out[0] = (uint8)fmin(round(hData->mIrRate * azl->mDelays[0]), MAX_HRTD);
+            out[1] = (uint8)fmin(round(hData->mIrRate *
+                azr->mDelays[(hData->mChannelType == CT_STEREO) ? 1 : 0]), MAX_HRTD);
+            if(fwrite(out, sizeof(out), 1, fp) != 1)
+                goto error;
+        }
+    }
+    fclose(fp);
+    return 1;
+
+error:
+    fprintf(stderr, "Error: Bad write to file '%s'.\n", filename);
+error_closed:
+    fclose(fp);
+    return 0;
+}
+
 
 /***********************
  *** HRTF processing ***
@@ -3202,7 +3359,7 @@ error:
  * resulting data set as desired.  If the input name is NULL it will read
  * from standard input.
  */
-static int ProcessDefinition(const char *inName, const uint outRate, const uint fftSize, const int equalize, const int surface, const double limit, const uint truncSize, const HeadModelT model, const double radius, const char *outName)
+static int ProcessDefinition(const char *inName, const uint outRate, const uint fftSize, const int equalize, const int surface, const double limit, const uint truncSize, const HeadModelT model, const double radius, const int native, const char *outName)
 {
     char rateStr[8+1], expName[MAX_PATH_LEN];
     TokenReaderT tr;
@@ -3274,7 +3431,10 @@ static int ProcessDefinition(const char *inName, const uint outRate, const uint
     snprintf(rateStr, 8, "%u", hData.mIrRate);
     StrSubst(outName, "%r", rateStr, MAX_PATH_LEN, expName);
     fprintf(stdout, "Creating MHR data set %s...\n", expName);
-    ret = StoreMhr(&hData, expName);
+    if(native)
+        ret = StoreMhrNative(&hData, expName);
+    else
+        ret = StoreMhr(&hData, expName);
 
     FreeHrirData(&hData);
     return ret;
@@ -3297,6 +3457,8 @@ static void PrintHelp(const char *argv0, FILE *ofile)
     fprintf(ofile, " -d {dataset|    Specify the model used for calculating the head-delay timing\n");
     fprintf(ofile, "     sphere}     values (default: %s).\n", ((DEFAULT_HEAD_MODEL == HM_DATASET) ? "dataset" : "sphere"));
     fprintf(ofile, " -c <size>       Use a customized head radius measured ear-to-ear in meters.\n");
+    fprintf(ofile, " -n              Store the data set in the native (memory-mappable) float\n");
+    fprintf(ofile, "                 format for this machine instead of %s.\n", MHR_FORMAT);
     fprintf(ofile, " -i <filename>   Specify an HRIR definition file to use (defaults to stdin).\n");
     fprintf(ofile, " -o <filename>   Specify an output file. Use of '%%r' will be substituted with\n");
     fprintf(ofile, "                 the data set sample rate.\n");
@@ -3313,6 +3475,7 @@ int main(int argc, char *argv[])
     uint truncSize;
     double radius;
     double limit;
+    int native;
     int opt;
 
     GET_UNICODE_ARGS(&argc, &argv);
@@ -3333,8 +3496,9 @@ int main(int argc, char *argv[])
     truncSize = DEFAULT_TRUNCSIZE;
     model = DEFAULT_HEAD_MODEL;
     radius = DEFAULT_CUSTOM_RADIUS;
+    native = 0;
 
-    while((opt=getopt(argc, argv, "mr:f:e:s:l:w:d:c:e:i:o:h")) != -1)
+    while((opt=getopt(argc, argv, "mr:f:e:s:l:w:d:c:e:ni:o:h")) != -1)
     {
         switch(opt)
         {
@@ -3428,6 +3592,10 @@ int main(int argc, char *argv[])
             }
             break;
 
+        case 'n':
+            native = 1;
+            break;
+
         case 'i':
             inName = optarg;
             break;
@@ -3447,7 +3615,7 @@ int main(int argc, char *argv[])
     }
 
     if(!ProcessDefinition(inName, outRate, fftSize, equalize, surface, limit,
-                          truncSize, model, radius, outName))
+                          truncSize, model, radius, native, outName))
         return -1;
     fprintf(stdout, "Operation completed.\n");
 